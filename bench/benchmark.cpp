@@ -0,0 +1,1227 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "benchmark.h"
+#include "expression.h"
+#include "actionmodel.h"
+#include "simulation.h"
+#include "utils.h"
+#include "loopback.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// minimum time in ms to run a function, to reduce timer and scheduling errors
+static const qint64 s_minimumTime = 500;
+
+// maximum number of calls between 2 timer checks
+static const qint64 s_maximumBatch = 65536;
+
+// prevent compiler from removing measured code
+static volatile qint64 s_sink = 0;
+
+// minimum and maximum delay between clicks in loopback benchmark, in ms
+static const int s_loopbackDelayMin = 10;
+static const int s_loopbackDelayMax = 20;
+
+// first display number tried for Xvfb, high enough to not be used by a real server
+static const int s_firstXvfbDisplay = 90;
+
+// text format is much slower, so only check smaller scripts
+static const int s_maximumTextActions = 10000;
+
+// fixtures are named version<n>.acf, from version 1 to this one
+static const quint32 s_lastFixtureVersion = 6;
+
+// same as in actionmodel.cpp, old files must be readable even if this code changes
+struct SMagicHeader
+{
+	union
+	{
+		char str[5];
+		quint32 num;
+	};
+};
+
+static SMagicHeader s_header = { "ACFK" };
+
+static SMagicHeader s_journalHeader = { "ACFJ" };
+
+// journals were introduced with this version
+static const quint32 s_firstJournalVersion = 6;
+
+static void setStreamVersion(QDataStream& stream)
+{
+#if (QT_VERSION < QT_VERSION_CHECK(5, 6, 0))
+	stream.setVersion(QDataStream::Qt_5_4);
+#else
+	stream.setVersion(QDataStream::Qt_5_6);
+#endif
+}
+
+// all types except None, which is never saved
+static const Action::Type s_compatibilityTypes[] =
+{
+	Action::Type::Click,
+	Action::Type::Repeat,
+	Action::Type::Move,
+	Action::Type::Drag,
+	Action::Type::WaitPixel,
+	Action::Type::FindImage,
+	Action::Type::KeyPress,
+	Action::Type::KeyRelease,
+	Action::Type::Text,
+	Action::Type::Scroll,
+	Action::Type::Jump,
+	Action::Type::Loop,
+	Action::Type::Call,
+	Action::Type::Return
+};
+
+// Send events to the real server but keep track of submit times and cursor position,
+// because no user can move the mouse on a virtual server.
+class LoopbackBackend : public SystemBackend
+{
+public:
+	LoopbackBackend()
+	{
+		m_clock.start();
+	}
+
+	qint64 getTime() override
+	{
+		return m_clock.nsecsElapsed() / 1000;
+	}
+
+	void sendInputEvents(const InputEvent* events, int count) override
+	{
+		qint64 time = getTime();
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (events[i].type == InputEvent::Type::ButtonDown) m_presses << time;
+			else if (events[i].type == InputEvent::Type::Move) m_cursor = events[i].pos;
+		}
+
+		SystemBackend::sendInputEvents(events, count);
+	}
+
+	QPoint getCursorPosition() override
+	{
+		return m_cursor;
+	}
+
+	bool waitForCursorMove(const QPoint& pos, qint64 deadline) override
+	{
+		sleep((int)qMax(Q_INT64_C(0), (deadline - getTime()) / 1000));
+
+		return m_cursor != pos;
+	}
+
+	const QElapsedTimer& getClock() const { return m_clock; }
+	const QVector<qint64>& getPresses() const { return m_presses; }
+
+private:
+	QElapsedTimer m_clock;
+	QPoint m_cursor;
+	QVector<qint64> m_presses;
+};
+
+// only fields used by its type are defined, like in editor, so they are all saved in text format
+static Action createCompatibilityAction(int i, const QImage& image)
+{
+	Action action;
+	action.type = s_compatibilityTypes[i % (sizeof(s_compatibilityTypes) / sizeof(s_compatibilityTypes[0]))];
+	action.name = QString::fromUtf8("Action %1 \"%2\" \xc3\xa9").arg(i).arg(typeToString(action.type));
+	action.originalPosition = QPoint(i % 1920, i % 1080);
+	action.lastPosition = action.originalPosition;
+	action.delayMin = 100 + i % 50;
+	action.delayMax = 200 + i % 100;
+	action.duration = i % 7;
+	action.originalCount = i % 5;
+	action.lastCount = action.originalCount;
+
+	if (i % 4 == 0) action.expression = "delay = random(10, 20); x = n % 3";
+
+	switch (action.type)
+	{
+	case Action::Type::Click:
+		action.button = i % 2 ? Action::Button::Right : Action::Button::Left;
+		break;
+
+	case Action::Type::Move:
+	case Action::Type::Drag:
+		action.path << QPoint(i % 100, 20) << QPoint(30, -40);
+		action.pathShape = i % 2 ? Action::PathShape::Bezier : Action::PathShape::Polyline;
+		action.speedProfile = Action::SpeedProfile::Constant;
+		action.sampleRate = 60;
+		action.moveDuration = 250 + i % 10;
+
+		if (action.type == Action::Type::Drag) action.button = Action::Button::Middle;
+		break;
+
+	case Action::Type::WaitPixel:
+		action.color = qRgb(i % 256, 128, 255 - i % 256);
+		action.regionSize = 3;
+		action.tolerance = 4;
+		action.timeout = 5000;
+		break;
+
+	case Action::Type::FindImage:
+		action.image = image;
+		action.searchSize = QSize(640, 480);
+		action.tolerance = 16;
+		action.timeout = 0;
+		action.button = Action::Button::Back;
+		break;
+
+	case Action::Type::KeyPress:
+	case Action::Type::KeyRelease:
+		action.text = "F5";
+		break;
+
+	case Action::Type::Text:
+		action.text = "Hello, world!";
+		action.keyDelayMin = 10;
+		action.keyDelayMax = 30;
+		break;
+
+	case Action::Type::Scroll:
+		action.scroll = QPoint(i % 3 - 1, 3 - i % 7);
+		break;
+
+	case Action::Type::Jump:
+	case Action::Type::Loop:
+	case Action::Type::Call:
+		action.text = QString("Action %1").arg(i / 2);
+		break;
+
+	default:
+		break;
+	}
+
+	return action;
+}
+
+// action as it was serialized in version of .acf format, see operator >> for Action
+static void writeLegacyAction(QDataStream& stream, const Action& action, quint32 version)
+{
+	stream << action.name << action.originalPosition;
+
+	if (version >= 5) stream << action.delayMin;
+
+	stream << action.delayMax;
+
+	if (version >= 2)
+	{
+		stream << action.duration;
+
+		if (version >= 4) stream << action.type << action.originalCount;
+	}
+
+	if (version >= 7) stream << action.path << (quint8)action.pathShape << (quint8)action.speedProfile << action.sampleRate << action.moveDuration;
+	if (version >= 8) stream << (quint32)action.color << action.tolerance << action.regionSize << action.timeout;
+	if (version >= 9) stream << action.image << action.searchSize;
+	if (version >= 10) stream << action.text << action.keyDelayMin << action.keyDelayMax;
+	if (version >= 11) stream << (quint8)action.button << action.scroll;
+	if (version >= 13) stream << action.expression;
+}
+
+// action read from a file with version of .acf format, fields which didn't exist have their default value
+static Action getLegacyAction(const Action& action, quint32 version)
+{
+	Action res = action;
+	Action defaults;
+
+	if (version < 2) res.duration = 0;
+
+	if (version < 4)
+	{
+		res.type = Action::Type::Click;
+		res.originalCount = 0;
+	}
+
+	if (version < 5) res.delayMin = 30;
+
+	if (version < 7)
+	{
+		res.path = defaults.path;
+		res.pathShape = defaults.pathShape;
+		res.speedProfile = defaults.speedProfile;
+		res.sampleRate = defaults.sampleRate;
+		res.moveDuration = defaults.moveDuration;
+	}
+
+	if (version < 8)
+	{
+		res.color = defaults.color;
+		res.tolerance = defaults.tolerance;
+		res.regionSize = defaults.regionSize;
+		res.timeout = defaults.timeout;
+	}
+
+	if (version < 9)
+	{
+		res.image = defaults.image;
+		res.searchSize = defaults.searchSize;
+	}
+
+	if (version < 10)
+	{
+		res.text = defaults.text;
+		res.keyDelayMin = defaults.keyDelayMin;
+		res.keyDelayMax = defaults.keyDelayMax;
+	}
+
+	if (version < 11)
+	{
+		res.button = defaults.button;
+		res.scroll = defaults.scroll;
+	}
+
+	if (version < 13) res.expression = defaults.expression;
+
+	return res;
+}
+
+static bool writeLegacySnapshot(const QString& filename, quint32 version, const QList<Action>& actions, const QString& windowTitle, const QString& name)
+{
+	QFile file(filename);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	QDataStream stream(&file);
+
+	stream << s_header.num << version;
+
+	setStreamVersion(stream);
+
+	// same format as QList
+	stream << (quint32)actions.size();
+
+	for (const Action& action : actions)
+	{
+		writeLegacyAction(stream, action, version);
+	}
+
+	if (version >= 3) stream << windowTitle;
+	if (version >= 6) stream << name;
+
+	return stream.status() == QDataStream::Ok;
+}
+
+// script saved in all fixtures, only with fields which existed in version 6
+static QList<Action> createFixtureActions()
+{
+	Action click;
+	click.type = Action::Type::Click;
+	click.name = QString::fromUtf8("Click \xc3\xa9");
+	click.originalPosition = QPoint(100, 200);
+	click.lastPosition = click.originalPosition;
+	click.delayMin = 50;
+	click.delayMax = 150;
+	click.duration = 2;
+
+	Action repeat;
+	repeat.type = Action::Type::Repeat;
+	repeat.name = "Repeat";
+	repeat.originalPosition = QPoint(1919, 1079);
+	repeat.lastPosition = repeat.originalPosition;
+	repeat.delayMin = 10;
+	repeat.delayMax = 20;
+	repeat.originalCount = 3;
+	repeat.lastCount = repeat.originalCount;
+
+	Action last;
+	last.type = Action::Type::Click;
+	last.name = "Last click";
+	last.delayMin = 30;
+	last.delayMax = 30;
+	last.duration = 1;
+
+	return QList<Action>() << click << repeat << last;
+}
+
+// return the first difference, an empty string if model contains exactly the expected script
+static QString compareModel(const ActionModel& model, const QList<Action>& actions, const QString& windowTitle, const QString& name)
+{
+	if (model.rowCount() != actions.size()) return QString("%1 actions instead of %2").arg(model.rowCount()).arg(actions.size());
+
+	for (int i = 0; i < actions.size(); ++i)
+	{
+		if (model.getAction(i) != actions[i]) return QString("action %1 is different").arg(i);
+	}
+
+	if (model.getWindowTitle() != windowTitle) return QString("window title \"%1\" instead of \"%2\"").arg(model.getWindowTitle()).arg(windowTitle);
+	if (model.getName() != name) return QString("name \"%1\" instead of \"%2\"").arg(model.getName()).arg(name);
+
+	return QString();
+}
+
+static quint16 checksum(const QByteArray& data)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+	return qChecksum(data);
+#else
+	return qChecksum(data.constData(), data.size());
+#endif
+}
+
+// journal with changes serialized like kClicker did with version of .acf format, see ActionJournal
+static bool writeLegacyJournal(const QString& snapshot, quint32 version, const ActionJournal::Records& records)
+{
+	QFileInfo info(snapshot);
+
+	QFile file(ActionJournal::getFilename(snapshot));
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	QDataStream stream(&file);
+
+	// journal version 1 and stamp of snapshot
+	stream << s_journalHeader.num << (quint32)1 << version << info.size() << info.lastModified().toMSecsSinceEpoch();
+
+	setStreamVersion(stream);
+
+	for (const ActionJournal::Record& record : records)
+	{
+		QByteArray payload;
+
+		QDataStream recordStream(&payload, QIODevice::WriteOnly);
+		setStreamVersion(recordStream);
+
+		recordStream << (quint8)record.operation << (qint32)record.row << (qint32)record.count << (quint32)record.actions.size();
+
+		for (const Action& action : record.actions)
+		{
+			writeLegacyAction(recordStream, action, version);
+		}
+
+		recordStream << record.offset << record.text;
+
+		stream << payload << checksum(payload);
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
+
+static QByteArray readFile(const QString& filename)
+{
+	QFile file(filename);
+
+	return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+static QJsonObject histogramToJson(const LatencyHistogram& histogram)
+{
+	QJsonObject res;
+	res["count"] = histogram.getCount();
+	res["minimum"] = histogram.getMinimum();
+	res["mean"] = histogram.getMean();
+	res["p50"] = histogram.getPercentile(50.0);
+	res["p99"] = histogram.getPercentile(99.0);
+	res["p999"] = histogram.getPercentile(99.9);
+	res["maximum"] = histogram.getMaximum();
+
+	return res;
+}
+
+Benchmark::Benchmark(const QString& filter, int maximumActions, int loopbackDuration) :m_filter(filter), m_maximumActions(maximumActions),
+	m_loopbackDuration(loopbackDuration), m_binaryFloor(0), m_textFloor(0), m_maximumRateError(5.0), m_failures(0), m_skipped(0)
+{
+}
+
+Benchmark::~Benchmark()
+{
+	if (m_xvfb.state() != QProcess::NotRunning)
+	{
+		m_xvfb.terminate();
+		m_xvfb.waitForFinished();
+	}
+}
+
+bool Benchmark::isEnabled(const QString& name) const
+{
+	return m_filter.isEmpty() || name.contains(m_filter);
+}
+
+void Benchmark::setThroughputFloors(int binary, int text)
+{
+	m_binaryFloor = binary;
+	m_textFloor = text;
+}
+
+void Benchmark::setMaximumRateError(double percent)
+{
+	m_maximumRateError = percent;
+}
+
+void Benchmark::setFixturesDirectory(const QString& directory)
+{
+	m_fixturesDirectory = directory;
+}
+
+int Benchmark::getFailures() const
+{
+	return m_failures;
+}
+
+int Benchmark::getSkipped() const
+{
+	return m_skipped;
+}
+
+template<class F>
+double Benchmark::measure(const QString& name, const QJsonObject& parameters, F function)
+{
+	if (!isEnabled(name)) return 0.0;
+
+	qint64 iterations = 0;
+	qint64 batch = 1;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// slow functions are only called once
+	while (timer.elapsed() < s_minimumTime)
+	{
+		for (qint64 i = 0; i < batch; ++i) function();
+
+		iterations += batch;
+
+		if (batch < s_maximumBatch) batch *= 2;
+	}
+
+	qint64 nanoseconds = timer.nsecsElapsed();
+
+	addResult(name, parameters, iterations, nanoseconds);
+
+	return (double)nanoseconds / iterations;
+}
+
+void Benchmark::addResult(const QString& name, const QJsonObject& parameters, qint64 iterations, qint64 nanoseconds)
+{
+	QJsonObject result;
+	result["name"] = name;
+	result["parameters"] = parameters;
+	result["iterations"] = iterations;
+	result["nanoseconds"] = nanoseconds;
+	result["nanosecondsPerIteration"] = (double)nanoseconds / iterations;
+
+	m_results.append(result);
+
+	// progress, results are written at the end
+	QTextStream(stderr) << name << " " << QJsonDocument(parameters).toJson(QJsonDocument::Compact) << ": " << (double)nanoseconds / iterations << " ns\n";
+}
+
+void Benchmark::addCheck(const QString& name, const QJsonObject& parameters, const QString& error, const QJsonObject& values)
+{
+	QJsonObject result = values;
+	result["name"] = name;
+	result["parameters"] = parameters;
+	result["passed"] = error.isEmpty();
+
+	if (!error.isEmpty())
+	{
+		result["error"] = error;
+
+		++m_failures;
+	}
+
+	m_results.append(result);
+
+	QTextStream(stderr) << name << " " << QJsonDocument(parameters).toJson(QJsonDocument::Compact) << ": " << (error.isEmpty() ? QString("passed") : QString("FAILED, %1").arg(error)) << "\n";
+}
+
+void Benchmark::addSkip(const QString& name, const QString& reason)
+{
+	QJsonObject result;
+	result["name"] = name;
+	result["skipped"] = true;
+	result["reason"] = reason;
+
+	m_results.append(result);
+
+	++m_skipped;
+
+	QTextStream(stderr) << name << ": skipped, " << reason << "\n";
+}
+
+void Benchmark::checkThroughput(const QString& name, const QJsonObject& parameters, int count, double nanoseconds, int floor)
+{
+	if (nanoseconds <= 0.0 || floor <= 0) return;
+
+	double rate = count * 1000000000.0 / nanoseconds;
+
+	QJsonObject values;
+	values["actionsPerSecond"] = rate;
+	values["floor"] = floor;
+
+	QString error;
+
+	if (rate < floor) error = QString("%1 actions/s, less than %2").arg(qRound64(rate)).arg(floor);
+
+	addCheck(name + "/throughput", parameters, error, values);
+}
+
+void Benchmark::run()
+{
+	// first because it changes the display used by all functions
+	benchmarkLoopback();
+	benchmarkClicker();
+	benchmarkExpressions();
+	benchmarkModel();
+	benchmarkCompatibility();
+	benchmarkFixtures();
+	benchmarkActionStrings();
+	benchmarkWindows();
+	benchmarkKeys();
+	benchmarkEntities();
+}
+
+QJsonDocument Benchmark::toJson() const
+{
+	QJsonObject root;
+	root["product"] = QCoreApplication::applicationName();
+	root["version"] = QCoreApplication::applicationVersion();
+	root["qt"] = qVersion();
+	root["os"] = QSysInfo::prettyProductName();
+	root["cpu"] = QSysInfo::currentCpuArchitecture();
+	root["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+	root["results"] = m_results;
+
+	return QJsonDocument(root);
+}
+
+void Benchmark::benchmarkClicker()
+{
+	Action click;
+	click.type = Action::Type::Click;
+	click.name = "click";
+	click.originalPosition = QPoint(100, 100);
+	click.delayMin = 10;
+	click.delayMax = 20;
+	click.duration = 1000000;
+
+	Action move = click;
+	move.type = Action::Type::Move;
+	move.name = "move";
+	move.path << QPoint(300, 200) << QPoint(200, 400);
+
+	Action expression = click;
+	expression.name = "expression";
+	expression.expression = "delay = random(10, 20); x = 2 * cos(t); y = 2 * sin(t)";
+
+	QList<Action> actions;
+	actions << click << move << expression;
+
+	for (const Action& action : actions)
+	{
+		QString name = QString("clicker/%1").arg(action.name);
+
+		if (!isEnabled(name)) continue;
+
+		ActionModel model;
+		model.appendActions(QList<Action>() << action);
+
+		// input events are counted but not sent
+		SimulationBackend backend(0, nullptr);
+
+		Clicker clicker(&backend);
+
+		// enough iterations to ignore script compilation
+		clicker.setTimeLimit(3600LL * 1000000LL);
+
+		qint64 iterations = 0;
+
+		QObject::connect(&clicker, &Clicker::actionExecuted, [&iterations]() { ++iterations; });
+
+		QElapsedTimer timer;
+		timer.start();
+
+		QAtomicInt stop(0);
+		clicker.run(&model, Action(), stop);
+
+		addResult(name, QJsonObject(), qMax(Q_INT64_C(1), iterations), timer.nsecsElapsed());
+	}
+}
+
+void Benchmark::benchmarkExpressions()
+{
+	static const char* s_sources[] =
+	{
+		"delay = 100",
+		"delay = 80 + 20 * sin(t)",
+		"x = n % 3; y = floor(n / 3)",
+		"delay = random(50, 150); x = 2 * cos(t * pi); y = 2 * sin(t * pi)"
+	};
+
+	for (const char* source : s_sources)
+	{
+		QJsonObject parameters;
+		parameters["source"] = source;
+
+		measure("expression/compile", parameters, [source]()
+		{
+			Expression expression;
+			s_sink += expression.compile(source);
+		});
+
+		Expression expression;
+
+		if (!expression.compile(source)) continue;
+
+		double inputs[Expression::InputLast] = { 0.0, 0.0, 0.0, 0.0 };
+		double outputs[Expression::OutputLast] = { 0.0, 0.0, 0.0 };
+
+		measure("expression/evaluate", parameters, [&]()
+		{
+			inputs[Expression::InputTime] += 0.001;
+			inputs[Expression::InputExecutions] += 1.0;
+
+			expression.evaluate(inputs, outputs, *QRandomGenerator::global());
+
+			s_sink += (qint64)(outputs[Expression::OutputDelay] + outputs[Expression::OutputX] + outputs[Expression::OutputY]);
+		});
+	}
+}
+
+void Benchmark::benchmarkModel()
+{
+	QTemporaryDir directory;
+
+	if (!directory.isValid()) return;
+
+	QString binaryFilename = directory.filePath("benchmark.acf");
+	QString otherFilename = directory.filePath("other.acf");
+	QString textFilename = directory.filePath("benchmark.txt");
+
+	for (int count = 1000; count <= m_maximumActions; count *= 10)
+	{
+		QJsonObject parameters;
+		parameters["actions"] = count;
+
+		// different types and positions, so all fields are serialized
+		QList<Action> actions;
+		actions.reserve(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			Action action;
+			action.type = i % 3 == 0 ? Action::Type::Move : Action::Type::Click;
+			action.name = QString("Action %1").arg(i);
+			action.originalPosition = QPoint(i % 1920, i % 1080);
+			action.lastPosition = action.originalPosition;
+			action.delayMin = 100;
+			action.delayMax = 200;
+
+			if (action.type == Action::Type::Move) action.path << QPoint(10, 20) << QPoint(30, 40);
+
+			actions << action;
+		}
+
+		ActionModel model;
+		model.setUndoDepth(0);
+		model.appendActions(actions);
+
+		// alternate files, else only an empty journal is appended after the first save
+		int saves = 0;
+
+		double saveTime = measure("model/save", parameters, [&]() { s_sink += model.save(++saves % 2 ? binaryFilename : otherFilename); });
+		double loadTime = measure("model/load", parameters, [&]() { ActionModel other; other.setUndoDepth(0); s_sink += other.load(binaryFilename); });
+		double saveTextTime = measure("model/saveText", parameters, [&]() { s_sink += model.saveText(textFilename); });
+		double loadTextTime = measure("model/loadText", parameters, [&]() { ActionModel other; other.setUndoDepth(0); s_sink += other.loadText(textFilename); });
+
+		checkThroughput("model/save", parameters, count, saveTime, m_binaryFloor);
+		checkThroughput("model/load", parameters, count, loadTime, m_binaryFloor);
+		checkThroughput("model/saveText", parameters, count, saveTextTime, m_textFloor);
+		checkThroughput("model/loadText", parameters, count, loadTextTime, m_textFloor);
+	}
+}
+
+void Benchmark::benchmarkCompatibility()
+{
+	QTemporaryDir directory;
+
+	if (!directory.isValid()) return;
+
+	// small image with several colors, saved in PNG in both formats
+	QImage image(8, 8, QImage::Format_RGB32);
+	image.fill(qRgb(12, 34, 56));
+	image.setPixel(3, 5, qRgb(255, 128, 0));
+
+	QString windowTitle = "kClicker compatibility";
+	QString name = "compatibility";
+
+	for (int count = 10; count <= m_maximumActions; count *= 100)
+	{
+		QList<Action> actions;
+		actions.reserve(count);
+
+		for (int i = 0; i < count; ++i) actions << createCompatibilityAction(i, image);
+
+		QJsonObject parameters;
+		parameters["actions"] = count;
+
+		// files written by previous versions must be read and saved again without losing anything
+		for (quint32 version = 1; version <= ActionModel::getVersion() && isEnabled("compat/acf"); ++version)
+		{
+			QJsonObject versionParameters = parameters;
+			versionParameters["version"] = (int)version;
+
+			QString legacyFilename = directory.filePath(QString("version%1.acf").arg(version));
+			QString upgradedFilename = directory.filePath(QString("upgraded%1.acf").arg(version));
+
+			QList<Action> expected;
+			expected.reserve(count);
+
+			for (const Action& action : actions) expected << getLegacyAction(action, version);
+
+			QString expectedWindowTitle = version >= 3 ? windowTitle : QString();
+			QString expectedName = version >= 6 ? name : QFileInfo(legacyFilename).baseName();
+
+			ActionModel model;
+			model.setUndoDepth(0);
+
+			QString error;
+
+			if (!writeLegacySnapshot(legacyFilename, version, actions, windowTitle, name))
+			{
+				error = "unable to write file";
+			}
+			else if (!model.load(legacyFilename))
+			{
+				error = "unable to load file";
+			}
+			else
+			{
+				error = compareModel(model, expected, expectedWindowTitle, expectedName);
+			}
+
+			if (error.isEmpty())
+			{
+				ActionModel upgraded;
+				upgraded.setUndoDepth(0);
+
+				if (!model.save(upgradedFilename) || !upgraded.load(upgradedFilename))
+				{
+					error = "unable to save and load file with current version";
+				}
+				else
+				{
+					error = compareModel(upgraded, expected, expectedWindowTitle, expectedName);
+
+					if (!error.isEmpty()) error = QString("after saving with current version, %1").arg(error);
+				}
+			}
+
+			addCheck("compat/acf", versionParameters, error);
+		}
+
+		// changes saved by a previous version in a journal must not be lost after an upgrade
+		for (quint32 version = s_firstJournalVersion; version <= ActionModel::getVersion() && isEnabled("compat/journal"); ++version)
+		{
+			QJsonObject versionParameters = parameters;
+			versionParameters["version"] = (int)version;
+
+			QString filename = directory.filePath(QString("journal%1.acf").arg(version));
+
+			// one record of each operation changing actions, title or name
+			ActionJournal::Records records;
+
+			ActionJournal::Record record;
+			record.operation = ActionJournal::Record::Operation::SetAction;
+			record.row = 0;
+			record.actions << actions.last();
+			records << record;
+
+			record = ActionJournal::Record();
+			record.operation = ActionJournal::Record::Operation::InsertActions;
+			record.row = 1;
+			record.actions << actions[0] << actions[1];
+			records << record;
+
+			record = ActionJournal::Record();
+			record.operation = ActionJournal::Record::Operation::RemoveActions;
+			record.row = 2;
+			record.count = 1;
+			records << record;
+
+			record = ActionJournal::Record();
+			record.operation = ActionJournal::Record::Operation::SetWindowTitle;
+			record.text = "kClicker journal";
+			records << record;
+
+			record = ActionJournal::Record();
+			record.operation = ActionJournal::Record::Operation::SetName;
+			record.text = "journal";
+			records << record;
+
+			QList<Action> expected;
+			expected.reserve(count + 1);
+
+			for (const Action& action : actions) expected << getLegacyAction(action, version);
+
+			expected[0] = getLegacyAction(actions.last(), version);
+			expected.insert(1, getLegacyAction(actions[0], version));
+			expected.insert(2, getLegacyAction(actions[1], version));
+			expected.removeAt(2);
+
+			ActionModel model;
+			model.setUndoDepth(0);
+
+			QString error;
+
+			if (!writeLegacySnapshot(filename, version, actions, windowTitle, name) || !writeLegacyJournal(filename, version, records))
+			{
+				error = "unable to write files";
+			}
+			else if (!model.load(filename))
+			{
+				error = "unable to load file";
+			}
+			else
+			{
+				error = compareModel(model, expected, "kClicker journal", "journal");
+			}
+
+			// a journal from an older version is merged in a new snapshot
+			if (error.isEmpty())
+			{
+				ActionModel saved;
+				saved.setUndoDepth(0);
+
+				if (!model.save(filename) || !saved.load(filename))
+				{
+					error = "unable to save and load file with current version";
+				}
+				else
+				{
+					error = compareModel(saved, expected, "kClicker journal", "journal");
+
+					if (!error.isEmpty()) error = QString("after saving with current version, %1").arg(error);
+				}
+			}
+
+			addCheck("compat/journal", versionParameters, error);
+		}
+
+		ActionModel model;
+		model.setUndoDepth(0);
+		model.appendActions(actions);
+		model.setWindowTitle(windowTitle);
+		model.setName(name);
+
+		// any change of current format must increase the version, else older files would be read incorrectly
+		if (isEnabled("compat/format"))
+		{
+			QString expectedFilename = directory.filePath("expected.acf");
+			QString currentFilename = directory.filePath("current.acf");
+
+			QString error;
+
+			if (!writeLegacySnapshot(expectedFilename, ActionModel::getVersion(), actions, windowTitle, name) || !model.save(currentFilename))
+			{
+				error = "unable to write files";
+			}
+			else if (readFile(expectedFilename) != readFile(currentFilename))
+			{
+				error = QString("format of version %1 changed without increasing version").arg(ActionModel::getVersion());
+			}
+
+			addCheck("compat/format", parameters, error);
+		}
+
+		if (count <= s_maximumTextActions && isEnabled("compat/text"))
+		{
+			QString textFilename = directory.filePath(QString("text%1.txt").arg(count));
+
+			ActionModel other;
+			other.setUndoDepth(0);
+
+			QString error;
+
+			if (!model.saveText(textFilename) || !other.loadText(textFilename))
+			{
+				error = "unable to save and load file";
+			}
+			else
+			{
+				error = compareModel(other, actions, windowTitle, name);
+			}
+
+			addCheck("compat/text", parameters, error);
+		}
+	}
+}
+
+void Benchmark::benchmarkFixtures()
+{
+	if (m_fixturesDirectory.isEmpty() || !isEnabled("compat/fixture")) return;
+
+	QTemporaryDir directory;
+
+	if (!directory.isValid()) return;
+
+	QDir fixtures(m_fixturesDirectory);
+
+	QList<Action> actions = createFixtureActions();
+
+	for (quint32 version = 1; version <= s_lastFixtureVersion; ++version)
+	{
+		QJsonObject parameters;
+		parameters["version"] = (int)version;
+
+		QString fixtureFilename = fixtures.filePath(QString("version%1.acf").arg(version));
+		QString upgradedFilename = directory.filePath(QString("upgraded%1.acf").arg(version));
+
+		QList<Action> expected;
+
+		for (const Action& action : actions) expected << getLegacyAction(action, version);
+
+		QString expectedWindowTitle = version >= 3 ? QString("kClicker fixture") : QString();
+		QString expectedName = version >= 6 ? QString("fixture") : QFileInfo(fixtureFilename).baseName();
+
+		ActionModel model;
+		model.setUndoDepth(0);
+
+		QString error;
+
+		if (!QFile::exists(fixtureFilename))
+		{
+			error = "file not found";
+		}
+		else if (!model.load(fixtureFilename))
+		{
+			error = "unable to load file";
+		}
+		else
+		{
+			error = compareModel(model, expected, expectedWindowTitle, expectedName);
+		}
+
+		if (error.isEmpty())
+		{
+			ActionModel upgraded;
+			upgraded.setUndoDepth(0);
+
+			if (!model.save(upgradedFilename) || !upgraded.load(upgradedFilename))
+			{
+				error = "unable to save and load file with current version";
+			}
+			else
+			{
+				error = compareModel(upgraded, expected, expectedWindowTitle, expectedName);
+
+				if (!error.isEmpty()) error = QString("after saving with current version, %1").arg(error);
+			}
+		}
+
+		addCheck("compat/fixture", parameters, error);
+	}
+}
+
+void Benchmark::benchmarkActionStrings()
+{
+	Action action;
+	action.type = Action::Type::Click;
+	action.name = "Click on \"OK\" & continue";
+	action.originalPosition = QPoint(640, 480);
+	action.lastPosition = action.originalPosition;
+	action.delayMin = 100;
+	action.delayMax = 200;
+	action.duration = 5;
+
+	QString str = action.toString();
+
+	if (isEnabled("action/fromString"))
+	{
+		// parsing must give the same action, else only a failed match would be measured
+		addCheck("action/fromString", QJsonObject(), Action::fromString(str) == action ? QString() : QString("\"%1\" is not parsed correctly").arg(str));
+	}
+
+	measure("action/toString", QJsonObject(), [&]() { s_sink += action.toString().size(); });
+	measure("action/fromString", QJsonObject(), [&]() { s_sink += Action::fromString(str).delayMax; });
+}
+
+void Benchmark::benchmarkWindows()
+{
+	measure("windows/createWindowsList", QJsonObject(), []()
+	{
+		Windows windows;
+		createWindowsList(windows);
+
+		s_sink += windows.size();
+	});
+
+	// worst case, all windows are checked
+	measure("windows/getWindowWithTitle", QJsonObject(), []() { s_sink += getWindowWithTitle("kClicker benchmark window which doesn't exist").id != 0; });
+}
+
+void Benchmark::benchmarkKeys()
+{
+	QKeySequence sequence("Ctrl+Shift+F5");
+
+	measure("keys/QKeySequenceToVK", QJsonObject(), [&]() { s_sink += QKeySequenceToVK(sequence); });
+}
+
+void Benchmark::benchmarkEntities()
+{
+	// with accents and symbols encoded as entities
+	QString text = QString::fromUtf8("Click on <OK> & wait for \"Done\" in l'\xc3\xa9" "cran principal, 100 \xe2\x82\xac, tab\there");
+	QString encoded = encodeEntities(text);
+
+	QJsonObject parameters;
+	parameters["length"] = text.length();
+
+	measure("entities/encode", parameters, [&]() { s_sink += encodeEntities(text).size(); });
+	measure("entities/decode", parameters, [&]() { s_sink += decodeEntities(encoded).size(); });
+}
+
+bool Benchmark::startXvfb()
+{
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+	for (int display = s_firstXvfbDisplay; display < s_firstXvfbDisplay + 10; ++display)
+	{
+		// already used by another server
+		if (QFile::exists(QString("/tmp/.X%1-lock").arg(display))) continue;
+
+		QString name = QString(":%1").arg(display);
+
+		m_xvfb.start("Xvfb", QStringList() << name << "-screen" << "0" << "1280x1024x24" << "-nolisten" << "tcp" << "+extension" << "RECORD" << "+extension" << "XTEST");
+
+		if (!m_xvfb.waitForStarted()) return false;
+
+		qputenv("DISPLAY", name.toLatin1());
+
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+void Benchmark::benchmarkLoopback()
+{
+	QString name = "loopback/xtest";
+
+	if (m_loopbackDuration <= 0 || !isEnabled(name)) return;
+
+	if (!startXvfb())
+	{
+		addSkip(name, "unable to start Xvfb");
+		return;
+	}
+
+	LoopbackBackend backend;
+	PressListener listener;
+
+	// wait until server accepts connections
+	bool started = false;
+
+	for (int i = 0; i < 500 && !started && m_xvfb.state() == QProcess::Running; ++i)
+	{
+		started = listener.start(&backend.getClock());
+
+		if (!started) QThread::msleep(10);
+	}
+
+	if (!started)
+	{
+		addSkip(name, "RECORD extension not available");
+	}
+	else
+	{
+		Action action;
+		action.type = Action::Type::Click;
+		action.originalPosition = QPoint(100, 100);
+		action.lastPosition = action.originalPosition;
+		action.delayMin = s_loopbackDelayMin;
+		action.delayMax = s_loopbackDelayMax;
+
+		Clicker clicker(&backend);
+		clicker.setTimeLimit(backend.getTime() + (qint64)m_loopbackDuration * 1000000);
+
+		QAtomicInt stop(0);
+		clicker.run(nullptr, action, stop);
+
+		// let last events reach the server
+		QThread::msleep(100);
+
+		QVector<qint64> received = listener.takePresses();
+		listener.stop();
+
+		const QVector<qint64>& sent = backend.getPresses();
+
+		// server delivers events in order, so each press matches the one with the same index
+		int matched = qMin(sent.size(), received.size());
+
+		LatencyHistogram delivery, intervalError;
+
+		for (int i = 0; i < matched; ++i)
+		{
+			delivery.add(qMax(Q_INT64_C(0), received[i] - sent[i]));
+
+			if (i > 0) intervalError.add(qAbs((received[i] - received[i - 1]) - (sent[i] - sent[i - 1])));
+		}
+
+		double sentRate = sent.size() > 1 ? (sent.size() - 1) * 1000000.0 / (sent.last() - sent.first()) : 0.0;
+		double receivedRate = received.size() > 1 ? (received.size() - 1) * 1000000.0 / (received.last() - received.first()) : 0.0;
+
+		QJsonObject parameters;
+		parameters["duration"] = m_loopbackDuration;
+		parameters["delayMin"] = s_loopbackDelayMin;
+		parameters["delayMax"] = s_loopbackDelayMax;
+
+		int lost = sent.size() - matched;
+		double rateError = sentRate > 0.0 ? (receivedRate - sentRate) * 100.0 / sentRate : 0.0;
+
+		QJsonObject values;
+		values["sent"] = sent.size();
+		values["received"] = received.size();
+		values["lost"] = lost;
+		values["sentClicksPerSecond"] = sentRate;
+		values["receivedClicksPerSecond"] = receivedRate;
+		values["rateError"] = rateError;
+		values["deliveryLatency"] = histogramToJson(delivery);
+		values["intervalError"] = histogramToJson(intervalError);
+		values["lateness"] = histogramToJson(clicker.getLateness());
+
+		QTextStream(stderr) << name << ": " << received.size() << "/" << sent.size() << " clicks, delivery " << delivery.toString() << "\n";
+
+		QString error;
+
+		if (received.isEmpty())
+		{
+			error = "no clicks received";
+		}
+		else if (lost > 0)
+		{
+			error = QString("%1 clicks lost").arg(lost);
+		}
+		else if (qAbs(rateError) > m_maximumRateError)
+		{
+			error = QString("rate error of %1 %, more than %2 %").arg(rateError, 0, 'f', 2).arg(m_maximumRateError);
+		}
+
+		addCheck(name, parameters, error, values);
+	}
+}
@@ -0,0 +1,107 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Measure time spent in critical parts of kClicker, results can be compared between releases.
+class Benchmark
+{
+public:
+	// only run benchmarks with a name containing filter, models have up to maximumActions actions
+	// loopbackDuration is the time in s to click on a virtual X server, 0 to disable it
+	Benchmark(const QString& filter, int maximumActions, int loopbackDuration);
+	~Benchmark();
+
+	// minimum number of actions loaded or saved per second, 0 to not check throughput
+	void setThroughputFloors(int binary, int text);
+
+	// loopback check fails if rate of received clicks differs more from sent ones
+	void setMaximumRateError(double percent);
+
+	// directory with .acf files written by previous versions, they are not checked if empty
+	void setFixturesDirectory(const QString& directory);
+
+	void run();
+
+	// number of checks which failed
+	int getFailures() const;
+
+	// number of checks which couldn't run on this system
+	int getSkipped() const;
+
+	// results with information about system
+	QJsonDocument toJson() const;
+
+private:
+	bool isEnabled(const QString& name) const;
+
+	// call function until total time is long enough to be accurate
+	// return time in ns of one call, 0 if benchmark is disabled
+	template<class F>
+	double measure(const QString& name, const QJsonObject& parameters, F function);
+
+	void addResult(const QString& name, const QJsonObject& parameters, qint64 iterations, qint64 nanoseconds);
+
+	// check fails if error is not empty, values are added to result
+	void addCheck(const QString& name, const QJsonObject& parameters, const QString& error, const QJsonObject& values = QJsonObject());
+
+	// check can't run on this system
+	void addSkip(const QString& name, const QString& reason);
+
+	// fail if count actions processed in nanoseconds are slower than floor actions per second
+	void checkThroughput(const QString& name, const QJsonObject& parameters, int count, double nanoseconds, int floor);
+
+	void benchmarkClicker();
+	void benchmarkExpressions();
+	void benchmarkModel();
+
+	// read scripts written with all versions of .acf format and in text format
+	void benchmarkCompatibility();
+
+	// read scripts saved by previous versions of kClicker and save them with current version
+	void benchmarkFixtures();
+
+	void benchmarkActionStrings();
+	void benchmarkWindows();
+	void benchmarkKeys();
+	void benchmarkEntities();
+
+	// start Xvfb on a free display and use it until the end, because X11 input display is kept open
+	bool startXvfb();
+
+	// compare clicks sent by clicker with the ones received by X server
+	void benchmarkLoopback();
+
+	QString m_filter;
+	int m_maximumActions;
+	int m_loopbackDuration;
+	int m_binaryFloor;
+	int m_textFloor;
+	double m_maximumRateError;
+	QString m_fixturesDirectory;
+	int m_failures;
+	int m_skipped;
+
+	QProcess m_xvfb;
+
+	QJsonArray m_results;
+};
+
+#endif
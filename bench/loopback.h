@@ -0,0 +1,44 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+struct PressListenerData;
+
+// Receive button presses sent to the X server by any client, using its own
+// connections, so injected clicks can be compared to delivered ones.
+class PressListener
+{
+public:
+	PressListener();
+	~PressListener();
+
+	// times are in µs since clock start, return false if server or RECORD extension is not available
+	bool start(const QElapsedTimer* clock);
+	void stop();
+
+	// times of presses received since last call
+	QVector<qint64> takePresses();
+
+private:
+	PressListenerData* m_data;
+};
+
+#endif
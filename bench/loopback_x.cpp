@@ -0,0 +1,192 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "loopback.h"
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+struct PressListenerData
+{
+	PressListenerData() :controlDisplay(nullptr), dataDisplay(nullptr), context(0), clock(nullptr), started(0)
+	{
+	}
+
+	// XRecordEnableContext blocks its display, so we need another one to stop it
+	Display* controlDisplay;
+	Display* dataDisplay;
+
+	XRecordContext context;
+
+	QFuture<void> thread;
+
+	const QElapsedTimer* clock;
+
+	// set when server starts sending events
+	QAtomicInt started;
+
+	QMutex mutex;
+	QVector<qint64> presses;
+};
+
+static void recordCallback(XPointer closure, XRecordInterceptData* data)
+{
+	PressListenerData* listener = (PressListenerData*)closure;
+
+	if (data->category == XRecordStartOfData)
+	{
+		listener->started = 1;
+	}
+	else if (data->category == XRecordFromServer && (((const xEvent*)data->data)->u.u.type & 0x7f) == ButtonPress)
+	{
+		// as soon as possible, before locking
+		qint64 time = listener->clock->nsecsElapsed() / 1000;
+
+		QMutexLocker locker(&listener->mutex);
+
+		listener->presses << time;
+	}
+
+	XRecordFreeData(data);
+}
+
+PressListener::PressListener() :m_data(nullptr)
+{
+}
+
+PressListener::~PressListener()
+{
+	stop();
+}
+
+bool PressListener::start(const QElapsedTimer* clock)
+{
+	stop();
+
+	PressListenerData* listener = new PressListenerData();
+	listener->clock = clock;
+
+	listener->controlDisplay = XOpenDisplay(nullptr);
+	listener->dataDisplay = XOpenDisplay(nullptr);
+
+	int major = 0, minor = 0;
+
+	if (listener->controlDisplay && listener->dataDisplay && XRecordQueryVersion(listener->controlDisplay, &major, &minor))
+	{
+		XRecordRange* range = XRecordAllocRange();
+		range->device_events.first = ButtonPress;
+		range->device_events.last = ButtonPress;
+
+		XRecordClientSpec clients = XRecordAllClients;
+
+		listener->context = XRecordCreateContext(listener->controlDisplay, 0, &clients, 1, &range, 1);
+
+		XFree(range);
+	}
+
+	m_data = listener;
+
+	if (!listener->context)
+	{
+		stop();
+		return false;
+	}
+
+	// context must be known by server before enabling it on the other display
+	XSync(listener->controlDisplay, False);
+
+	listener->thread = QtConcurrent::run([listener]()
+	{
+		// returns when context is disabled
+		XRecordEnableContext(listener->dataDisplay, listener->context, recordCallback, (XPointer)listener);
+	});
+
+	// don't miss first presses
+	while (!listener->started && listener->thread.isRunning()) QThread::msleep(1);
+
+	return listener->started != 0;
+}
+
+void PressListener::stop()
+{
+	if (!m_data) return;
+
+	if (m_data->context)
+	{
+		XRecordDisableContext(m_data->controlDisplay, m_data->context);
+		XFlush(m_data->controlDisplay);
+
+		m_data->thread.waitForFinished();
+
+		XRecordFreeContext(m_data->controlDisplay, m_data->context);
+	}
+
+	if (m_data->dataDisplay) XCloseDisplay(m_data->dataDisplay);
+	if (m_data->controlDisplay) XCloseDisplay(m_data->controlDisplay);
+
+	delete m_data;
+	m_data = nullptr;
+}
+
+QVector<qint64> PressListener::takePresses()
+{
+	QVector<qint64> presses;
+
+	if (!m_data) return presses;
+
+	QMutexLocker locker(&m_data->mutex);
+
+	presses.swap(m_data->presses);
+
+	return presses;
+}
+
+#else
+
+PressListener::PressListener() :m_data(nullptr)
+{
+}
+
+PressListener::~PressListener()
+{
+}
+
+bool PressListener::start(const QElapsedTimer* clock)
+{
+	return false;
+}
+
+void PressListener::stop()
+{
+}
+
+QVector<qint64> PressListener::takePresses()
+{
+	return QVector<qint64>();
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "benchmark.h"
+
+#ifdef HAVE_CONFIG_H
+	#include "config.h"
+#endif
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+int main(int argc, char *argv[])
+{
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+	// pixmaps need a GUI application but benchmarks don't need a screen
+	if (qEnvironmentVariableIsEmpty("DISPLAY") && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+#endif
+
+	QGuiApplication app(argc, argv);
+
+	QGuiApplication::setApplicationName(PRODUCT);
+	QGuiApplication::setOrganizationName(AUTHOR);
+	QGuiApplication::setApplicationVersion(VERSION);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QGuiApplication::translate("main", "Measure time spent in critical parts of %1, check compatibility of scripts and write results in JSON.").arg(PRODUCT));
+	parser.addHelpOption();
+	parser.addVersionOption();
+
+	QCommandLineOption outputOption("output", QGuiApplication::translate("main", "Write results to file instead of standard output."), QGuiApplication::translate("main", "file"));
+	QCommandLineOption filterOption("filter", QGuiApplication::translate("main", "Only run benchmarks with a name containing text."), QGuiApplication::translate("main", "text"));
+	QCommandLineOption actionsOption("actions", QGuiApplication::translate("main", "Maximum number of actions in loaded and saved scripts."), QGuiApplication::translate("main", "count"), "1000000");
+	QCommandLineOption binaryFloorOption("binary-floor", QGuiApplication::translate("main", "Fail if fewer actions are loaded or saved per second in .acf format, 0 to not check."), QGuiApplication::translate("main", "actions"), "100000");
+	QCommandLineOption textFloorOption("text-floor", QGuiApplication::translate("main", "Fail if fewer actions are loaded or saved per second in text format, 0 to not check."), QGuiApplication::translate("main", "actions"), "1000");
+	QCommandLineOption loopbackOption("loopback", QGuiApplication::translate("main", "Click during duration on a virtual X server and measure delivery latency."), QGuiApplication::translate("main", "seconds"), "0");
+	QCommandLineOption rateErrorOption("max-rate-error", QGuiApplication::translate("main", "Fail if rate of clicks received by virtual X server differs more from sent clicks."), QGuiApplication::translate("main", "percent"), "5");
+	QCommandLineOption fixturesOption("fixtures", QGuiApplication::translate("main", "Check .acf files saved by previous versions in directory."), QGuiApplication::translate("main", "directory"));
+
+	parser.addOption(outputOption);
+	parser.addOption(filterOption);
+	parser.addOption(actionsOption);
+	parser.addOption(binaryFloorOption);
+	parser.addOption(textFloorOption);
+	parser.addOption(loopbackOption);
+	parser.addOption(rateErrorOption);
+	parser.addOption(fixturesOption);
+	parser.process(app);
+
+	Benchmark benchmark(parser.value(filterOption), parser.value(actionsOption).toInt(), parser.value(loopbackOption).toInt());
+	benchmark.setThroughputFloors(parser.value(binaryFloorOption).toInt(), parser.value(textFloorOption).toInt());
+	benchmark.setMaximumRateError(parser.value(rateErrorOption).toDouble());
+	benchmark.setFixturesDirectory(parser.value(fixturesOption));
+	benchmark.run();
+
+	QByteArray json = benchmark.toJson().toJson();
+
+	QFile file;
+
+	if (parser.isSet(outputOption))
+	{
+		file.setFileName(parser.value(outputOption));
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return 1;
+	}
+	else if (!file.open(stdout, QIODevice::WriteOnly))
+	{
+		return 1;
+	}
+
+	if (file.write(json) != json.size()) return 1;
+
+	// compatibility, throughput or loopback checks failed
+	if (benchmark.getFailures() > 0) return 2;
+
+	// same value as CTest SKIP_RETURN_CODE, when a check can't run on this system
+	if (benchmark.getSkipped() > 0) return 77;
+
+	return 0;
+}
@@ -1,201 +1,529 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "action.h"
-
-QString pointToString(const QPoint& point)
-{
-	return QString("(%1,%2)").arg(point.x()).arg(point.y());
-}
-
-QString typeToString(Action::Type type)
-{
-	switch (type)
-	{
-	case Action::Type::Click: return "click";
-	case Action::Type::Repeat: return "repeat";
-	default: break;
-	}
-
-	return "none";
-}
-
-Action::Type typeFromString(const QString& type)
-{
-	if (type == "click")
-	{
-		return Action::Type::Click;
-	}
-
-	if (type == "repeat")
-	{
-		return Action::Type::Repeat;
-	}
-
-	return Action::Type::None;
-}
-
-int typeToInt(Action::Type type)
-{
-	switch (type)
-	{
-	case Action::Type::Click: return 1;
-	case Action::Type::Repeat: return 2;
-	default: break;
-	}
-
-	return 0;
-}
-
-Action::Type typeFromInt(int type)
-{
-	switch (type)
-	{
-	case 1: return Action::Type::Click;
-	case 2: return Action::Type::Repeat;
-	default: break;
-	}
-
-	return Action::Type::None;
-}
-
-QString Action::toString() const
-{
-	return QString("\"%1\" %2 %3-%4 %5 %6 %7").arg(name)
-		.arg(pointToString(originalPosition))
-		.arg(delayMin)
-		.arg(delayMax)
-		.arg(duration)
-		.arg(typeToString(type))
-		.arg(originalCount);
-}
-
-Action Action::fromString(const QString& str)
-{
-	QRegularExpression regex("\"(.*)\" \\(([0-9]+)\\,([0-9]+)\\) ([0-9]+)-([0-9]+) ([a-z]+) ([0-9]+)");
-
-	QRegularExpressionMatch match = regex.match(str);
-
-	Action action;
-
-	if (match.hasMatch())
-	{
-		action.name = match.captured(1);
-		action.originalPosition.setX(match.captured(2).toInt());
-		action.originalPosition.setY(match.captured(3).toInt());
-		action.delayMin = match.captured(4).toInt();
-		action.delayMax = match.captured(5).toInt();
-		action.duration = match.captured(6).toInt();
-		action.type = typeFromString(match.captured(7));
-		action.originalCount = match.captured(8).toInt();
-	}
-
-	return action;
-}
-
-bool Action::readFromSettings(QSettings& settings)
-{
-	name = settings.value("Name").toString();
-	type = typeFromString(settings.value("Type").toString());
-	originalPosition = settings.value("OriginalPosition").toPoint();
-	originalCount = settings.value("OriginalCount").toInt();
-	delayMin = settings.value("DelayMin").toInt();
-	delayMax = settings.value("DelayMax").toInt();
-	duration = settings.value("Duration").toInt();
-
-	return true;
-}
-
-bool Action::writeToSettings(QSettings& settings) const
-{
-	settings.setValue("Name", name);
-	settings.setValue("Type", typeToString(type));
-	settings.setValue("OriginalPosition", originalPosition);
-	settings.setValue("OriginalCount", originalCount);
-	settings.setValue("DelayMin", delayMin);
-	settings.setValue("DelayMax", delayMax);
-	settings.setValue("Duration", duration);
-
-	return true;
-}
-
-QDataStream& operator << (QDataStream& stream, const Action &action)
-{
-	stream << action.name << action.originalPosition << action.delayMin << action.delayMax << action.duration << action.type << action.originalCount;
-
-	return stream;
-}
-
-QDataStream& operator >> (QDataStream& stream, Action& action)
-{
-	stream >> action.name >> action.originalPosition;
-	
-	if (stream.device()->property("version").toInt() >= 5)
-	{
-		stream >> action.delayMin;
-	}
-	else
-	{
-		action.delayMin = 30;
-	}
-
-	stream >> action.delayMax;
-
-	if (stream.device()->property("version").toInt() >= 2)
-	{
-		stream >> action.duration;
-
-		if (stream.device()->property("version").toInt() >= 4)
-		{
-			stream >> action.type >> action.originalCount;
-		}
-		else
-		{
-			action.type = Action::Type::Click;
-			action.originalCount = 0;
-		}
-	}
-	else
-	{
-		action.duration = 0;
-	}
-
-	// copy original position
-	action.lastPosition = action.originalPosition;
-
-	// copy original count
-	action.lastCount = action.originalCount;
-
-	return stream;
-}
-
-QDataStream& operator << (QDataStream& stream, const Action::Type& type)
-{
-	return stream << typeToInt(type);
-}
-
-QDataStream& operator >> (QDataStream& stream, Action::Type& type)
-{
-	int tmp;
-	stream >> tmp;
-	type = typeFromInt(tmp);
-
-	return stream;
-}
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "action.h"
+
+QString pointToString(const QPoint& point)
+{
+	return QString("(%1,%2)").arg(point.x()).arg(point.y());
+}
+
+QString typeToString(Action::Type type)
+{
+	switch (type)
+	{
+	case Action::Type::Click: return "click";
+	case Action::Type::Repeat: return "repeat";
+	case Action::Type::Move: return "move";
+	case Action::Type::Drag: return "drag";
+	case Action::Type::WaitPixel: return "waitpixel";
+	case Action::Type::FindImage: return "findimage";
+	case Action::Type::KeyPress: return "keypress";
+	case Action::Type::KeyRelease: return "keyrelease";
+	case Action::Type::Text: return "text";
+	case Action::Type::Scroll: return "scroll";
+	case Action::Type::Jump: return "jump";
+	case Action::Type::Loop: return "loop";
+	case Action::Type::Call: return "call";
+	case Action::Type::Return: return "return";
+	default: break;
+	}
+
+	return "none";
+}
+
+Action::Type typeFromString(const QString& type)
+{
+	if (type == "click")
+	{
+		return Action::Type::Click;
+	}
+
+	if (type == "repeat")
+	{
+		return Action::Type::Repeat;
+	}
+
+	if (type == "move")
+	{
+		return Action::Type::Move;
+	}
+
+	if (type == "drag")
+	{
+		return Action::Type::Drag;
+	}
+
+	if (type == "waitpixel")
+	{
+		return Action::Type::WaitPixel;
+	}
+
+	if (type == "findimage")
+	{
+		return Action::Type::FindImage;
+	}
+
+	if (type == "keypress")
+	{
+		return Action::Type::KeyPress;
+	}
+
+	if (type == "keyrelease")
+	{
+		return Action::Type::KeyRelease;
+	}
+
+	if (type == "text")
+	{
+		return Action::Type::Text;
+	}
+
+	if (type == "scroll")
+	{
+		return Action::Type::Scroll;
+	}
+
+	if (type == "jump")
+	{
+		return Action::Type::Jump;
+	}
+
+	if (type == "loop")
+	{
+		return Action::Type::Loop;
+	}
+
+	if (type == "call")
+	{
+		return Action::Type::Call;
+	}
+
+	if (type == "return")
+	{
+		return Action::Type::Return;
+	}
+
+	return Action::Type::None;
+}
+
+int typeToInt(Action::Type type)
+{
+	switch (type)
+	{
+	case Action::Type::Click: return 1;
+	case Action::Type::Repeat: return 2;
+	case Action::Type::Move: return 3;
+	case Action::Type::Drag: return 4;
+	case Action::Type::WaitPixel: return 5;
+	case Action::Type::FindImage: return 6;
+	case Action::Type::KeyPress: return 7;
+	case Action::Type::KeyRelease: return 8;
+	case Action::Type::Text: return 9;
+	case Action::Type::Scroll: return 10;
+	case Action::Type::Jump: return 11;
+	case Action::Type::Loop: return 12;
+	case Action::Type::Call: return 13;
+	case Action::Type::Return: return 14;
+	default: break;
+	}
+
+	return 0;
+}
+
+Action::Type typeFromInt(int type)
+{
+	switch (type)
+	{
+	case 1: return Action::Type::Click;
+	case 2: return Action::Type::Repeat;
+	case 3: return Action::Type::Move;
+	case 4: return Action::Type::Drag;
+	case 5: return Action::Type::WaitPixel;
+	case 6: return Action::Type::FindImage;
+	case 7: return Action::Type::KeyPress;
+	case 8: return Action::Type::KeyRelease;
+	case 9: return Action::Type::Text;
+	case 10: return Action::Type::Scroll;
+	case 11: return Action::Type::Jump;
+	case 12: return Action::Type::Loop;
+	case 13: return Action::Type::Call;
+	case 14: return Action::Type::Return;
+	default: break;
+	}
+
+	return Action::Type::None;
+}
+
+// same order as Action::Button
+static const char* s_buttonNames[] = { "left", "middle", "right", "back", "forward" };
+
+static QString buttonToString(Action::Button button)
+{
+	return s_buttonNames[(int)button];
+}
+
+static Action::Button buttonFromString(const QString& button)
+{
+	for (int i = 0; i < 5; ++i)
+	{
+		if (button == s_buttonNames[i]) return (Action::Button)i;
+	}
+
+	return Action::Button::Left;
+}
+
+QString pathToString(const QVector<QPoint>& path)
+{
+	QStringList points;
+
+	for (const QPoint& point : path)
+	{
+		points << QString("%1,%2").arg(point.x()).arg(point.y());
+	}
+
+	return points.join(' ');
+}
+
+QVector<QPoint> pathFromString(const QString& str)
+{
+	QVector<QPoint> path;
+
+	QRegularExpression regex("(-?[0-9]+),(-?[0-9]+)");
+
+	QRegularExpressionMatchIterator it = regex.globalMatch(str);
+
+	while (it.hasNext())
+	{
+		QRegularExpressionMatch match = it.next();
+
+		path << QPoint(match.captured(1).toInt(), match.captured(2).toInt());
+	}
+
+	return path;
+}
+
+QString Action::toString() const
+{
+	return QString("\"%1\" %2 %3-%4 %5 %6 %7").arg(name)
+		.arg(pointToString(originalPosition))
+		.arg(delayMin)
+		.arg(delayMax)
+		.arg(duration)
+		.arg(typeToString(type))
+		.arg(originalCount);
+}
+
+Action Action::fromString(const QString& str)
+{
+	// same format as toString, compiled only once
+	static const QRegularExpression regex("^\"(.*)\" \\((-?[0-9]+),(-?[0-9]+)\\) ([0-9]+)-([0-9]+) ([0-9]+) ([a-z]+) ([0-9]+)$");
+
+	QRegularExpressionMatch match = regex.match(str);
+
+	Action action;
+
+	if (match.hasMatch())
+	{
+		action.name = match.captured(1);
+		action.originalPosition.setX(match.captured(2).toInt());
+		action.originalPosition.setY(match.captured(3).toInt());
+		action.delayMin = match.captured(4).toInt();
+		action.delayMax = match.captured(5).toInt();
+		action.duration = match.captured(6).toInt();
+		action.type = typeFromString(match.captured(7));
+		action.originalCount = match.captured(8).toInt();
+
+		action.lastPosition = action.originalPosition;
+		action.lastCount = action.originalCount;
+	}
+
+	return action;
+}
+
+bool Action::operator == (const Action& other) const
+{
+	return name == other.name && type == other.type && originalPosition == other.originalPosition &&
+		delayMin == other.delayMin && delayMax == other.delayMax && duration == other.duration &&
+		originalCount == other.originalCount && path == other.path && pathShape == other.pathShape &&
+		speedProfile == other.speedProfile && sampleRate == other.sampleRate && moveDuration == other.moveDuration &&
+		color == other.color && tolerance == other.tolerance && regionSize == other.regionSize && timeout == other.timeout &&
+		image == other.image && searchSize == other.searchSize && text == other.text &&
+		keyDelayMin == other.keyDelayMin && keyDelayMax == other.keyDelayMax && button == other.button && scroll == other.scroll &&
+		expression == other.expression;
+}
+
+bool Action::readFromSettings(QSettings& settings)
+{
+	name = settings.value("Name").toString();
+	type = typeFromString(settings.value("Type").toString());
+	originalPosition = settings.value("OriginalPosition").toPoint();
+	originalCount = settings.value("OriginalCount").toInt();
+	delayMin = settings.value("DelayMin").toInt();
+	delayMax = settings.value("DelayMax").toInt();
+	duration = settings.value("Duration").toInt();
+
+	if (type == Type::Move || type == Type::Drag)
+	{
+		path = pathFromString(settings.value("Path").toString());
+		pathShape = settings.value("PathShape").toString() == "bezier" ? PathShape::Bezier : PathShape::Polyline;
+		speedProfile = settings.value("SpeedProfile").toString() == "constant" ? SpeedProfile::Constant : SpeedProfile::EaseInOut;
+		sampleRate = settings.value("SampleRate", 125).toInt();
+		moveDuration = settings.value("MoveDuration", 500).toInt();
+	}
+
+	if (type == Type::WaitPixel)
+	{
+		color = QColor(settings.value("Color").toString()).rgb();
+		regionSize = settings.value("RegionSize", 1).toInt();
+	}
+
+	if (type == Type::FindImage)
+	{
+		// PNG encoded in base64
+		image = QImage::fromData(QByteArray::fromBase64(settings.value("Image").toByteArray()), "PNG");
+		searchSize = settings.value("SearchSize").toSize();
+	}
+
+	if (type == Type::WaitPixel || type == Type::FindImage)
+	{
+		tolerance = settings.value("Tolerance", 8).toInt();
+		timeout = settings.value("Timeout", 10000).toInt();
+	}
+
+	if (type == Type::KeyPress || type == Type::KeyRelease)
+	{
+		text = settings.value("Key").toString();
+	}
+
+	if (type == Type::Jump || type == Type::Loop || type == Type::Call)
+	{
+		text = settings.value("Target").toString();
+	}
+
+	if (type == Type::Text)
+	{
+		text = settings.value("Text").toString();
+		keyDelayMin = settings.value("KeyDelayMin").toInt();
+		keyDelayMax = settings.value("KeyDelayMax").toInt();
+	}
+
+	if (type == Type::Click || type == Type::Drag || type == Type::FindImage)
+	{
+		button = buttonFromString(settings.value("Button").toString());
+	}
+
+	if (type == Type::Scroll)
+	{
+		scroll = settings.value("Scroll").toPoint();
+	}
+
+	expression = settings.value("Expression").toString();
+
+	return true;
+}
+
+bool Action::writeToSettings(QSettings& settings) const
+{
+	settings.setValue("Name", name);
+	settings.setValue("Type", typeToString(type));
+	settings.setValue("OriginalPosition", originalPosition);
+	settings.setValue("OriginalCount", originalCount);
+	settings.setValue("DelayMin", delayMin);
+	settings.setValue("DelayMax", delayMax);
+	settings.setValue("Duration", duration);
+
+	if (type == Type::Move || type == Type::Drag)
+	{
+		settings.setValue("Path", pathToString(path));
+		settings.setValue("PathShape", pathShape == PathShape::Bezier ? "bezier" : "polyline");
+		settings.setValue("SpeedProfile", speedProfile == SpeedProfile::Constant ? "constant" : "easeinout");
+		settings.setValue("SampleRate", sampleRate);
+		settings.setValue("MoveDuration", moveDuration);
+	}
+
+	if (type == Type::WaitPixel)
+	{
+		settings.setValue("Color", QColor(color).name());
+		settings.setValue("RegionSize", regionSize);
+	}
+
+	if (type == Type::FindImage)
+	{
+		QByteArray data;
+		QBuffer buffer(&data);
+		buffer.open(QIODevice::WriteOnly);
+		image.save(&buffer, "PNG");
+
+		settings.setValue("Image", data.toBase64());
+		settings.setValue("SearchSize", searchSize);
+	}
+
+	if (type == Type::WaitPixel || type == Type::FindImage)
+	{
+		settings.setValue("Tolerance", tolerance);
+		settings.setValue("Timeout", timeout);
+	}
+
+	if (type == Type::KeyPress || type == Type::KeyRelease)
+	{
+		settings.setValue("Key", text);
+	}
+
+	if (type == Type::Jump || type == Type::Loop || type == Type::Call)
+	{
+		settings.setValue("Target", text);
+	}
+
+	if (type == Type::Text)
+	{
+		settings.setValue("Text", text);
+		settings.setValue("KeyDelayMin", keyDelayMin);
+		settings.setValue("KeyDelayMax", keyDelayMax);
+	}
+
+	if (type == Type::Click || type == Type::Drag || type == Type::FindImage)
+	{
+		settings.setValue("Button", buttonToString(button));
+	}
+
+	if (type == Type::Scroll)
+	{
+		settings.setValue("Scroll", scroll);
+	}
+
+	if (!expression.isEmpty()) settings.setValue("Expression", expression);
+
+	return true;
+}
+
+QDataStream& operator << (QDataStream& stream, const Action &action)
+{
+	stream << action.name << action.originalPosition << action.delayMin << action.delayMax << action.duration << action.type << action.originalCount;
+	stream << action.path << (quint8)action.pathShape << (quint8)action.speedProfile << action.sampleRate << action.moveDuration;
+	stream << (quint32)action.color << action.tolerance << action.regionSize << action.timeout;
+	stream << action.image << action.searchSize;
+	stream << action.text << action.keyDelayMin << action.keyDelayMax;
+	stream << (quint8)action.button << action.scroll;
+	stream << action.expression;
+
+	return stream;
+}
+
+QDataStream& operator >> (QDataStream& stream, Action& action)
+{
+	stream >> action.name >> action.originalPosition;
+	
+	if (stream.device()->property("version").toInt() >= 5)
+	{
+		stream >> action.delayMin;
+	}
+	else
+	{
+		action.delayMin = 30;
+	}
+
+	stream >> action.delayMax;
+
+	if (stream.device()->property("version").toInt() >= 2)
+	{
+		stream >> action.duration;
+	}
+	else
+	{
+		action.duration = 0;
+	}
+
+	// all actions were clicks before version 4
+	if (stream.device()->property("version").toInt() >= 4)
+	{
+		stream >> action.type >> action.originalCount;
+	}
+	else
+	{
+		action.type = Action::Type::Click;
+		action.originalCount = 0;
+	}
+
+	if (stream.device()->property("version").toInt() >= 7)
+	{
+		quint8 pathShape, speedProfile;
+
+		stream >> action.path >> pathShape >> speedProfile >> action.sampleRate >> action.moveDuration;
+
+		action.pathShape = (Action::PathShape)pathShape;
+		action.speedProfile = (Action::SpeedProfile)speedProfile;
+	}
+
+	if (stream.device()->property("version").toInt() >= 8)
+	{
+		quint32 color;
+
+		stream >> color >> action.tolerance >> action.regionSize >> action.timeout;
+
+		action.color = color;
+	}
+
+	if (stream.device()->property("version").toInt() >= 9)
+	{
+		stream >> action.image >> action.searchSize;
+	}
+
+	if (stream.device()->property("version").toInt() >= 10)
+	{
+		stream >> action.text >> action.keyDelayMin >> action.keyDelayMax;
+	}
+
+	if (stream.device()->property("version").toInt() >= 11)
+	{
+		quint8 button;
+
+		stream >> button >> action.scroll;
+
+		action.button = (Action::Button)button;
+	}
+
+	if (stream.device()->property("version").toInt() >= 13)
+	{
+		stream >> action.expression;
+	}
+
+	// copy original position
+	action.lastPosition = action.originalPosition;
+
+	// copy original count
+	action.lastCount = action.originalCount;
+
+	return stream;
+}
+
+QDataStream& operator << (QDataStream& stream, const Action::Type& type)
+{
+	return stream << typeToInt(type);
+}
+
+QDataStream& operator >> (QDataStream& stream, Action::Type& type)
+{
+	int tmp;
+	stream >> tmp;
+	type = typeFromInt(tmp);
+
+	return stream;
+}
@@ -1,66 +1,158 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#ifndef ACTION_H
-#define ACTION_H
-
-struct Action
-{
-	enum class Type
-	{
-		None,
-		Click,
-		Repeat
-	};
-
-	Action() :type(Type::None), delayMin(0), delayMax(0), duration(0), originalCount(0), lastCount(0)
-	{
-	}
-
-	QString name;
-	Type type;
-	QPoint originalPosition;
-	int delayMin;
-	int delayMax;
-	QPoint lastPosition;
-	int duration;
-	int originalCount;
-	int lastCount;
-
-	QString toString() const;
-
-	static Action fromString(const QString& str);
-
-	bool readFromSettings(QSettings& settings);
-	bool writeToSettings(QSettings& settings) const;
-};
-
-QString typeToString(Action::Type type);
-Action::Type typeFromString(const QString &type);
-
-int typeToInt(Action::Type type);
-Action::Type typeFromInt(int type);
-
-QDataStream& operator << (QDataStream& stream, const Action& action);
-QDataStream& operator >> (QDataStream& stream, Action& action);
-
-QDataStream& operator << (QDataStream& stream, const Action::Type& type);
-QDataStream& operator >> (QDataStream& stream, Action::Type& type);
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ACTION_H
+#define ACTION_H
+
+struct Action
+{
+	enum class Type
+	{
+		None,
+		Click,
+		Repeat,
+		Move,
+		Drag,
+		WaitPixel,
+		FindImage,
+		KeyPress,
+		KeyRelease,
+		Text,
+		Scroll,
+		Jump,
+		Loop,
+		Call,
+		Return
+	};
+
+	// mouse button used by Click, Drag and FindImage
+	enum class Button
+	{
+		Left,
+		Middle,
+		Right,
+		Back,
+		Forward
+	};
+
+	// how path points are joined
+	enum class PathShape
+	{
+		Polyline,
+		Bezier
+	};
+
+	// how cursor speed changes along the path
+	enum class SpeedProfile
+	{
+		Constant,
+		EaseInOut
+	};
+
+	Action() :type(Type::None), delayMin(0), delayMax(0), duration(0), originalCount(0), lastCount(0),
+		pathShape(PathShape::Polyline), speedProfile(SpeedProfile::EaseInOut), sampleRate(125), moveDuration(500),
+		color(0xff000000), tolerance(8), regionSize(1), timeout(10000), keyDelayMin(0), keyDelayMax(0),
+		button(Button::Left)
+	{
+	}
+
+	QString name;
+	Type type;
+	QPoint originalPosition;
+	int delayMin;
+	int delayMax;
+	QPoint lastPosition;
+	int duration;
+	int originalCount;
+	int lastCount;
+
+	// points after original position, only used by Move and Drag
+	QVector<QPoint> path;
+	PathShape pathShape;
+	SpeedProfile speedProfile;
+
+	// cursor positions per second
+	int sampleRate;
+
+	// in ms
+	int moveDuration;
+
+	// used by WaitPixel, wait until all pixels of the square centered on original position have this color
+	QRgb color;
+
+	// maximum difference for each component, used by WaitPixel and FindImage
+	int tolerance;
+
+	// width and height of the square in pixels
+	int regionSize;
+
+	// in ms, 0 to wait forever, used by WaitPixel and FindImage
+	int timeout;
+
+	// only used by FindImage, search image in region starting at original position and click on its center
+	QImage image;
+
+	// whole screen if empty
+	QSize searchSize;
+
+	// key name for KeyPress and KeyRelease ("Return", "F1", "Shift", etc...), characters to type for Text
+	// or name of the target action for Jump, Loop and Call
+	QString text;
+
+	// in ms, random delay between 2 typed characters, all characters are sent at once if 0
+	int keyDelayMin;
+	int keyDelayMax;
+
+	Button button;
+
+	// horizontal and vertical wheel steps for Scroll, positive to the right and down
+	QPoint scroll;
+
+	// assignments of delay, x and y evaluated before each execution, see Expression
+	QString expression;
+
+	QString toString() const;
+
+	static Action fromString(const QString& str);
+
+	// only compare serialized fields
+	bool operator == (const Action& other) const;
+	bool operator != (const Action& other) const { return !(*this == other); }
+
+	bool readFromSettings(QSettings& settings);
+	bool writeToSettings(QSettings& settings) const;
+};
+
+QString typeToString(Action::Type type);
+Action::Type typeFromString(const QString &type);
+
+int typeToInt(Action::Type type);
+Action::Type typeFromInt(int type);
+
+// "x1,y1 x2,y2 ..."
+QString pathToString(const QVector<QPoint>& path);
+QVector<QPoint> pathFromString(const QString& str);
+
+QDataStream& operator << (QDataStream& stream, const Action& action);
+QDataStream& operator >> (QDataStream& stream, Action& action);
+
+QDataStream& operator << (QDataStream& stream, const Action::Type& type);
+QDataStream& operator >> (QDataStream& stream, Action::Type& type);
+
+#endif
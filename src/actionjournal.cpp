@@ -0,0 +1,233 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "actionjournal.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+struct SJournalHeader
+{
+	union
+	{
+		char str[5];
+		quint32 num;
+	};
+};
+
+static SJournalHeader s_journalHeader = { "ACFJ" };
+
+// version 1:
+// - initial version
+
+static quint32 s_journalVersion = 1;
+
+static void setStreamVersion(QDataStream& stream)
+{
+#if (QT_VERSION < QT_VERSION_CHECK(5, 6, 0))
+	stream.setVersion(QDataStream::Qt_5_4);
+#else
+	stream.setVersion(QDataStream::Qt_5_6);
+#endif
+}
+
+static quint16 checksum(const QByteArray& data)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+	return qChecksum(data);
+#else
+	return qChecksum(data.constData(), data.size());
+#endif
+}
+
+static void getSnapshotStamp(const QString& snapshot, qint64& size, qint64& modified)
+{
+	QFileInfo info(snapshot);
+
+	size = info.size();
+	modified = info.lastModified().toMSecsSinceEpoch();
+}
+
+// actionVersion is the version used to serialize actions in the journal
+static bool readHeader(QDataStream& stream, const QString& snapshot, quint32& actionVersion)
+{
+	quint32 header = 0, journalVersion = 0;
+	qint64 size = 0, modified = 0;
+
+	actionVersion = 0;
+
+	stream >> header >> journalVersion >> actionVersion >> size >> modified;
+
+	if (stream.status() != QDataStream::Ok) return false;
+
+	if (header != s_journalHeader.num || journalVersion != s_journalVersion) return false;
+
+	// snapshot has been modified since journal creation
+	qint64 snapshotSize, snapshotModified;
+	getSnapshotStamp(snapshot, snapshotSize, snapshotModified);
+
+	return size == snapshotSize && modified == snapshotModified;
+}
+
+QString ActionJournal::getFilename(const QString& snapshot)
+{
+	return snapshot + ".journal";
+}
+
+bool ActionJournal::append(const QString& snapshot, quint32 version, const Records& records)
+{
+	if (records.isEmpty()) return true;
+
+	if (!QFile::exists(snapshot)) return false;
+
+	QFile file(getFilename(snapshot));
+
+	bool create = !file.exists();
+
+	// check if existing journal was created for the same snapshot
+	if (!create)
+	{
+		if (!file.open(QIODevice::ReadOnly)) return false;
+
+		QDataStream stream(&file);
+
+		quint32 actionVersion;
+		bool valid = readHeader(stream, snapshot, actionVersion);
+
+		file.close();
+
+		// records can't be serialized with different versions in the same journal
+		if (!valid || actionVersion != version) return false;
+	}
+
+	if (!file.open(create ? QIODevice::WriteOnly | QIODevice::Truncate : QIODevice::WriteOnly | QIODevice::Append)) return false;
+
+	QDataStream stream(&file);
+
+	if (create)
+	{
+		qint64 size, modified;
+		getSnapshotStamp(snapshot, size, modified);
+
+		stream << s_journalHeader.num << s_journalVersion << version << size << modified;
+	}
+
+	setStreamVersion(stream);
+
+	for (const Record& record : records)
+	{
+		// each record is prefixed by its size and followed by a checksum to detect interrupted writes
+		QByteArray payload;
+
+		QDataStream recordStream(&payload, QIODevice::WriteOnly);
+		setStreamVersion(recordStream);
+
+		recordStream << record;
+
+		stream << payload << checksum(payload);
+	}
+
+	file.flush();
+
+	return stream.status() == QDataStream::Ok;
+}
+
+bool ActionJournal::read(const QString& snapshot, quint32 maximumVersion, Records& records, quint32& version)
+{
+	records.clear();
+
+	version = maximumVersion;
+
+	QFile file(getFilename(snapshot));
+
+	// no changes since last snapshot
+	if (!file.exists()) return true;
+
+	if (!file.open(QIODevice::ReadOnly)) return false;
+
+	QDataStream stream(&file);
+
+	if (!readHeader(stream, snapshot, version)) return false;
+
+	// actions were serialized with a newer version of kClicker
+	if (version > maximumVersion) return false;
+
+	setStreamVersion(stream);
+
+	while (!stream.atEnd())
+	{
+		QByteArray payload;
+		quint16 payloadChecksum = 0;
+
+		stream >> payload >> payloadChecksum;
+
+		// last record was only partially written, ignore it
+		if (stream.status() != QDataStream::Ok || payloadChecksum != checksum(payload)) return false;
+
+		QDataStream recordStream(payload);
+		setStreamVersion(recordStream);
+
+		// define version for serialized actions
+		recordStream.device()->setProperty("version", version);
+
+		Record record;
+		recordStream >> record;
+
+		if (recordStream.status() != QDataStream::Ok) return false;
+
+		records << record;
+	}
+
+	return true;
+}
+
+bool ActionJournal::remove(const QString& snapshot)
+{
+	QString filename = getFilename(snapshot);
+
+	return !QFile::exists(filename) || QFile::remove(filename);
+}
+
+qint64 ActionJournal::size(const QString& snapshot)
+{
+	return QFileInfo(getFilename(snapshot)).size();
+}
+
+QDataStream& operator << (QDataStream& stream, const ActionJournal::Record& record)
+{
+	stream << (quint8)record.operation << (qint32)record.row << (qint32)record.count << record.actions << record.offset << record.text;
+
+	return stream;
+}
+
+QDataStream& operator >> (QDataStream& stream, ActionJournal::Record& record)
+{
+	quint8 operation;
+	qint32 row, count;
+
+	stream >> operation >> row >> count >> record.actions >> record.offset >> record.text;
+
+	record.operation = (ActionJournal::Record::Operation)operation;
+	record.row = row;
+	record.count = count;
+
+	return stream;
+}
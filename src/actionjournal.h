@@ -0,0 +1,74 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ACTIONJOURNAL_H
+#define ACTIONJOURNAL_H
+
+#include "action.h"
+
+// Append-only list of changes applied to a script since its last full save.
+// The journal is stored next to the .acf file and is only valid for the
+// snapshot it was created for (same size and modification date).
+class ActionJournal
+{
+public:
+	struct Record
+	{
+		enum class Operation
+		{
+			SetAction = 1,
+			InsertActions,
+			RemoveActions,
+			MoveSpots,
+			SetWindowTitle,
+			SetName
+		};
+
+		Record() :operation(Operation::SetAction), row(0), count(0)
+		{
+		}
+
+		Operation operation;
+		int row;
+		int count;
+		QList<Action> actions;
+		QPoint offset;
+		QString text;
+	};
+
+	typedef QList<Record> Records;
+
+	static QString getFilename(const QString& snapshot);
+
+	// append records to the journal of snapshot, create it if needed
+	static bool append(const QString& snapshot, quint32 version, const Records& records);
+
+	// read all complete records, return false if journal is outdated or damaged
+	// version is set to the version used to serialize actions, records from older versions are converted
+	static bool read(const QString& snapshot, quint32 maximumVersion, Records& records, quint32& version);
+
+	static bool remove(const QString& snapshot);
+
+	static qint64 size(const QString& snapshot);
+};
+
+QDataStream& operator << (QDataStream& stream, const ActionJournal::Record& record);
+QDataStream& operator >> (QDataStream& stream, ActionJournal::Record& record);
+
+#endif
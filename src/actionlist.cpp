@@ -0,0 +1,623 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "actionlist.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// maximum number of actions in a leaf
+static const int s_leafCapacity = 64;
+
+// maximum number of children in a branch
+static const int s_branchCapacity = 32;
+
+// above this number of actions, inserting or removing rebuilds the whole tree
+static const int s_bulkThreshold = 1024;
+
+typedef QExplicitlySharedDataPointer<ActionNode> ActionNodePtr;
+
+struct ActionNode : public QSharedData
+{
+	ActionNode() :size(0)
+	{
+	}
+
+	bool isLeaf() const { return children.isEmpty(); }
+	int count() const { return isLeaf() ? actions.size() : children.size(); }
+
+	// number of actions in this node and all its children
+	int size;
+
+	// only used by leaves
+	QVector<Action> actions;
+
+	// only used by branches
+	QVector<ActionNodePtr> children;
+};
+
+// return index of child containing action at position i and update i to be relative to this child
+static int findChild(const ActionNode* node, int& i)
+{
+	int last = node->children.size() - 1;
+
+	for (int c = 0; c < last; ++c)
+	{
+		int size = node->children[c]->size;
+
+		if (i < size) return c;
+
+		i -= size;
+	}
+
+	return last;
+}
+
+// same as findChild but i can be equal to the size of the child
+static int findChildToInsert(const ActionNode* node, int& i)
+{
+	int last = node->children.size() - 1;
+
+	for (int c = 0; c < last; ++c)
+	{
+		int size = node->children[c]->size;
+
+		if (i <= size) return c;
+
+		i -= size;
+	}
+
+	return last;
+}
+
+static ActionNode* detachChild(ActionNode* node, int c)
+{
+	ActionNodePtr& child = node->children[c];
+	child.detach();
+
+	return child.data();
+}
+
+static ActionNodePtr splitNode(ActionNode* node)
+{
+	ActionNodePtr sibling(new ActionNode());
+
+	if (node->isLeaf())
+	{
+		int half = node->actions.size() / 2;
+
+		sibling->actions = node->actions.mid(half);
+		node->actions.resize(half);
+
+		sibling->size = sibling->actions.size();
+	}
+	else
+	{
+		int half = node->children.size() / 2;
+
+		sibling->children = node->children.mid(half);
+		node->children.resize(half);
+
+		for (const ActionNodePtr& child : sibling->children) sibling->size += child->size;
+	}
+
+	node->size -= sibling->size;
+
+	return sibling;
+}
+
+// return the new sibling if node has been split
+static ActionNodePtr insertInto(ActionNode* node, int i, const Action& action)
+{
+	++node->size;
+
+	if (node->isLeaf())
+	{
+		node->actions.insert(i, action);
+
+		return node->actions.size() > s_leafCapacity ? splitNode(node) : ActionNodePtr();
+	}
+
+	int c = findChildToInsert(node, i);
+
+	ActionNodePtr sibling = insertInto(detachChild(node, c), i, action);
+
+	if (!sibling) return ActionNodePtr();
+
+	node->children.insert(c + 1, sibling);
+
+	return node->children.size() > s_branchCapacity ? splitNode(node) : ActionNodePtr();
+}
+
+static void mergeChildren(ActionNode* node, int c)
+{
+	ActionNode* left = detachChild(node, c);
+	const ActionNode* right = node->children[c + 1].constData();
+
+	if (left->isLeaf())
+	{
+		left->actions += right->actions;
+	}
+	else
+	{
+		left->children += right->children;
+	}
+
+	left->size += right->size;
+
+	node->children.removeAt(c + 1);
+}
+
+static void removeFrom(ActionNode* node, int i)
+{
+	--node->size;
+
+	if (node->isLeaf())
+	{
+		node->actions.removeAt(i);
+		return;
+	}
+
+	int c = findChild(node, i);
+
+	ActionNode* child = detachChild(node, c);
+
+	removeFrom(child, i);
+
+	if (child->size == 0)
+	{
+		node->children.removeAt(c);
+		return;
+	}
+
+	// merge almost empty nodes with a neighbour to keep the tree compact
+	int capacity = child->isLeaf() ? s_leafCapacity : s_branchCapacity;
+
+	if (child->count() >= capacity / 4) return;
+
+	if (c > 0 && node->children[c - 1]->count() + child->count() <= capacity)
+	{
+		mergeChildren(node, c - 1);
+	}
+	else if (c + 1 < node->children.size() && node->children[c + 1]->count() + child->count() <= capacity)
+	{
+		mergeChildren(node, c);
+	}
+}
+
+// number of levels under node, all leaves are at the same depth
+static int treeHeight(const ActionNode* node)
+{
+	int height = 0;
+
+	while (!node->isLeaf())
+	{
+		node = node->children.front().constData();
+		++height;
+	}
+
+	return height;
+}
+
+// remove roots with only one child
+static ActionNodePtr trimRoot(ActionNodePtr node)
+{
+	while (node && !node->isLeaf() && node->children.size() == 1)
+	{
+		ActionNodePtr child = node->children.front();
+		node = child;
+	}
+
+	return node;
+}
+
+// split tree before action i, nodes which don't contain i are shared with both parts
+static void splitTree(const ActionNodePtr& node, int i, ActionNodePtr& left, ActionNodePtr& right)
+{
+	if (!node || i <= 0)
+	{
+		left.reset();
+		right = node;
+		return;
+	}
+
+	if (i >= node->size)
+	{
+		left = node;
+		right.reset();
+		return;
+	}
+
+	left = ActionNodePtr(new ActionNode());
+	right = ActionNodePtr(new ActionNode());
+
+	if (node->isLeaf())
+	{
+		left->actions = node->actions.mid(0, i);
+		right->actions = node->actions.mid(i);
+
+		left->size = left->actions.size();
+		right->size = right->actions.size();
+		return;
+	}
+
+	int c = findChild(node.constData(), i);
+
+	ActionNodePtr childLeft, childRight;
+	splitTree(node->children[c], i, childLeft, childRight);
+
+	left->children = node->children.mid(0, c);
+	if (childLeft) left->children << childLeft;
+
+	if (childRight) right->children << childRight;
+	right->children += node->children.mid(c + 1);
+
+	for (const ActionNodePtr& child : left->children) left->size += child->size;
+	for (const ActionNodePtr& child : right->children) right->size += child->size;
+}
+
+// add tree as first or last descendant of node at the right level, return the new sibling if node has been split
+static ActionNodePtr attachTree(ActionNode* node, int height, const ActionNodePtr& tree, int treeHeight, bool atEnd)
+{
+	node->size += tree->size;
+
+	int c = atEnd ? node->children.size() - 1 : 0;
+
+	if (height == treeHeight + 1)
+	{
+		node->children.insert(atEnd ? node->children.size() : 0, tree);
+	}
+	else
+	{
+		ActionNodePtr sibling = attachTree(detachChild(node, c), height - 1, tree, treeHeight, atEnd);
+
+		if (!sibling) return ActionNodePtr();
+
+		node->children.insert(c + 1, sibling);
+	}
+
+	return node->children.size() > s_branchCapacity ? splitNode(node) : ActionNodePtr();
+}
+
+// concatenate 2 trees, only nodes on the joined edges are copied
+static ActionNodePtr joinTrees(const ActionNodePtr& left, const ActionNodePtr& right)
+{
+	if (!left) return right;
+	if (!right) return left;
+
+	int leftHeight = treeHeight(left.constData());
+	int rightHeight = treeHeight(right.constData());
+
+	ActionNodePtr root;
+	ActionNodePtr sibling;
+
+	if (leftHeight == rightHeight)
+	{
+		// avoid small leaves
+		if (left->isLeaf() && left->size + right->size <= s_leafCapacity)
+		{
+			root = ActionNodePtr(new ActionNode());
+			root->actions = left->actions + right->actions;
+			root->size = root->actions.size();
+
+			return root;
+		}
+
+		root = left;
+		sibling = right;
+	}
+	else if (leftHeight > rightHeight)
+	{
+		root = left;
+		root.detach();
+
+		sibling = attachTree(root.data(), leftHeight, right, rightHeight, true);
+	}
+	else
+	{
+		root = right;
+		root.detach();
+
+		sibling = attachTree(root.data(), rightHeight, left, leftHeight, false);
+	}
+
+	if (!sibling) return root;
+
+	// tree is one level deeper
+	ActionNodePtr parent(new ActionNode());
+	parent->children << root << sibling;
+	parent->size = root->size + sibling->size;
+
+	return parent;
+}
+
+static void appendLeaves(const ActionNode* node, QList<Action>& actions)
+{
+	if (node->isLeaf())
+	{
+		for (const Action& action : node->actions) actions << action;
+	}
+	else
+	{
+		for (const ActionNodePtr& child : node->children) appendLeaves(child.constData(), actions);
+	}
+}
+
+static qint64 nodeMemoryUsage(const ActionNode* node, QSet<const void*>& nodes)
+{
+	// if a node is shared, all its children are shared too
+	if (nodes.contains(node)) return 0;
+
+	nodes.insert(node);
+
+	qint64 res = sizeof(ActionNode) + node->actions.capacity() * sizeof(Action) + node->children.capacity() * sizeof(ActionNodePtr);
+
+	for (const ActionNodePtr& child : node->children) res += nodeMemoryUsage(child.constData(), nodes);
+
+	return res;
+}
+
+ActionList::ActionList()
+{
+}
+
+ActionList::ActionList(const ActionList& other) :m_root(other.m_root)
+{
+}
+
+ActionList::~ActionList()
+{
+}
+
+ActionList& ActionList::operator = (const ActionList& other)
+{
+	m_root = other.m_root;
+
+	return *this;
+}
+
+int ActionList::size() const
+{
+	return m_root ? m_root->size : 0;
+}
+
+const Action& ActionList::at(int i) const
+{
+	Q_ASSERT(i >= 0 && i < size());
+
+	const ActionNode* node = m_root.constData();
+
+	while (!node->isLeaf())
+	{
+		node = node->children[findChild(node, i)].constData();
+	}
+
+	return node->actions[i];
+}
+
+Action& ActionList::operator[](int i)
+{
+	Q_ASSERT(i >= 0 && i < size());
+
+	m_root.detach();
+
+	ActionNode* node = m_root.data();
+
+	while (!node->isLeaf())
+	{
+		node = detachChild(node, findChild(node, i));
+	}
+
+	return node->actions[i];
+}
+
+void ActionList::insert(int i, const Action& action)
+{
+	Q_ASSERT(i >= 0 && i <= size());
+
+	if (!m_root) m_root = ActionNodePtr(new ActionNode());
+
+	m_root.detach();
+
+	ActionNodePtr sibling = insertInto(m_root.data(), i, action);
+
+	if (sibling)
+	{
+		// tree is one level deeper
+		ActionNodePtr root(new ActionNode());
+		root->children << m_root << sibling;
+		root->size = m_root->size + sibling->size;
+
+		m_root = root;
+	}
+}
+
+void ActionList::insert(int i, const QList<Action>& actions)
+{
+	Q_ASSERT(i >= 0 && i <= size());
+
+	if (actions.size() > s_bulkThreshold)
+	{
+		// faster to build a tree with new actions and join it between both parts
+		ActionNodePtr left, right;
+		splitTree(m_root, i, left, right);
+
+		m_root = joinTrees(joinTrees(trimRoot(left), fromList(actions).m_root), trimRoot(right));
+		return;
+	}
+
+	for (const Action& action : actions)
+	{
+		insert(i++, action);
+	}
+}
+
+void ActionList::removeAt(int i)
+{
+	Q_ASSERT(i >= 0 && i < size());
+
+	m_root.detach();
+
+	removeFrom(m_root.data(), i);
+
+	// remove useless levels
+	while (m_root->children.size() == 1)
+	{
+		ActionNodePtr child = m_root->children.at(0);
+		m_root = child;
+	}
+
+	if (m_root->size == 0) m_root.reset();
+}
+
+void ActionList::remove(int i, int count)
+{
+	Q_ASSERT(i >= 0 && count >= 0 && i + count <= size());
+
+	if (count > s_bulkThreshold)
+	{
+		// faster to split the tree around removed actions and join both remaining parts
+		ActionNodePtr left, rest, removed, right;
+		splitTree(m_root, i, left, rest);
+		splitTree(rest, count, removed, right);
+
+		m_root = joinTrees(trimRoot(left), trimRoot(right));
+		return;
+	}
+
+	for (int j = 0; j < count; ++j)
+	{
+		removeAt(i);
+	}
+}
+
+void ActionList::clear()
+{
+	m_root.reset();
+}
+
+QList<Action> ActionList::mid(int pos, int count) const
+{
+	int last = count < 0 ? size() : qMin(size(), pos + count);
+
+	QList<Action> actions;
+	actions.reserve(qMax(0, last - pos));
+
+	if (pos >= last) return actions;
+
+	// only copy leaves containing the range
+	ActionNodePtr left, rest, range, right;
+	splitTree(m_root, pos, left, rest);
+	splitTree(rest, last - pos, range, right);
+
+	if (range) appendLeaves(range.constData(), actions);
+
+	return actions;
+}
+
+QList<Action> ActionList::toList() const
+{
+	return mid(0);
+}
+
+ActionList ActionList::fromList(const QList<Action>& actions)
+{
+	ActionList list;
+
+	if (actions.isEmpty()) return list;
+
+	// fill leaves at 3/4 of their capacity to allow insertions without splitting
+	const int leafSize = s_leafCapacity * 3 / 4;
+	const int branchSize = s_branchCapacity * 3 / 4;
+
+	QVector<ActionNodePtr> level;
+
+	for (int i = 0; i < actions.size(); i += leafSize)
+	{
+		ActionNodePtr leaf(new ActionNode());
+
+		int last = qMin(actions.size(), i + leafSize);
+
+		leaf->actions.reserve(last - i);
+
+		for (int j = i; j < last; ++j) leaf->actions << actions[j];
+
+		leaf->size = leaf->actions.size();
+
+		level << leaf;
+	}
+
+	// build branches until there is only one root
+	while (level.size() > 1)
+	{
+		QVector<ActionNodePtr> parents;
+
+		for (int i = 0; i < level.size(); i += branchSize)
+		{
+			ActionNodePtr branch(new ActionNode());
+			branch->children = level.mid(i, branchSize);
+
+			for (const ActionNodePtr& child : branch->children) branch->size += child->size;
+
+			parents << branch;
+		}
+
+		level = parents;
+	}
+
+	list.m_root = level.front();
+
+	return list;
+}
+
+qint64 ActionList::memoryUsage(QSet<const void*>& nodes) const
+{
+	return m_root ? nodeMemoryUsage(m_root.constData(), nodes) : 0;
+}
+
+QDataStream& operator << (QDataStream& stream, const ActionList& actions)
+{
+	// same format as QList
+	stream << actions.toList();
+
+	return stream;
+}
+
+QDataStream& operator >> (QDataStream& stream, ActionList& actions)
+{
+	quint32 count;
+	stream >> count;
+
+	QList<Action> list;
+	list.reserve(count);
+
+	for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+	{
+		Action action;
+		stream >> action;
+
+		list << action;
+	}
+
+	actions = ActionList::fromList(list);
+
+	return stream;
+}
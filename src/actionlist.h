@@ -0,0 +1,91 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ACTIONLIST_H
+#define ACTIONLIST_H
+
+#include "action.h"
+
+struct ActionNode;
+
+// List of actions stored in a tree of implicitly shared chunks.
+// Copying a list is O(1) and modifying an action of a copy only duplicates
+// the chunks on the path to this action.
+class ActionList
+{
+public:
+	ActionList();
+	ActionList(const ActionList& other);
+	~ActionList();
+
+	ActionList& operator = (const ActionList& other);
+
+	int size() const;
+	bool isEmpty() const { return size() == 0; }
+
+	const Action& at(int i) const;
+	const Action& operator[](int i) const { return at(i); }
+
+	// detach the chunks containing this action
+	Action& operator[](int i);
+
+	void insert(int i, const Action& action);
+	void insert(int i, const QList<Action>& actions);
+	void append(const Action& action) { insert(size(), action); }
+	void push_back(const Action& action) { append(action); }
+
+	void removeAt(int i);
+	void remove(int i, int count);
+	void clear();
+
+	QList<Action> mid(int pos, int count = -1) const;
+	QList<Action> toList() const;
+
+	static ActionList fromList(const QList<Action>& actions);
+
+	// return memory used by chunks not already in nodes and add them to it
+	qint64 memoryUsage(QSet<const void*>& nodes) const;
+
+	class const_iterator
+	{
+	public:
+		const_iterator(const ActionList* list, int i) :m_list(list), m_i(i) {}
+
+		const Action& operator*() const { return m_list->at(m_i); }
+		const_iterator& operator++() { ++m_i; return *this; }
+		bool operator != (const const_iterator& other) const { return m_i != other.m_i; }
+
+	private:
+		const ActionList* m_list;
+		int m_i;
+	};
+
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, size()); }
+
+	ActionList& operator << (const Action& action) { append(action); return *this; }
+
+private:
+	QExplicitlySharedDataPointer<ActionNode> m_root;
+};
+
+QDataStream& operator << (QDataStream& stream, const ActionList& actions);
+QDataStream& operator >> (QDataStream& stream, ActionList& actions);
+
+#endif
@@ -1,529 +1,1062 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "actionmodel.h"
-
-struct SMagicHeader
-{
-	union
-	{
-		char str[5];
-		quint32 num;
-	};
-};
-
-const static QString s_actionHeader("action=");
-const static QString s_windowHeader("window=");
-
-SMagicHeader s_header = { "ACFK" };
-
-// version 1:
-// - initial version
-//
-// version 2:
-// - added duration to a click
-//
-// version 3:
-// - added window name
-//
-// version 4:
-// - added action types
-// - added Repeat action type
-//
-// version 5:
-// - renamed delay to delayMax
-// - added delayMin
-//
-// version 6:
-// - added name
-
-quint32 s_version = 6;
-
-ActionModel::ActionModel(QObject* parent) : QAbstractTableModel(parent), m_startFrom(0)
-{
-}
-
-ActionModel::~ActionModel()
-{
-}
-
-int ActionModel::rowCount(const QModelIndex &/* parent */) const
-{
-	return m_actions.size();
-}
-
-int ActionModel::columnCount(const QModelIndex &/* parent */) const
-{
-	// name, type, original position, delay, duration, last position, count
-	return ActionColumnLast;
-}
-
-QVariant ActionModel::data(const QModelIndex &index, int role) const
-{
-	if (!index.isValid()) return QVariant();
-
-	if (role == Qt::DisplayRole || role == Qt::EditRole)
-	{
-		switch (index.column())
-		{
-			case ActionColumnName: return m_actions[index.row()].name;
-			case ActionColumnType: return typeToInt(m_actions[index.row()].type);
-			case ActionColumnOriginalPosition: return m_actions[index.row()].originalPosition;
-			case ActionColumnDelayMin: return m_actions[index.row()].delayMin;
-			case ActionColumnDelayMax: return m_actions[index.row()].delayMax;
-			case ActionColumnDuration: return m_actions[index.row()].duration;
-			case ActionColumnLastPosition: return m_actions[index.row()].lastPosition;
-			case ActionColumnOriginalCount: return m_actions[index.row()].originalCount;
-			case ActionColumnLastCount: return m_actions[index.row()].lastCount;
-		}
-	}
-	
-	return QVariant();
-}
-
-bool ActionModel::setData(const QModelIndex &index, const QVariant &value, int role)
-{
-	if (role == Qt::DisplayRole || role == Qt::EditRole)
-	{
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
-		if (!checkIndex(index)) return false;
-#endif
-
-		// save value
-		switch (index.column())
-		{
-			case ActionColumnName: m_actions[index.row()].name = value.toString(); break;
-			case ActionColumnType: m_actions[index.row()].type = typeFromInt(value.toInt()); break;
-			case ActionColumnOriginalPosition: m_actions[index.row()].originalPosition = value.toPoint(); break;
-			case ActionColumnDelayMin: m_actions[index.row()].delayMin = value.toInt(); break;
-			case ActionColumnDelayMax: m_actions[index.row()].delayMax = value.toInt(); break;
-			case ActionColumnDuration: m_actions[index.row()].duration = value.toInt(); break;
-			case ActionColumnLastPosition: m_actions[index.row()].lastPosition = value.toPoint(); break;
-			case ActionColumnOriginalCount: m_actions[index.row()].originalCount = value.toInt(); break;
-			case ActionColumnLastCount: m_actions[index.row()].lastCount = value.toInt(); break;
-			default: return false;
-		}
-
-		return true;
-
-	}
-
-	return false;
-}
-
-Qt::ItemFlags ActionModel::flags(const QModelIndex &index) const
-{
-	Qt::ItemFlags flags = Qt::ItemIsDropEnabled | QAbstractTableModel::flags(index);
-
-	if (index.isValid()) flags |= Qt::ItemIsEditable | Qt::ItemIsDragEnabled;
-
-	return flags;
-}
-
-bool ActionModel::insertRows(int position, int rows, const QModelIndex& /* parent */)
-{
-	bool insertAtTheEnd = position == -1;
-
-	if (position == -1) position = rowCount();
-
-	beginInsertRows(QModelIndex(), position, position + rows - 1);
-
-	for (int row = 0; row < rows; ++row)
-	{
-		Action action;
-		action.name = tr("Action #%1").arg(rowCount() + 1);
-		action.type = Action::Type::Click;
-		action.originalPosition = QPoint(0, 0);
-		action.delayMin = 30;
-		action.delayMax = 150;
-		action.lastPosition = QPoint(0, 0);
-
-		if (insertAtTheEnd)
-		{
-			m_actions.push_back(action);
-		}
-		else
-		{
-			m_actions.insert(row + position, action);
-		}
-	}
-
-	endInsertRows();
-	return true;
-}
-
-bool ActionModel::removeRows(int position, int rows, const QModelIndex& /* parent */)
-{
-	beginRemoveRows(QModelIndex(), position, position + rows - 1);
-
-	for (int row = 0; row < rows; ++row)
-	{
-		m_actions.removeAt(position + row);
-
-		if (m_startFrom == row)
-		{
-			m_startFrom = 0;
-		}
-	}
-
-	endRemoveRows();
-	return true;
-}
-
-Qt::DropActions ActionModel::supportedDropActions() const
-{
-	return Qt::MoveAction | Qt::CopyAction;
-}
-
-QStringList ActionModel::mimeTypes() const
-{
-	QStringList types;
-	types << "application/x-autoclicker";
-	return types;
-}
-
-QMimeData* ActionModel::mimeData(const QModelIndexList &indexes) const
-{
-	QMimeData* mimeData = new QMimeData();
-	QByteArray encodedData;
-
-	QDataStream stream(&encodedData, QIODevice::WriteOnly);
-
-	foreach(const QModelIndex &index, indexes)
-	{
-		if (index.isValid())
-		{
-			stream << m_actions[index.row()];
-		}
-	}
-
-	mimeData->setData("application/x-autoclicker", encodedData);
-
-	return mimeData;
-}
-
-bool ActionModel::dropMimeData(const QMimeData* data, Qt::DropAction actionType, int row, int /* column */, const QModelIndex& /* parent */)
-{
-	if (!data->hasFormat("application/x-autoclicker")) return false;
-
-	if (actionType == Qt::IgnoreAction) return true;
-
-	bool insertAtTheEnd = row == -1;
-
-	if (row == -1) row = rowCount();
-
-	QByteArray encodedData = data->data("application/x-autoclicker");
-	QDataStream stream(&encodedData, QIODevice::ReadOnly);
-
-	Action action;
-
-	stream >> action;
-
-	beginInsertRows(QModelIndex(), row, row);
-
-	if (insertAtTheEnd)
-	{
-		m_actions.push_back(action);
-	}
-	else
-	{
-		m_actions.insert(row, action);
-	}
-
-	endInsertRows();
-
-	return true;
-}
-
-Action ActionModel::getAction(int row) const
-{
-	return m_actions[row];
-}
-
-void ActionModel::setAction(int row, const Action& action)
-{
-	m_actions[row] = action;
-
-	emit dataChanged(index(row, 0), index(row, ActionColumnLast-1), { Qt::DisplayRole, Qt::EditRole });
-}
-
-QString ActionModel::getWindowTitle() const
-{
-	return m_windowTitle;
-}
-
-void ActionModel::setWindowTitle(const QString& title)
-{
-	m_windowTitle = title;
-}
-
-QString ActionModel::getName() const
-{
-	return m_name;
-}
-
-void ActionModel::setName(const QString& name)
-{
-	m_name = name;
-}
-
-int ActionModel::getStartFrom() const
-{
-	return m_startFrom;
-}
-
-void ActionModel::setStartFrom(int startFrom)
-{
-	m_startFrom = startFrom;
-}
-
-void ActionModel::reset()
-{
-	m_windowTitle.clear();
-	m_filename.clear();
-	m_name.clear();
-
-	m_startFrom = 0;
-
-	beginResetModel();
-
-	m_actions.clear();
-
-	endResetModel();
-}
-
-void ActionModel::resetCount()
-{
-	for (int i = 0; i < m_actions.size(); ++i)
-	{
-		Action& action = m_actions[i];
-
-		if (action.type == Action::Type::Repeat)
-		{
-			// reset repeat count
-			action.lastCount = action.originalCount;
-		}
-	}
-}
-
-bool ActionModel::load(const QString& filename)
-{
-	if (filename.isEmpty()) return false;
-
-	QFile file(filename);
-
-	if (!file.open(QIODevice::ReadOnly)) return false;
-
-	QDataStream stream(&file);
-
-	// Read and check the header
-	SMagicHeader header;
-
-	stream >> header.num;
-
-	if (header.num != s_header.num) return false;
-
-	// Read the version
-	quint32 version;
-	stream >> version;
-
-	if (version > s_version) return false;
-
-	// define version for items and other serialized objects
-	stream.device()->setProperty("version", version);
-
-#if (QT_VERSION < QT_VERSION_CHECK(5, 6, 0))
-	stream.setVersion(QDataStream::Qt_5_4);
-#else
-	stream.setVersion(QDataStream::Qt_5_6);
-#endif
-
-	beginResetModel();
-
-	// actions
-	stream >> m_actions;
-
-	endResetModel();
-
-	// deserialize window name
-	if (version >= 3)
-	{
-		stream >> m_windowTitle;
-	}
-	else
-	{
-		// clear any previous window name
-		m_windowTitle.clear();
-	}
-
-	// deserialize name
-	if (version >= 6)
-	{
-		stream >> m_name;
-	}
-	else
-	{
-		// use filename
-		m_name = QFileInfo(filename).baseName();
-	}
-
-	m_filename = filename;
-
-	return true;
-}
-
-bool ActionModel::save(const QString& filename)
-{
-	if (filename.isEmpty()) return false;
-
-	QFile file(filename);
-
-	if (!file.open(QIODevice::WriteOnly)) return false;
-
-	QDataStream stream(&file);
-
-	// Write a header with a "magic number" and a version
-	stream << s_header.num;
-	stream << s_version;
-
-#if (QT_VERSION < QT_VERSION_CHECK(5, 6, 0))
-	stream.setVersion(QDataStream::Qt_5_4);
-#else
-	stream.setVersion(QDataStream::Qt_5_6);
-#endif
-
-	stream << m_actions;
-
-	// serialize window title
-	stream << m_windowTitle;
-
-	// serialize name
-	if (m_name.isEmpty())
-	{
-		// use filename
-		stream << QFileInfo(filename).baseName();
-	}
-	else
-	{
-		stream << m_name;
-	}
-
-	m_filename = filename;
-
-	return true;
-}
-
-bool ActionModel::loadText(const QString& filename)
-{
-	if (filename.isEmpty()) return false;
-
-	QSettings settings(filename, QSettings::IniFormat);
-
-	settings.beginGroup("Common");
-
-	m_name = settings.value("Name").toString();
-	m_windowTitle = settings.value("WindowTitle").toString();
-
-	int actionsCount = settings.value("ActionsCount").toInt();
-
-	settings.endGroup();
-
-	beginResetModel();
-
-	m_actions.clear();
-
-	for(int i = 0; i < actionsCount; ++i)
-	{
-		settings.beginGroup(QString("Action_%1").arg(i));
-
-		Action action;
-		action.readFromSettings(settings);
-
-		settings.endGroup();
-
-		m_actions << action;
-	}
-
-	endResetModel();
-
-	return true;
-}
-
-bool ActionModel::saveText(const QString& filename)
-{
-	if (filename.isEmpty()) return false;
-
-	QSettings settings(filename, QSettings::IniFormat);
-
-	if (!settings.isWritable()) return false;
-
-	settings.beginGroup("Common");
-
-	settings.setValue("Name", m_name);
-	settings.setValue("WindowTitle", m_windowTitle);
-
-	settings.setValue("ActionsCount", m_actions.size());
-
-	settings.endGroup();
-
-	int actionCount = 0;
-
-	for (const Action &action: m_actions)
-	{
-		settings.beginGroup(QString("Action_%1").arg(actionCount++));
-
-		action.writeToSettings(settings);
-
-		settings.endGroup();
-	}
-
-	return true;
-}
-
-bool ActionModel::updateSpotsPosition(const QPoint& offset)
-{
-	for (int i = 0; i < m_actions.size(); ++i)
-	{
-		Action &action = m_actions[i];
-
-		action.originalPosition -= offset;
-		action.lastPosition = action.originalPosition;
-	}
-
-	return true;
-}
-
-QString ActionModel::getFilename() const
-{
-	return m_filename;
-}
-
-ActionModel* ActionModel::clone(QObject *parent) const
-{
-	ActionModel* res = new ActionModel(parent);
-
-	res->m_actions = m_actions;
-	res->m_name = m_name;
-	res->m_windowTitle = m_windowTitle;
-	res->m_filename = m_filename;
-	res->m_startFrom = m_startFrom;
-
-	return res;
-}
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "actionmodel.h"
+
+struct SMagicHeader
+{
+	union
+	{
+		char str[5];
+		quint32 num;
+	};
+};
+
+const static QString s_actionHeader("action=");
+const static QString s_windowHeader("window=");
+
+SMagicHeader s_header = { "ACFK" };
+
+// version 1:
+// - initial version
+//
+// version 2:
+// - added duration to a click
+//
+// version 3:
+// - added window name
+//
+// version 4:
+// - added action types
+// - added Repeat action type
+//
+// version 5:
+// - renamed delay to delayMax
+// - added delayMin
+//
+// version 6:
+// - added name
+//
+// version 7:
+// - added Move and Drag action types
+// - added path, path shape, speed profile, sample rate and move duration
+//
+// version 8:
+// - added WaitPixel action type
+// - added color, tolerance, region size and timeout
+//
+// version 9:
+// - added FindImage action type
+// - added image and search size
+//
+// version 10:
+// - added KeyPress, KeyRelease and Text action types
+// - added text and key delays
+//
+// version 11:
+// - added Scroll action type
+// - added button and scroll
+//
+// version 12:
+// - added Jump, Loop, Call and Return action types
+//
+// version 13:
+// - added expression
+
+quint32 s_version = 13;
+
+// journal is merged into the .acf file when it's larger than half the .acf file and this size
+static const qint64 s_minimumJournalSizeToCompact = 64 * 1024;
+
+static void setStreamVersion(QDataStream& stream)
+{
+#if (QT_VERSION < QT_VERSION_CHECK(5, 6, 0))
+	stream.setVersion(QDataStream::Qt_5_4);
+#else
+	stream.setVersion(QDataStream::Qt_5_6);
+#endif
+}
+
+static bool writeSnapshot(const QString& filename, const ActionList& actions, const QString& windowTitle, const QString& name)
+{
+	// write in a temporary file to never leave a truncated file
+	QSaveFile file(filename);
+
+	if (!file.open(QIODevice::WriteOnly)) return false;
+
+	QDataStream stream(&file);
+
+	// Write a header with a "magic number" and a version
+	stream << s_header.num;
+	stream << s_version;
+
+	setStreamVersion(stream);
+
+	stream << actions;
+
+	// serialize window title
+	stream << windowTitle;
+
+	// serialize name
+	stream << name;
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+
+	return file.commit();
+}
+
+static bool isPersistentColumn(int column)
+{
+	switch (column)
+	{
+		case ActionColumnLastPosition:
+		case ActionColumnLastCount:
+		return false;
+
+		default:
+		break;
+	}
+
+	return true;
+}
+
+ActionModel::ActionModel(QObject* parent) : QAbstractTableModel(parent), m_startFrom(0), m_journalValid(false), m_undoDepth(0)
+{
+}
+
+ActionModel::~ActionModel()
+{
+	m_compaction.waitForFinished();
+}
+
+int ActionModel::rowCount(const QModelIndex &/* parent */) const
+{
+	return m_actions.size();
+}
+
+int ActionModel::columnCount(const QModelIndex &/* parent */) const
+{
+	// name, type, original position, delay, duration, last position, count, path
+	return ActionColumnLast;
+}
+
+QVariant ActionModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid()) return QVariant();
+
+	if (role == Qt::DisplayRole || role == Qt::EditRole)
+	{
+		switch (index.column())
+		{
+			case ActionColumnName: return m_actions[index.row()].name;
+			case ActionColumnType: return typeToInt(m_actions[index.row()].type);
+			case ActionColumnOriginalPosition: return m_actions[index.row()].originalPosition;
+			case ActionColumnDelayMin: return m_actions[index.row()].delayMin;
+			case ActionColumnDelayMax: return m_actions[index.row()].delayMax;
+			case ActionColumnDuration: return m_actions[index.row()].duration;
+			case ActionColumnLastPosition: return m_actions[index.row()].lastPosition;
+			case ActionColumnOriginalCount: return m_actions[index.row()].originalCount;
+			case ActionColumnLastCount: return m_actions[index.row()].lastCount;
+			case ActionColumnPath: return pathToString(m_actions[index.row()].path);
+			case ActionColumnPathShape: return (int)m_actions[index.row()].pathShape;
+			case ActionColumnSpeedProfile: return (int)m_actions[index.row()].speedProfile;
+			case ActionColumnSampleRate: return m_actions[index.row()].sampleRate;
+			case ActionColumnMoveDuration: return m_actions[index.row()].moveDuration;
+			case ActionColumnColor: return m_actions[index.row()].color;
+			case ActionColumnTolerance: return m_actions[index.row()].tolerance;
+			case ActionColumnRegionSize: return m_actions[index.row()].regionSize;
+			case ActionColumnTimeout: return m_actions[index.row()].timeout;
+			case ActionColumnImage: return m_actions[index.row()].image;
+			case ActionColumnSearchWidth: return m_actions[index.row()].searchSize.width();
+			case ActionColumnSearchHeight: return m_actions[index.row()].searchSize.height();
+			case ActionColumnText: return m_actions[index.row()].text;
+			case ActionColumnKeyDelayMin: return m_actions[index.row()].keyDelayMin;
+			case ActionColumnKeyDelayMax: return m_actions[index.row()].keyDelayMax;
+			case ActionColumnButton: return (int)m_actions[index.row()].button;
+			case ActionColumnScrollX: return m_actions[index.row()].scroll.x();
+			case ActionColumnScrollY: return m_actions[index.row()].scroll.y();
+			case ActionColumnExpression: return m_actions[index.row()].expression;
+		}
+	}
+	
+	return QVariant();
+}
+
+bool ActionModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+	if (role == Qt::DisplayRole || role == Qt::EditRole)
+	{
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
+		if (!checkIndex(index)) return false;
+#endif
+
+		// nothing to do
+		if (data(index, role) == value) return true;
+
+		if (isPersistentColumn(index.column())) pushUndoState();
+
+		// save value
+		switch (index.column())
+		{
+			case ActionColumnName: m_actions[index.row()].name = value.toString(); break;
+			case ActionColumnType: m_actions[index.row()].type = typeFromInt(value.toInt()); break;
+			case ActionColumnOriginalPosition: m_actions[index.row()].originalPosition = value.toPoint(); break;
+			case ActionColumnDelayMin: m_actions[index.row()].delayMin = value.toInt(); break;
+			case ActionColumnDelayMax: m_actions[index.row()].delayMax = value.toInt(); break;
+			case ActionColumnDuration: m_actions[index.row()].duration = value.toInt(); break;
+			case ActionColumnLastPosition: m_actions[index.row()].lastPosition = value.toPoint(); break;
+			case ActionColumnOriginalCount: m_actions[index.row()].originalCount = value.toInt(); break;
+			case ActionColumnLastCount: m_actions[index.row()].lastCount = value.toInt(); break;
+			case ActionColumnPath: m_actions[index.row()].path = pathFromString(value.toString()); break;
+			case ActionColumnPathShape: m_actions[index.row()].pathShape = (Action::PathShape)value.toInt(); break;
+			case ActionColumnSpeedProfile: m_actions[index.row()].speedProfile = (Action::SpeedProfile)value.toInt(); break;
+			case ActionColumnSampleRate: m_actions[index.row()].sampleRate = value.toInt(); break;
+			case ActionColumnMoveDuration: m_actions[index.row()].moveDuration = value.toInt(); break;
+			case ActionColumnColor: m_actions[index.row()].color = value.toUInt(); break;
+			case ActionColumnTolerance: m_actions[index.row()].tolerance = value.toInt(); break;
+			case ActionColumnRegionSize: m_actions[index.row()].regionSize = value.toInt(); break;
+			case ActionColumnTimeout: m_actions[index.row()].timeout = value.toInt(); break;
+			case ActionColumnImage: m_actions[index.row()].image = value.value<QImage>(); break;
+			case ActionColumnSearchWidth: m_actions[index.row()].searchSize.setWidth(value.toInt()); break;
+			case ActionColumnSearchHeight: m_actions[index.row()].searchSize.setHeight(value.toInt()); break;
+			case ActionColumnText: m_actions[index.row()].text = value.toString(); break;
+			case ActionColumnKeyDelayMin: m_actions[index.row()].keyDelayMin = value.toInt(); break;
+			case ActionColumnKeyDelayMax: m_actions[index.row()].keyDelayMax = value.toInt(); break;
+			case ActionColumnButton: m_actions[index.row()].button = (Action::Button)value.toInt(); break;
+			case ActionColumnScrollX: m_actions[index.row()].scroll.setX(value.toInt()); break;
+			case ActionColumnScrollY: m_actions[index.row()].scroll.setY(value.toInt()); break;
+			case ActionColumnExpression: m_actions[index.row()].expression = value.toString(); break;
+			default: return false;
+		}
+
+		if (isPersistentColumn(index.column()))
+		{
+			ActionJournal::Record record;
+			record.operation = ActionJournal::Record::Operation::SetAction;
+			record.row = index.row();
+			record.actions << m_actions[index.row()];
+
+			recordChange(record);
+		}
+
+		return true;
+
+	}
+
+	return false;
+}
+
+Qt::ItemFlags ActionModel::flags(const QModelIndex &index) const
+{
+	Qt::ItemFlags flags = Qt::ItemIsDropEnabled | QAbstractTableModel::flags(index);
+
+	if (index.isValid()) flags |= Qt::ItemIsEditable | Qt::ItemIsDragEnabled;
+
+	return flags;
+}
+
+bool ActionModel::insertRows(int position, int rows, const QModelIndex& /* parent */)
+{
+	if (position == -1) position = rowCount();
+
+	QList<Action> actions;
+	actions.reserve(rows);
+
+	for (int row = 0; row < rows; ++row)
+	{
+		Action action;
+		action.name = tr("Action #%1").arg(rowCount() + row + 1);
+		action.type = Action::Type::Click;
+		action.originalPosition = QPoint(0, 0);
+		action.delayMin = 30;
+		action.delayMax = 150;
+		action.lastPosition = QPoint(0, 0);
+
+		actions << action;
+	}
+
+	pushUndoState();
+
+	insertActions(position, actions);
+
+	return true;
+}
+
+bool ActionModel::removeRows(int position, int rows, const QModelIndex& /* parent */)
+{
+	if (rows <= 0) return false;
+
+	pushUndoState();
+
+	removeActions(position, rows);
+
+	return true;
+}
+
+bool ActionModel::removeSelectedRows(const QList<int>& rows)
+{
+	if (rows.isEmpty()) return false;
+
+	QList<int> sortedRows = rows;
+	std::sort(sortedRows.begin(), sortedRows.end());
+
+	pushUndoState();
+
+	removeSortedRows(sortedRows);
+
+	return true;
+}
+
+int ActionModel::moveSelectedRows(const QList<int>& rows, int destination)
+{
+	if (rows.isEmpty()) return -1;
+
+	if (destination < 0 || destination > rowCount()) destination = rowCount();
+
+	QList<int> sortedRows = rows;
+	std::sort(sortedRows.begin(), sortedRows.end());
+	sortedRows.erase(std::unique(sortedRows.begin(), sortedRows.end()), sortedRows.end());
+
+	QList<Action> actions;
+	actions.reserve(sortedRows.size());
+
+	// removed rows before destination shift it
+	int first = destination;
+
+	for (int row : sortedRows)
+	{
+		actions << m_actions.at(row);
+
+		if (row < destination) --first;
+	}
+
+	pushUndoState();
+
+	removeSortedRows(sortedRows);
+	insertActions(first, actions);
+
+	return first;
+}
+
+void ActionModel::removeSortedRows(const QList<int>& sortedRows)
+{
+	// remove contiguous ranges from the end, so previous rows indices don't change
+	int i = sortedRows.size() - 1;
+
+	while (i >= 0)
+	{
+		int last = sortedRows[i];
+		int first = last;
+
+		while (i > 0 && sortedRows[i - 1] >= first - 1)
+		{
+			--i;
+			first = qMin(first, sortedRows[i]);
+		}
+
+		removeActions(first, last - first + 1);
+
+		--i;
+	}
+}
+
+void ActionModel::appendActions(const QList<Action>& actions)
+{
+	if (actions.isEmpty()) return;
+
+	pushUndoState();
+
+	insertActions(rowCount(), actions);
+}
+
+void ActionModel::insertActions(int position, const QList<Action>& actions)
+{
+	if (actions.isEmpty()) return;
+
+	beginInsertRows(QModelIndex(), position, position + actions.size() - 1);
+
+	m_actions.insert(position, actions);
+
+	// keep the same starting action
+	if (m_startFrom >= position && m_startFrom > 0) m_startFrom += actions.size();
+
+	ActionJournal::Record record;
+	record.operation = ActionJournal::Record::Operation::InsertActions;
+	record.row = position;
+	record.actions = actions;
+
+	recordChange(record);
+
+	endInsertRows();
+}
+
+void ActionModel::removeActions(int position, int rows)
+{
+	beginRemoveRows(QModelIndex(), position, position + rows - 1);
+
+	m_actions.remove(position, rows);
+
+	if (m_startFrom >= position + rows)
+	{
+		// keep the same starting action
+		m_startFrom -= rows;
+	}
+	else if (m_startFrom >= position)
+	{
+		// starting action has been removed
+		m_startFrom = 0;
+	}
+
+	ActionJournal::Record record;
+	record.operation = ActionJournal::Record::Operation::RemoveActions;
+	record.row = position;
+	record.count = rows;
+
+	recordChange(record);
+
+	endRemoveRows();
+}
+
+Qt::DropActions ActionModel::supportedDropActions() const
+{
+	return Qt::MoveAction | Qt::CopyAction;
+}
+
+QStringList ActionModel::mimeTypes() const
+{
+	QStringList types;
+	types << "application/x-autoclicker";
+	return types;
+}
+
+QMimeData* ActionModel::mimeData(const QModelIndexList &indexes) const
+{
+	QVector<int> rows;
+	rows.reserve(indexes.size());
+
+	for (const QModelIndex& index : indexes)
+	{
+		if (index.isValid()) rows << index.row();
+	}
+
+	// keep original order whatever the selection order
+	std::sort(rows.begin(), rows.end());
+
+	// an index is returned for each selected column
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+	QList<Action> actions;
+	actions.reserve(rows.size());
+
+	for (int row : rows)
+	{
+		actions << m_actions.at(row);
+	}
+
+	QByteArray encodedData;
+
+	QDataStream stream(&encodedData, QIODevice::WriteOnly);
+	setStreamVersion(stream);
+
+	stream << s_version << actions;
+
+	QMimeData* mimeData = new QMimeData();
+	mimeData->setData("application/x-autoclicker", encodedData);
+
+	return mimeData;
+}
+
+bool ActionModel::dropMimeData(const QMimeData* data, Qt::DropAction actionType, int row, int /* column */, const QModelIndex& /* parent */)
+{
+	if (!data->hasFormat("application/x-autoclicker")) return false;
+
+	if (actionType == Qt::IgnoreAction) return true;
+
+	if (row == -1) row = rowCount();
+
+	QByteArray encodedData = data->data("application/x-autoclicker");
+	QDataStream stream(&encodedData, QIODevice::ReadOnly);
+	setStreamVersion(stream);
+
+	quint32 version = 0;
+	stream >> version;
+
+	// data come from another version of kClicker
+	if (version > s_version) return false;
+
+	// define version for serialized actions
+	stream.device()->setProperty("version", version);
+
+	QList<Action> actions;
+	stream >> actions;
+
+	if (stream.status() != QDataStream::Ok || actions.isEmpty()) return false;
+
+	pushUndoState();
+
+	insertActions(row, actions);
+
+	return true;
+}
+
+Action ActionModel::getAction(int row) const
+{
+	return m_actions[row];
+}
+
+void ActionModel::setAction(int row, const Action& action)
+{
+	// only changes of serialized fields need to be saved
+	if (m_actions.at(row) != action)
+	{
+		pushUndoState();
+
+		ActionJournal::Record record;
+		record.operation = ActionJournal::Record::Operation::SetAction;
+		record.row = row;
+		record.actions << action;
+
+		recordChange(record);
+	}
+
+	m_actions[row] = action;
+
+	emit dataChanged(index(row, 0), index(row, ActionColumnLast-1), { Qt::DisplayRole, Qt::EditRole });
+}
+
+QString ActionModel::getWindowTitle() const
+{
+	return m_windowTitle;
+}
+
+void ActionModel::setWindowTitle(const QString& title)
+{
+	if (m_windowTitle == title) return;
+
+	// window title is restored by undo, so changing it is a modification like others
+	pushUndoState();
+
+	changeWindowTitle(title);
+}
+
+void ActionModel::changeWindowTitle(const QString& title)
+{
+	m_windowTitle = title;
+
+	ActionJournal::Record record;
+	record.operation = ActionJournal::Record::Operation::SetWindowTitle;
+	record.text = title;
+
+	recordChange(record);
+}
+
+QString ActionModel::getName() const
+{
+	return m_name;
+}
+
+void ActionModel::setName(const QString& name)
+{
+	if (m_name == name) return;
+
+	m_name = name;
+
+	ActionJournal::Record record;
+	record.operation = ActionJournal::Record::Operation::SetName;
+	record.text = name;
+
+	recordChange(record);
+}
+
+int ActionModel::getStartFrom() const
+{
+	return m_startFrom;
+}
+
+void ActionModel::setStartFrom(int startFrom)
+{
+	m_startFrom = startFrom;
+}
+
+void ActionModel::reset()
+{
+	m_windowTitle.clear();
+	m_filename.clear();
+	m_name.clear();
+
+	m_startFrom = 0;
+
+	m_journal.clear();
+	m_journalValid = false;
+
+	beginResetModel();
+
+	m_actions.clear();
+
+	endResetModel();
+}
+
+bool ActionModel::load(const QString& filename)
+{
+	if (filename.isEmpty()) return false;
+
+	QFile file(filename);
+
+	if (!file.open(QIODevice::ReadOnly)) return false;
+
+	QDataStream stream(&file);
+
+	// Read and check the header
+	SMagicHeader header;
+
+	stream >> header.num;
+
+	if (header.num != s_header.num) return false;
+
+	// Read the version
+	quint32 version;
+	stream >> version;
+
+	if (version > s_version) return false;
+
+	// define version for items and other serialized objects
+	stream.device()->setProperty("version", version);
+
+	setStreamVersion(stream);
+
+	beginResetModel();
+
+	// actions
+	stream >> m_actions;
+
+	// deserialize window name
+	if (version >= 3)
+	{
+		stream >> m_windowTitle;
+	}
+	else
+	{
+		// clear any previous window name
+		m_windowTitle.clear();
+	}
+
+	// deserialize name
+	if (version >= 6)
+	{
+		stream >> m_name;
+	}
+	else
+	{
+		// use filename
+		m_name = QFileInfo(filename).baseName();
+	}
+
+	// apply changes saved after the last full save
+	ActionJournal::Records records;
+	quint32 journalVersion;
+	m_journalValid = ActionJournal::read(filename, s_version, records, journalVersion);
+
+	// changes saved by an older version are kept, but new ones can't be appended to the same journal
+	if (journalVersion != s_version) m_journalValid = false;
+
+	for (const ActionJournal::Record& record : records)
+	{
+		applyChange(record);
+	}
+
+	endResetModel();
+
+	m_journal.clear();
+	m_filename = filename;
+
+	return true;
+}
+
+bool ActionModel::save(const QString& filename)
+{
+	if (filename.isEmpty()) return false;
+
+	// previous compaction must be finished before writing again
+	m_compaction.waitForFinished();
+
+	// only append changes if the file has already been saved
+	if (filename == m_filename && m_journalValid && QFile::exists(filename))
+	{
+		if (ActionJournal::append(filename, s_version, m_journal))
+		{
+			m_journal.clear();
+
+			if (ActionJournal::size(filename) > qMax(s_minimumJournalSizeToCompact, QFileInfo(filename).size() / 2))
+			{
+				compact();
+			}
+
+			return true;
+		}
+	}
+
+	// use filename if no name
+	QString name = m_name.isEmpty() ? QFileInfo(filename).baseName() : m_name;
+
+	if (!writeSnapshot(filename, m_actions, m_windowTitle, name)) return false;
+
+	// journal is now obsolete
+	ActionJournal::remove(filename);
+
+	m_journal.clear();
+	m_journalValid = true;
+	m_filename = filename;
+
+	return true;
+}
+
+bool ActionModel::loadText(const QString& filename)
+{
+	if (filename.isEmpty()) return false;
+
+	QSettings settings(filename, QSettings::IniFormat);
+
+	settings.beginGroup("Common");
+
+	m_name = settings.value("Name").toString();
+	m_windowTitle = settings.value("WindowTitle").toString();
+
+	int actionsCount = settings.value("ActionsCount").toInt();
+
+	settings.endGroup();
+
+	m_journal.clear();
+	m_journalValid = false;
+
+	beginResetModel();
+
+	m_actions.clear();
+
+	for(int i = 0; i < actionsCount; ++i)
+	{
+		settings.beginGroup(QString("Action_%1").arg(i));
+
+		Action action;
+		action.readFromSettings(settings);
+
+		settings.endGroup();
+
+		m_actions << action;
+	}
+
+	endResetModel();
+
+	return true;
+}
+
+bool ActionModel::saveText(const QString& filename)
+{
+	if (filename.isEmpty()) return false;
+
+	QSettings settings(filename, QSettings::IniFormat);
+
+	if (!settings.isWritable()) return false;
+
+	settings.beginGroup("Common");
+
+	settings.setValue("Name", m_name);
+	settings.setValue("WindowTitle", m_windowTitle);
+
+	settings.setValue("ActionsCount", m_actions.size());
+
+	settings.endGroup();
+
+	int actionCount = 0;
+
+	for (const Action &action: m_actions)
+	{
+		settings.beginGroup(QString("Action_%1").arg(actionCount++));
+
+		action.writeToSettings(settings);
+
+		settings.endGroup();
+	}
+
+	return true;
+}
+
+quint32 ActionModel::getVersion()
+{
+	return s_version;
+}
+
+bool ActionModel::updateSpotsPosition(const QPoint& offset)
+{
+	pushUndoState();
+
+	moveSpots(offset);
+
+	return true;
+}
+
+void ActionModel::setWindow(const QString& title, const QPoint& offset)
+{
+	pushUndoState();
+
+	moveSpots(offset);
+
+	if (m_windowTitle != title) changeWindowTitle(title);
+}
+
+void ActionModel::moveSpots(const QPoint& offset)
+{
+	for (int i = 0; i < m_actions.size(); ++i)
+	{
+		Action &action = m_actions[i];
+
+		action.originalPosition -= offset;
+		action.lastPosition = action.originalPosition;
+	}
+
+	ActionJournal::Record record;
+	record.operation = ActionJournal::Record::Operation::MoveSpots;
+	record.offset = offset;
+
+	recordChange(record);
+}
+
+QString ActionModel::getFilename() const
+{
+	return m_filename;
+}
+
+ActionModel* ActionModel::clone(QObject *parent) const
+{
+	ActionModel* res = new ActionModel(parent);
+
+	res->m_actions = m_actions;
+	res->m_name = m_name;
+	res->m_windowTitle = m_windowTitle;
+	res->m_filename = m_filename;
+	res->m_startFrom = m_startFrom;
+	res->m_journal = m_journal;
+	res->m_journalValid = m_journalValid;
+
+	return res;
+}
+
+void ActionModel::swap(ActionModel& other)
+{
+	// previous compactions used the old filenames
+	m_compaction.waitForFinished();
+	other.m_compaction.waitForFinished();
+
+	beginResetModel();
+	other.beginResetModel();
+
+	qSwap(m_actions, other.m_actions);
+	qSwap(m_windowTitle, other.m_windowTitle);
+	qSwap(m_filename, other.m_filename);
+	qSwap(m_name, other.m_name);
+	qSwap(m_startFrom, other.m_startFrom);
+	qSwap(m_journal, other.m_journal);
+	qSwap(m_journalValid, other.m_journalValid);
+
+	other.endResetModel();
+	endResetModel();
+}
+
+int ActionModel::getUndoDepth() const
+{
+	return m_undoDepth;
+}
+
+void ActionModel::setUndoDepth(int depth)
+{
+	m_undoDepth = qMax(0, depth);
+
+	// remove oldest levels
+	while (m_undoStates.size() > m_undoDepth) m_undoStates.removeFirst();
+	while (m_redoStates.size() > m_undoDepth) m_redoStates.removeFirst();
+
+	emit undoStackChanged();
+}
+
+int ActionModel::getUndoCount() const
+{
+	return m_undoStates.size();
+}
+
+int ActionModel::getRedoCount() const
+{
+	return m_redoStates.size();
+}
+
+qint64 ActionModel::getUndoMemoryUsage() const
+{
+	QSet<const void*> nodes;
+
+	// chunks used by current actions are not counted
+	m_actions.memoryUsage(nodes);
+
+	qint64 res = 0;
+
+	for (const UndoState& state : m_undoStates) res += state.actions.memoryUsage(nodes);
+	for (const UndoState& state : m_redoStates) res += state.actions.memoryUsage(nodes);
+
+	return res;
+}
+
+void ActionModel::undo()
+{
+	if (m_undoStates.isEmpty()) return;
+
+	restoreUndoState(m_undoStates, m_redoStates);
+}
+
+void ActionModel::redo()
+{
+	if (m_redoStates.isEmpty()) return;
+
+	restoreUndoState(m_redoStates, m_undoStates);
+}
+
+void ActionModel::pushUndoState()
+{
+	if (m_undoDepth == 0) return;
+
+	// only a reference on actions is kept
+	UndoState state;
+	state.actions = m_actions;
+	state.windowTitle = m_windowTitle;
+
+	m_undoStates << state;
+
+	if (m_undoStates.size() > m_undoDepth) m_undoStates.removeFirst();
+
+	// a new modification invalidates redo
+	m_redoStates.clear();
+
+	emit undoStackChanged();
+}
+
+void ActionModel::restoreUndoState(QList<UndoState>& from, QList<UndoState>& to)
+{
+	UndoState state;
+	state.actions = m_actions;
+	state.windowTitle = m_windowTitle;
+
+	to << state;
+
+	state = from.takeLast();
+
+	beginResetModel();
+
+	m_actions = state.actions;
+	m_windowTitle = state.windowTitle;
+
+	if (m_startFrom >= m_actions.size()) m_startFrom = 0;
+
+	endResetModel();
+
+	// journal can't describe this change, the whole script will be saved
+	m_journal.clear();
+	m_journalValid = false;
+
+	emit undoStackChanged();
+}
+
+void ActionModel::recordChange(const ActionJournal::Record& record)
+{
+	// only keep the last change of the same action
+	if (record.operation == ActionJournal::Record::Operation::SetAction && !m_journal.isEmpty())
+	{
+		ActionJournal::Record& last = m_journal.last();
+
+		if (last.operation == ActionJournal::Record::Operation::SetAction && last.row == record.row)
+		{
+			last = record;
+			return;
+		}
+	}
+
+	m_journal << record;
+}
+
+void ActionModel::applyChange(const ActionJournal::Record& record)
+{
+	switch (record.operation)
+	{
+		case ActionJournal::Record::Operation::SetAction:
+		if (record.row >= 0 && record.row < m_actions.size() && !record.actions.isEmpty())
+		{
+			m_actions[record.row] = record.actions.front();
+		}
+		break;
+
+		case ActionJournal::Record::Operation::InsertActions:
+		m_actions.insert(qBound(0, record.row, m_actions.size()), record.actions);
+		break;
+
+		case ActionJournal::Record::Operation::RemoveActions:
+		if (record.row >= 0 && record.row < m_actions.size())
+		{
+			m_actions.remove(record.row, qBound(0, record.count, m_actions.size() - record.row));
+		}
+		break;
+
+		case ActionJournal::Record::Operation::MoveSpots:
+		for (int i = 0; i < m_actions.size(); ++i)
+		{
+			Action& action = m_actions[i];
+
+			action.originalPosition -= record.offset;
+			action.lastPosition = action.originalPosition;
+		}
+		break;
+
+		case ActionJournal::Record::Operation::SetWindowTitle:
+		m_windowTitle = record.text;
+		break;
+
+		case ActionJournal::Record::Operation::SetName:
+		m_name = record.text;
+		break;
+
+		default:
+		break;
+	}
+}
+
+void ActionModel::compact()
+{
+	// copies are cheap because data are implicitly shared
+	QString filename = m_filename;
+	ActionList actions = m_actions;
+	QString windowTitle = m_windowTitle;
+	QString name = m_name.isEmpty() ? QFileInfo(filename).baseName() : m_name;
+
+	// write a new .acf file containing all changes in background
+	m_compaction = QtConcurrent::run([filename, actions, windowTitle, name]()
+	{
+		if (!writeSnapshot(filename, actions, windowTitle, name)) return false;
+
+		return ActionJournal::remove(filename);
+	});
+}
@@ -1,97 +1,190 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#ifndef ACTIONMODEL_H
-#define ACTIONMODEL_H
-
-#include "action.h"
-
-#include <QAbstractTableModel>
-
-enum ActionColumn
-{
-	ActionColumnName,
-	ActionColumnType,
-	ActionColumnOriginalPosition,
-	ActionColumnDelayMin,
-	ActionColumnDelayMax,
-	ActionColumnDuration,
-	ActionColumnLastPosition,
-	ActionColumnOriginalCount,
-	ActionColumnLastCount,
-	ActionColumnLast
-};
-
-class ActionModel : public QAbstractTableModel
-{
-	Q_OBJECT
-
-public:
-	ActionModel(QObject* parent = nullptr);
-	virtual ~ActionModel();
-
-	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
-	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
-	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
-	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
-	Qt::ItemFlags flags(const QModelIndex& index) const override;
-	bool insertRows(int position, int rows, const QModelIndex& index = QModelIndex()) override;
-	bool removeRows(int position, int rows, const QModelIndex& index = QModelIndex()) override;
-
-	Qt::DropActions supportedDropActions() const override;
-	QStringList mimeTypes() const override;
-	QMimeData* mimeData(const QModelIndexList& indexes) const override;
-	bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
-
-	Action getAction(int row) const;
-	void setAction(int row, const Action& action);
-
-	QString getWindowTitle() const;
-	void setWindowTitle(const QString& name);
-
-	QString getName() const;
-	void setName(const QString& name);
-
-	int getStartFrom() const;
-	void setStartFrom(int startFrom);
-
-	void reset();
-	void resetCount();
-
-	bool load(const QString& filename);
-	bool save(const QString& filename);
-
-	bool loadText(const QString& filename);
-	bool saveText(const QString& filename);
-
-	bool updateSpotsPosition(const QPoint& offset);
-
-	QString getFilename() const;
-
-	ActionModel* clone(QObject* parent = nullptr) const;
-
-private:
-	QList<Action> m_actions;
-	QString m_windowTitle;
-	QString m_filename;
-	QString m_name;
-	int m_startFrom;
-};
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ACTIONMODEL_H
+#define ACTIONMODEL_H
+
+#include "action.h"
+#include "actionjournal.h"
+#include "actionlist.h"
+
+#include <QAbstractTableModel>
+
+enum ActionColumn
+{
+	ActionColumnName,
+	ActionColumnType,
+	ActionColumnOriginalPosition,
+	ActionColumnDelayMin,
+	ActionColumnDelayMax,
+	ActionColumnDuration,
+	ActionColumnLastPosition,
+	ActionColumnOriginalCount,
+	ActionColumnLastCount,
+	ActionColumnPath,
+	ActionColumnPathShape,
+	ActionColumnSpeedProfile,
+	ActionColumnSampleRate,
+	ActionColumnMoveDuration,
+	ActionColumnColor,
+	ActionColumnTolerance,
+	ActionColumnRegionSize,
+	ActionColumnTimeout,
+	ActionColumnImage,
+	ActionColumnSearchWidth,
+	ActionColumnSearchHeight,
+	ActionColumnText,
+	ActionColumnKeyDelayMin,
+	ActionColumnKeyDelayMax,
+	ActionColumnButton,
+	ActionColumnScrollX,
+	ActionColumnScrollY,
+	ActionColumnExpression,
+	ActionColumnLast
+};
+
+class ActionModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	ActionModel(QObject* parent = nullptr);
+	virtual ~ActionModel();
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+	Qt::ItemFlags flags(const QModelIndex& index) const override;
+	bool insertRows(int position, int rows, const QModelIndex& index = QModelIndex()) override;
+	bool removeRows(int position, int rows, const QModelIndex& index = QModelIndex()) override;
+
+	Qt::DropActions supportedDropActions() const override;
+	QStringList mimeTypes() const override;
+	QMimeData* mimeData(const QModelIndexList& indexes) const override;
+	bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
+
+	// remove rows in any order, even if they are not contiguous
+	bool removeSelectedRows(const QList<int>& rows);
+
+	// move rows in any order before destination in one undo level, return the new row of the first moved action
+	int moveSelectedRows(const QList<int>& rows, int destination);
+
+	// append several actions in one undo level
+	void appendActions(const QList<Action>& actions);
+
+	Action getAction(int row) const;
+	void setAction(int row, const Action& action);
+
+	QString getWindowTitle() const;
+	void setWindowTitle(const QString& name);
+
+	QString getName() const;
+	void setName(const QString& name);
+
+	int getStartFrom() const;
+	void setStartFrom(int startFrom);
+
+	void reset();
+
+	bool load(const QString& filename);
+	bool save(const QString& filename);
+
+	bool loadText(const QString& filename);
+	bool saveText(const QString& filename);
+
+	// version of .acf files written by save
+	static quint32 getVersion();
+
+	bool updateSpotsPosition(const QPoint& offset);
+
+	// use another window and move positions relative to it in one undo level
+	void setWindow(const QString& title, const QPoint& offset);
+
+	QString getFilename() const;
+
+	// actions are shared until modified, so cloning is fast
+	ActionModel* clone(QObject* parent = nullptr) const;
+
+	// exchange content with another model
+	void swap(ActionModel& other);
+
+	// maximum number of undo levels, 0 to disable undo
+	int getUndoDepth() const;
+	void setUndoDepth(int depth);
+
+	int getUndoCount() const;
+	int getRedoCount() const;
+
+	// memory used by undo and redo levels in addition to current actions
+	qint64 getUndoMemoryUsage() const;
+
+public slots:
+	void undo();
+	void redo();
+
+signals:
+	void undoStackChanged();
+
+private:
+	struct UndoState
+	{
+		ActionList actions;
+		QString windowTitle;
+	};
+
+	// insert or remove several actions at once without saving undo state
+	void insertActions(int position, const QList<Action>& actions);
+	void removeActions(int position, int rows);
+
+	// remove contiguous ranges of sorted rows
+	void removeSortedRows(const QList<int>& rows);
+
+	// change window title or positions without saving undo state
+	void changeWindowTitle(const QString& title);
+	void moveSpots(const QPoint& offset);
+
+	void pushUndoState();
+	void restoreUndoState(QList<UndoState>& from, QList<UndoState>& to);
+
+	void recordChange(const ActionJournal::Record& record);
+	void applyChange(const ActionJournal::Record& record);
+	void compact();
+
+	ActionList m_actions;
+	QString m_windowTitle;
+	QString m_filename;
+	QString m_name;
+	int m_startFrom;
+
+	// changes not yet written in journal
+	ActionJournal::Records m_journal;
+
+	// false if next save should write the whole file
+	bool m_journalValid;
+
+	QFuture<bool> m_compaction;
+
+	// undo levels only share modified chunks with current actions
+	QList<UndoState> m_undoStates;
+	QList<UndoState> m_redoStates;
+	int m_undoDepth;
+};
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "changedetector.h"
+#include "utils.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// width and height of a tile in pixels
+static const int s_tileSize = 32;
+
+// time between 2 captures doubles from minimum to maximum while nothing changes, so after
+// about 1 s without changes, only 2 captures are done per second and a change is detected
+// at most 500 ms after it happened
+static const int s_minimumInterval = 1;
+static const int s_maximumInterval = 500;
+
+// 4 independent hashes are computed on pixels i, i+1, i+2 and i+3, so SSE2 and scalar versions give the same result
+static void hashRow(const quint32* pixels, int count, quint32 hashes[4])
+{
+	int i = 0;
+
+#ifdef USE_SSE2
+	const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+
+	__m128i h = _mm_loadu_si128((const __m128i*)hashes);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// alpha is undefined on captured images
+		__m128i values = _mm_and_si128(_mm_loadu_si128((const __m128i*)(pixels + i)), rgbMask);
+
+		// h = (h * 33) ^ value
+		h = _mm_xor_si128(_mm_add_epi32(_mm_slli_epi32(h, 5), h), values);
+	}
+
+	_mm_storeu_si128((__m128i*)hashes, h);
+#endif
+
+	for (; i + 4 <= count; i += 4)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			hashes[j] = (hashes[j] * 33) ^ (pixels[i + j] & 0x00ffffff);
+		}
+	}
+
+	// remaining pixels
+	for (int j = 0; i < count; ++i, ++j)
+	{
+		hashes[j] = (hashes[j] * 33) ^ (pixels[i] & 0x00ffffff);
+	}
+}
+
+static quint32 hashTile(const ScreenImage& image, const QRect& tile)
+{
+	quint32 hashes[4] = { 5381, 5381, 5381, 5381 };
+
+	for (int y = tile.top(); y <= tile.bottom(); ++y)
+	{
+		hashRow((const quint32*)(image.bits + y * image.bytesPerLine) + tile.left(), tile.width(), hashes);
+	}
+
+	return ((hashes[0] * 33 ^ hashes[1]) * 33 ^ hashes[2]) * 33 ^ hashes[3];
+}
+
+static int getTilesPerRow(const QRect& region)
+{
+	return (region.width() + s_tileSize - 1) / s_tileSize;
+}
+
+static QRect getTile(const QRect& region, int index)
+{
+	int tilesPerRow = getTilesPerRow(region);
+
+	QRect tile((index % tilesPerRow) * s_tileSize, (index / tilesPerRow) * s_tileSize, s_tileSize, s_tileSize);
+
+	// relative to region
+	return tile.intersected(QRect(QPoint(0, 0), region.size()));
+}
+
+ChangeDetector::ChangeDetector(const QRect& region) :m_region(region), m_interval(s_minimumInterval), m_damage(nullptr)
+{
+	// no need to capture anything while waiting for notifications
+	if (startDamage()) return;
+
+	// reference to compare with next captures
+	captureTiles(m_hashes);
+}
+
+ChangeDetector::~ChangeDetector()
+{
+	stopDamage();
+}
+
+bool ChangeDetector::waitForChange(int timeout, QRect& changed)
+{
+	changed = QRect();
+
+	if (timeout <= 0) return false;
+
+	if (m_damage) return waitForDamage(timeout, changed);
+
+	return waitForTiles(timeout, changed);
+}
+
+bool ChangeDetector::captureTiles(QVector<quint32>& hashes)
+{
+	ScreenImage image;
+
+	if (!captureWindowRegion(0, m_region, image)) return false;
+
+	m_capturedRegion = QRect(image.pos, QSize(image.width, image.height));
+
+	int count = getTilesPerRow(m_capturedRegion) * ((m_capturedRegion.height() + s_tileSize - 1) / s_tileSize);
+
+	hashes.resize(count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		hashes[i] = hashTile(image, getTile(m_capturedRegion, i));
+	}
+
+	return true;
+}
+
+bool ChangeDetector::waitForTiles(int timeout, QRect& changed)
+{
+	QElapsedTimer clock;
+	clock.start();
+
+	while (clock.elapsed() < timeout)
+	{
+		// don't sleep after timeout
+		QThread::msleep(qMin((qint64)m_interval, timeout - clock.elapsed()));
+
+		QRect previousRegion = m_capturedRegion;
+
+		// capture can fail or not be supported, so try again less and less often
+		if (!captureTiles(m_newHashes))
+		{
+			m_interval = qMin(m_interval * 2, s_maximumInterval);
+			continue;
+		}
+
+		// screen resolution changed
+		if (m_capturedRegion != previousRegion || m_newHashes.size() != m_hashes.size())
+		{
+			m_hashes.swap(m_newHashes);
+
+			changed = m_capturedRegion;
+			m_interval = s_minimumInterval;
+
+			return true;
+		}
+
+		for (int i = 0; i < m_hashes.size(); ++i)
+		{
+			if (m_hashes[i] != m_newHashes[i]) changed |= getTile(m_capturedRegion, i).translated(m_capturedRegion.topLeft());
+		}
+
+		m_hashes.swap(m_newHashes);
+
+		if (!changed.isEmpty())
+		{
+			// other changes will probably follow
+			m_interval = s_minimumInterval;
+
+			return true;
+		}
+
+		m_interval = qMin(m_interval * 2, s_maximumInterval);
+	}
+
+	return false;
+}
@@ -0,0 +1,62 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CHANGEDETECTOR_H
+#define CHANGEDETECTOR_H
+
+struct DamageListener;
+
+// Detect changes in a region of the screen, so visual conditions are only
+// evaluated again when and where pixels changed.
+// It uses DAMAGE extension on X11 if available, else it compares hashes of
+// tiles of successive captures. Captures are less frequent while nothing
+// changes, so a change can be detected up to 500 ms late during long waits.
+class ChangeDetector
+{
+public:
+	// region in absolute coordinates, whole screen if null
+	explicit ChangeDetector(const QRect& region);
+	~ChangeDetector();
+
+	// wait at most timeout ms, return true and the changed part of region if pixels changed
+	bool waitForChange(int timeout, QRect& changed);
+
+	bool isUsingDamage() const { return m_damage != nullptr; }
+
+private:
+	// implemented in changedetector_*.cpp, return false if not supported
+	bool startDamage();
+	void stopDamage();
+	bool waitForDamage(int timeout, QRect& changed);
+
+	bool captureTiles(QVector<quint32>& hashes);
+	bool waitForTiles(int timeout, QRect& changed);
+
+	QRect m_region;
+
+	// only used when comparing tiles
+	QRect m_capturedRegion;
+	QVector<quint32> m_hashes;
+	QVector<quint32> m_newHashes;
+	int m_interval;
+
+	DamageListener* m_damage;
+};
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "changedetector.h"
+
+#ifdef Q_OS_WIN
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+struct DamageListener
+{
+};
+
+bool ChangeDetector::startDamage()
+{
+	// DXGI desktop duplication gives dirty rectangles but requires Direct3D, compare tiles instead
+	return false;
+}
+
+void ChangeDetector::stopDamage()
+{
+}
+
+bool ChangeDetector::waitForDamage(int timeout, QRect& changed)
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "changedetector.h"
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+
+#ifdef HAVE_XDAMAGE
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
+
+#include <poll.h>
+
+#endif
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+#ifdef HAVE_XDAMAGE
+
+struct DamageListener
+{
+	DamageListener() :display(nullptr), eventBase(0), damage(0), parts(0)
+	{
+	}
+
+	// events are read on our own connection to not interfere with Qt
+	Display* display;
+
+	int eventBase;
+
+	Damage damage;
+	XserverRegion parts;
+};
+
+static void closeListener(DamageListener* listener)
+{
+	if (listener->parts) XFixesDestroyRegion(listener->display, listener->parts);
+	if (listener->damage) XDamageDestroy(listener->display, listener->damage);
+	if (listener->display) XCloseDisplay(listener->display);
+
+	delete listener;
+}
+
+bool ChangeDetector::startDamage()
+{
+	DamageListener* listener = new DamageListener();
+
+	listener->display = XOpenDisplay(nullptr);
+
+	int errorBase = 0;
+
+	if (!listener->display || !XDamageQueryExtension(listener->display, &listener->eventBase, &errorBase))
+	{
+		closeListener(listener);
+		return false;
+	}
+
+	Window root = DefaultRootWindow(listener->display);
+
+	if (m_region.isNull())
+	{
+		Screen* screen = DefaultScreenOfDisplay(listener->display);
+
+		m_region = QRect(0, 0, WidthOfScreen(screen), HeightOfScreen(screen));
+	}
+
+	// only notified when damage becomes non-empty, damaged parts are retrieved when subtracting them
+	listener->damage = XDamageCreate(listener->display, root, XDamageReportNonEmpty);
+	listener->parts = XFixesCreateRegion(listener->display, nullptr, 0);
+
+	// changes before this point are already in the reference
+	XSync(listener->display, False);
+
+	m_damage = listener;
+
+	return true;
+}
+
+void ChangeDetector::stopDamage()
+{
+	if (!m_damage) return;
+
+	closeListener(m_damage);
+
+	m_damage = nullptr;
+}
+
+bool ChangeDetector::waitForDamage(int timeout, QRect& changed)
+{
+	Display* display = m_damage->display;
+
+	QElapsedTimer clock;
+	clock.start();
+
+	while (true)
+	{
+		while (XPending(display))
+		{
+			XEvent event;
+			XNextEvent(display, &event);
+
+			if (event.type != m_damage->eventBase + XDamageNotify) continue;
+
+			// reset damage to be notified of next changes
+			XDamageSubtract(display, m_damage->damage, None, m_damage->parts);
+
+			int count = 0;
+			XRectangle* rectangles = XFixesFetchRegion(display, m_damage->parts, &count);
+
+			for (int i = 0; i < count; ++i)
+			{
+				changed |= QRect(rectangles[i].x, rectangles[i].y, rectangles[i].width, rectangles[i].height).intersected(m_region);
+			}
+
+			if (rectangles) XFree(rectangles);
+		}
+
+		if (!changed.isEmpty()) return true;
+
+		int remaining = timeout - clock.elapsed();
+
+		if (remaining <= 0) return false;
+
+		// sleep until the server sends something
+		pollfd fd;
+		fd.fd = ConnectionNumber(display);
+		fd.events = POLLIN;
+		fd.revents = 0;
+
+		if (poll(&fd, 1, remaining) <= 0) return false;
+	}
+}
+
+#else
+
+struct DamageListener
+{
+};
+
+bool ChangeDetector::startDamage()
+{
+	// built without DAMAGE support
+	return false;
+}
+
+void ChangeDetector::stopDamage()
+{
+}
+
+bool ChangeDetector::waitForDamage(int timeout, QRect& changed)
+{
+	return false;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,833 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "clicker.h"
+#include "moc_clicker.cpp"
+#include "actionmodel.h"
+#include "scriptplan.h"
+#include "imagematch.h"
+#include "changedetector.h"
+#include "trace.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// events sent later than this after their deadline are counted as missed, in µs
+static const qint64 s_missedDeadlineThreshold = 1000;
+
+// maximum time to wait for a screen change before checking if user moved the mouse
+static const int s_maximumChangeWait = 200;
+
+// return time to wait for a screen change, 0 if timeout
+static int getChangeWait(const Action& action, const QElapsedTimer& clock)
+{
+	if (action.timeout <= 0) return s_maximumChangeWait;
+
+	return qBound(0, action.timeout - (int)clock.elapsed(), s_maximumChangeWait);
+}
+
+SystemBackend::SystemBackend()
+{
+	m_clock.start();
+}
+
+QString SystemBackend::getName() const
+{
+#if defined(Q_OS_WIN)
+	return "sendinput";
+#elif defined(Q_OS_MAC)
+	return "cgevent";
+#else
+	return "xtest";
+#endif
+}
+
+void SystemBackend::prepare()
+{
+	// open connection to display server without sending anything
+	::sendInputEvents(nullptr, 0);
+
+	// global generator is seeded on first use
+	getRandomGenerator();
+
+	// notified of cursor moves only while running
+	startCursorMonitoring();
+}
+
+void SystemBackend::finish()
+{
+	stopCursorMonitoring();
+}
+
+qint64 SystemBackend::getTime()
+{
+	return m_clock.nsecsElapsed() / 1000;
+}
+
+void SystemBackend::sleep(int ms)
+{
+	QThread::msleep(ms);
+}
+
+void SystemBackend::waitUntil(qint64 deadline)
+{
+	qint64 remaining = deadline - getTime();
+
+	if (remaining > 0) preciseSleep(remaining);
+}
+
+void SystemBackend::sendInputEvents(const InputEvent* events, int count)
+{
+	::sendInputEvents(events, count);
+}
+
+bool SystemBackend::waitForCursorMove(const QPoint& pos, qint64 deadline)
+{
+	qint64 remaining = deadline - getTime();
+
+	if (remaining > 0 && ::waitForCursorMove(pos, (int)((remaining + 999) / 1000))) return true;
+
+	return getCursorPosition() != pos;
+}
+
+QPoint SystemBackend::getCursorPosition()
+{
+	return QCursor::pos();
+}
+
+KeyStroke SystemBackend::getKeyStroke(const QString& name)
+{
+	return keyStrokeFromName(name);
+}
+
+QVector<KeyStroke> SystemBackend::getKeyStrokes(const QString& text)
+{
+	return keyStrokesFromText(text);
+}
+
+QRandomGenerator& SystemBackend::getRandomGenerator()
+{
+	return *QRandomGenerator::global();
+}
+
+bool SystemBackend::findWindow(const QString& title, Window& window)
+{
+	window = getWindowWithTitle(title);
+
+	return window.id != 0;
+}
+
+bool SystemBackend::isSameWindowAtPos(const Window& window, const QPoint& pos)
+{
+	return ::isSameWindowAtPos(window, pos);
+}
+
+ClickerBackend::WaitResult SystemBackend::waitPixel(const Action& action, const QAtomicInt& stop)
+{
+	int size = qMax(1, action.regionSize);
+
+	QRect region(action.originalPosition - QPoint(size / 2, size / 2), QSize(size, size));
+
+	QElapsedTimer clock;
+	clock.start();
+
+	// created before first check to not miss any change
+	ChangeDetector detector(region);
+
+	// moving the mouse stops the clicker, like during delays
+	QPoint cursor = getCursorPosition();
+
+	bool changed = true;
+
+	while (!stop)
+	{
+		if (changed)
+		{
+			ScreenImage image;
+
+			if (captureWindowRegion(0, region, image) && countMatchingPixels(image, action.color, action.tolerance) == image.width * image.height) return WaitResult::Found;
+		}
+
+		int wait = getChangeWait(action, clock);
+
+		if (wait <= 0) return WaitResult::NotFound;
+
+		// pixels can't match if they didn't change
+		QRect changedRegion;
+		changed = detector.waitForChange(wait, changedRegion);
+
+		if (getCursorPosition() != cursor) return WaitResult::CursorMoved;
+	}
+
+	return WaitResult::NotFound;
+}
+
+ClickerBackend::WaitResult SystemBackend::waitImage(const Action& action, const ImageTemplate& imageTemplate, const QAtomicInt& stop, QPoint& pos)
+{
+	if (imageTemplate.isNull()) return WaitResult::NotFound;
+
+	// whole screen if no size
+	QRect region = action.searchSize.isEmpty() ? QRect() : QRect(action.originalPosition, action.searchSize);
+
+	QElapsedTimer clock;
+	clock.start();
+
+	ChangeDetector detector(region);
+
+	// moving the mouse stops the clicker, like during delays
+	QPoint cursor = getCursorPosition();
+
+	QSize size = imageTemplate.size();
+
+	// first search is done in the whole region
+	QRect searchRegion = region;
+
+	while (!stop)
+	{
+		ScreenImage image;
+
+		if (!searchRegion.isEmpty() || region.isNull())
+		{
+			if (captureWindowRegion(0, searchRegion, image))
+			{
+				// now we know the size of the screen
+				if (region.isNull()) region = QRect(image.pos, QSize(image.width, image.height));
+
+				ImageMatch match = findImage(image, imageTemplate);
+
+				if (match.isValid() && match.difference <= action.tolerance)
+				{
+					// click on center of image
+					pos = image.pos + match.pos + QPoint(size.width() / 2, size.height() / 2);
+					return WaitResult::Found;
+				}
+			}
+		}
+
+		int wait = getChangeWait(action, clock);
+
+		if (wait <= 0) return WaitResult::NotFound;
+
+		QRect changed;
+
+		if (detector.waitForChange(wait, changed))
+		{
+			// only positions where the image overlaps a changed tile need to be checked again
+			searchRegion = changed.adjusted(1 - size.width(), 1 - size.height(), size.width() - 1, size.height() - 1).intersected(region);
+		}
+		else
+		{
+			searchRegion = QRect();
+		}
+
+		if (getCursorPosition() != cursor) return WaitResult::CursorMoved;
+	}
+
+	return WaitResult::NotFound;
+}
+
+Clicker::Clicker(ClickerBackend* backend, QObject* parent) :QObject(parent), m_backend(backend), m_timeLimit(0), m_startDelay(0),
+	m_runStartTime(-1), m_startLatency(-1), m_deadline(-1)
+{
+	m_usageClock.start();
+}
+
+Clicker::UsageSample Clicker::getUsageSample() const
+{
+	UsageSample sample;
+	sample.time = m_usageClock.elapsed();
+	sample.clicks = m_metrics.getClicks();
+	sample.usage = getProcessUsage();
+
+	return sample;
+}
+
+QString Clicker::getUsageString() const
+{
+	QMutexLocker locker(&m_usageMutex);
+
+	if (m_runStartUsage.time < 0) return tr("no run yet");
+
+	UsageSample start = m_runStartUsage;
+	UsageSample end = m_runEndUsage.time < 0 ? getUsageSample() : m_runEndUsage;
+
+	locker.unlock();
+
+	qint64 duration = end.time - start.time;
+	qint64 clicks = end.clicks - start.clicks;
+
+	QString wakeups = tr("n/a");
+	QString cpuTime = tr("n/a");
+
+	if (duration > 0 && start.usage.wakeups >= 0) wakeups = QString::number((end.usage.wakeups - start.usage.wakeups) * 1000.0 / duration, 'f', 1);
+	// µs per click are ms per 1000 clicks
+	if (clicks > 0 && start.usage.cpuTime >= 0) cpuTime = QString::number((double)(end.usage.cpuTime - start.usage.cpuTime) / clicks, 'f', 1);
+
+	return tr("%1 wakeups/s, %2 ms of CPU per 1000 clicks").arg(wakeups).arg(cpuTime);
+}
+
+bool Clicker::writeMetrics(const QString& filename) const
+{
+	return m_metrics.write(filename, m_backend->getName());
+}
+
+int Clicker::randomNumber(int min, int max)
+{
+	// max can't be less or equal to min
+	return m_backend->getRandomGenerator().bounded(min, qMax(min + 1, max));
+}
+
+void Clicker::sleep(int ms)
+{
+	TraceSpan span("sleep", ms);
+
+	qint64 deadline = m_backend->getTime() + ms * 1000LL;
+
+	m_backend->sleep(ms);
+
+	m_deadline = deadline;
+}
+
+void Clicker::waitUntil(qint64 deadline)
+{
+	TraceSpan span("waitUntil");
+
+	m_backend->waitUntil(deadline);
+
+	m_deadline = deadline;
+}
+
+void Clicker::sendInputEvents(const InputEvent* events, int count)
+{
+	TraceSpan span("inject", count);
+
+	qint64 submitTime = m_backend->getTime();
+
+	m_backend->sendInputEvents(events, count);
+
+	qint64 returnTime = m_backend->getTime();
+
+	qint64 deadline = m_deadline < 0 ? submitTime : m_deadline;
+
+	m_lateness.add(submitTime - deadline);
+	m_injectionLatency.add(returnTime - submitTime);
+	m_totalLatency.add(returnTime - deadline);
+
+	m_metrics.addEvents(events, count);
+
+	if (m_runStartTime >= 0)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (events[i].type != InputEvent::Type::ButtonDown) continue;
+
+			m_startLatency.storeRelease(returnTime - m_runStartTime);
+			m_runStartTime = -1;
+
+			emit actionChanged(tr("First click after %1 ms").arg(m_startLatency.loadAcquire() / 1000.0, 0, 'f', 1));
+			break;
+		}
+	}
+
+	if (submitTime - deadline > s_missedDeadlineThreshold) m_metrics.addMissedDeadline();
+
+	m_deadline = -1;
+}
+
+void Clicker::mouseButtonDown(int button)
+{
+	InputEvent event(InputEvent::Type::ButtonDown, QPoint(), button);
+
+	sendInputEvents(&event, 1);
+}
+
+void Clicker::mouseButtonUp(int button)
+{
+	InputEvent event(InputEvent::Type::ButtonUp, QPoint(), button);
+
+	sendInputEvents(&event, 1);
+}
+
+void Clicker::mouseMoveTo(const QPoint& pos)
+{
+	InputEvent event(InputEvent::Type::Move, pos);
+
+	sendInputEvents(&event, 1);
+}
+
+void Clicker::keyDown(const KeyStroke& key)
+{
+	InputEvent event(InputEvent::Type::KeyDown, key);
+
+	sendInputEvents(&event, 1);
+}
+
+void Clicker::keyUp(const KeyStroke& key)
+{
+	InputEvent event(InputEvent::Type::KeyUp, key);
+
+	sendInputEvents(&event, 1);
+}
+
+void Clicker::typeKeyStrokes(const KeyStroke* keys, int count)
+{
+	m_events.clear();
+	m_events.reserve(count * 2);
+
+	for (int i = 0; i < count; ++i)
+	{
+		m_events << InputEvent(InputEvent::Type::KeyDown, keys[i]);
+		m_events << InputEvent(InputEvent::Type::KeyUp, keys[i]);
+	}
+
+	sendInputEvents(m_events.constData(), m_events.size());
+}
+
+void Clicker::run(const ActionModel* model, const Action& firstAction, QAtomicInt& stop)
+{
+	QRect rect;
+
+	m_lateness.reset();
+	m_injectionLatency.reset();
+	m_totalLatency.reset();
+
+	m_deadline = -1;
+
+	qint64 runStartTime = m_backend->getTime();
+
+	m_runStartTime = -1;
+	m_startLatency.storeRelease(-1);
+
+	// cause of stop if clicker stops by itself
+	ClickerMetrics::Abort abort = ClickerMetrics::Abort::User;
+
+	{
+		QMutexLocker locker(&m_usageMutex);
+
+		m_runStartUsage = getUsageSample();
+		m_runEndUsage = UsageSample();
+	}
+
+	m_backend->prepare();
+
+	int row = 0;
+
+	Action action;
+	qint64 startTime = m_backend->getTime();
+
+	// paths of Move and Drag actions
+	ScriptPlan plan;
+
+	// loop counters and call stack
+	ScriptPlan::Registers registers;
+
+	// inputs and outputs of expressions
+	double inputs[Expression::InputLast];
+	double outputs[Expression::OutputLast];
+
+	// offset computed by expression of current action
+	QPoint expressionOffset;
+
+	qint64 scriptStartTime = startTime;
+
+	if (!model)
+	{
+		// simple mode
+		action = firstAction;
+
+		// always use absolute coordinates
+		rect = QRect(0, 0, 10, 10);
+	}
+	else
+	{
+		plan.compile(model, m_backend);
+		plan.resetRegisters(registers);
+
+		QString title = model->getWindowTitle();
+		Window window;
+
+		if (!title.isEmpty())
+		{
+			TraceSpan span("findWindow");
+
+			qint64 lookupStartTime = m_backend->getTime();
+
+			m_backend->findWindow(title, window);
+
+			m_metrics.addWindowLookup(m_backend->getTime() - lookupStartTime);
+
+			rect = window.rect;
+		}
+		else
+		{
+			// only top left position is used
+			rect = QRect(0, 0, 10, 10);
+		}
+
+		int invalidRow = plan.getInvalidTargetRow();
+
+		// start from specific action
+		row = plan.resolveRow(model->getStartFrom(), registers);
+
+		if (invalidRow > -1)
+		{
+			emit actionChanged(tr("Unknown target: [%1] %2").arg(invalidRow).arg(model->getAction(invalidRow).text));
+
+			abort = ClickerMetrics::Abort::InvalidScript;
+			stop = 1;
+		}
+		else if (plan.getInvalidExpressionRow() > -1)
+		{
+			emit actionChanged(tr("Invalid expression: [%1] %2").arg(plan.getInvalidExpressionRow()).arg(plan.getExpressionError()));
+
+			abort = ClickerMetrics::Abort::InvalidScript;
+			stop = 1;
+		}
+		// no window with that name or no action to execute
+		else if (rect.isNull() || row < 0)
+		{
+			abort = rect.isNull() ? ClickerMetrics::Abort::WindowNotFound : ClickerMetrics::Abort::NoAction;
+			stop = 1;
+		}
+		else
+		{
+			// multi mode
+			action = model->getAction(row);
+
+			// apply window offset
+			action.originalPosition += rect.topLeft();
+			action.lastPosition = action.originalPosition;
+
+			if (!m_backend->isSameWindowAtPos(window, action.originalPosition))
+			{
+				abort = ClickerMetrics::Abort::WindowChanged;
+				stop = 1;
+			}
+		}
+	}
+
+	qint64 armedTime = m_backend->getTime();
+
+	// explicit countdown, one message per second
+	for (int remaining = m_startDelay; remaining > 0 && !stop; --remaining)
+	{
+		emit actionChanged(tr("Starting in %1 s").arg(remaining));
+
+		m_backend->sleep(1000);
+	}
+
+	// first action is executed now
+	startTime = m_backend->getTime();
+	scriptStartTime = startTime;
+	m_deadline = startTime;
+
+	// countdown is not part of start latency
+	m_runStartTime = startTime - (armedTime - runStartTime);
+
+	if (!stop) m_metrics.setStep(row);
+
+	while(!stop)
+	{
+		qint64 iterationStartTime = m_backend->getTime();
+
+		if (m_timeLimit > 0 && iterationStartTime >= m_timeLimit)
+		{
+			abort = ClickerMetrics::Abort::TimeLimit;
+			stop = 1;
+			break;
+		}
+
+		const Expression& expression = plan.getExpression(row);
+
+		if (!expression.isNull())
+		{
+			inputs[Expression::InputTime] = (m_backend->getTime() - scriptStartTime) / 1000000.0;
+			inputs[Expression::InputExecutions] = registers.executions[row];
+			inputs[Expression::InputRuns] = registers.runs;
+			inputs[Expression::InputRow] = row;
+
+			outputs[Expression::OutputX] = expressionOffset.x();
+			outputs[Expression::OutputY] = expressionOffset.y();
+
+			expression.evaluate(inputs, outputs, m_backend->getRandomGenerator());
+
+			// move action by the difference with previous offset
+			QPoint offset(qRound(outputs[Expression::OutputX]), qRound(outputs[Expression::OutputY]));
+
+			action.originalPosition += offset - expressionOffset;
+			action.lastPosition += offset - expressionOffset;
+
+			expressionOffset = offset;
+		}
+
+		if (model) ++registers.executions[row];
+
+		if (action.type == Action::Type::Click)
+		{
+			// 50% change position
+			if (randomNumber(0, 1) == 0)
+			{
+				// randomize position
+				int dx = randomNumber(0, 2) - 1;
+				int dy = randomNumber(0, 2) - 1;
+
+				// invert sign
+				if ((action.lastPosition.x() + dx > (action.originalPosition.x() + 5)) || (action.lastPosition.x() + dx < (action.originalPosition.x() - 5))) dx = -dx;
+				if ((action.lastPosition.y() + dy > (action.originalPosition.y() + 5)) || (action.lastPosition.y() + dx < (action.originalPosition.y() - 5))) dy = -dy;
+
+				action.lastPosition += QPoint(dx, dy);
+			}
+
+			// set cursor position and press button at once
+			InputEvent events[] = { InputEvent(InputEvent::Type::Move, action.lastPosition), InputEvent(InputEvent::Type::ButtonDown, QPoint(), (int)action.button) };
+
+			sendInputEvents(events, 2);
+
+			// between 6 and 14 clicks/second = 125-166
+
+			// wait a little before releasing the mouse
+			sleep(randomNumber(5, 15));
+
+			mouseButtonUp((int)action.button);
+		}
+		else if (action.type == Action::Type::Move || action.type == Action::Type::Drag)
+		{
+			const QPoint* samples = plan.getSamples(row);
+			int count = plan.getSamplesCount(row);
+			qint64 period = plan.getSamplePeriod(row);
+
+			bool dragging = action.type == Action::Type::Drag;
+
+			if (samples)
+			{
+				QPoint offset = rect.topLeft() + expressionOffset;
+
+				mouseMoveTo(samples[0] + offset);
+
+				if (dragging) mouseButtonDown((int)action.button);
+
+				qint64 pathStartTime = m_backend->getTime();
+
+				// samples are sent at fixed times, so a late sample doesn't delay the next ones
+				for (int i = 1; i < count && !stop; ++i)
+				{
+					waitUntil(pathStartTime + i * period);
+
+					mouseMoveTo(samples[i] + offset);
+				}
+
+				action.lastPosition = samples[count - 1] + offset;
+
+				if (dragging) mouseButtonUp((int)action.button);
+			}
+		}
+		else if (action.type == Action::Type::WaitPixel)
+		{
+			ClickerBackend::WaitResult result = m_backend->waitPixel(action, stop);
+
+			if (result == ClickerBackend::WaitResult::CursorMoved)
+			{
+				abort = ClickerMetrics::Abort::MouseMoved;
+				stop = 1;
+				break;
+			}
+
+			if (result == ClickerBackend::WaitResult::NotFound && !stop)
+			{
+				emit actionChanged(tr("Timeout: [%1] %2").arg(row).arg(action.name));
+
+				// application is not in the expected state
+				abort = ClickerMetrics::Abort::Timeout;
+				stop = 1;
+				break;
+			}
+		}
+		else if (action.type == Action::Type::FindImage)
+		{
+			QPoint pos;
+
+			ClickerBackend::WaitResult result = m_backend->waitImage(action, plan.getImageTemplate(row), stop, pos);
+
+			if (result == ClickerBackend::WaitResult::CursorMoved)
+			{
+				abort = ClickerMetrics::Abort::MouseMoved;
+				stop = 1;
+				break;
+			}
+
+			if (result == ClickerBackend::WaitResult::NotFound)
+			{
+				if (!stop)
+				{
+					emit actionChanged(tr("Timeout: [%1] %2").arg(row).arg(action.name));
+
+					// application is not in the expected state
+					abort = ClickerMetrics::Abort::Timeout;
+					stop = 1;
+				}
+
+				break;
+			}
+
+			action.lastPosition = pos;
+
+			InputEvent events[] = { InputEvent(InputEvent::Type::Move, pos), InputEvent(InputEvent::Type::ButtonDown, QPoint(), (int)action.button) };
+
+			sendInputEvents(events, 2);
+
+			sleep(randomNumber(5, 15));
+
+			mouseButtonUp((int)action.button);
+		}
+		else if (action.type == Action::Type::Scroll)
+		{
+			// wheel events are sent to the window under the cursor
+			InputEvent events[] = { InputEvent(InputEvent::Type::Move, action.lastPosition), InputEvent(InputEvent::Type::Wheel, action.scroll) };
+
+			sendInputEvents(events, 2);
+		}
+		else if (action.type == Action::Type::KeyPress || action.type == Action::Type::KeyRelease)
+		{
+			const KeyStroke* key = plan.getKeyStrokes(row);
+
+			if (key)
+			{
+				if (action.type == Action::Type::KeyPress)
+				{
+					keyDown(*key);
+				}
+				else
+				{
+					keyUp(*key);
+				}
+			}
+		}
+		else if (action.type == Action::Type::Text)
+		{
+			const KeyStroke* keys = plan.getKeyStrokes(row);
+			int count = plan.getKeyStrokesCount(row);
+
+			if (action.keyDelayMax <= 0)
+			{
+				// whole text at once
+				typeKeyStrokes(keys, count);
+			}
+			else
+			{
+				for (int i = 0; i < count && !stop; ++i)
+				{
+					typeKeyStrokes(keys + i, 1);
+
+					if (i + 1 < count) sleep(randomNumber(action.keyDelayMin, action.keyDelayMax));
+				}
+			}
+		}
+
+		// wait before next click
+		int ms = 0;
+
+		if (expression.hasOutput(Expression::OutputDelay))
+		{
+			ms = qMax(s_minimumDelay, qRound(outputs[Expression::OutputDelay]));
+		}
+		else
+		{
+			ms = randomNumber(qMax(action.delayMin, s_minimumDelay), action.delayMax);
+		}
+
+		qint64 deadline = m_backend->getTime() + ms * 1000LL;
+
+		{
+			TraceSpan span("delay", ms);
+
+			// stop auto-click if move the mouse
+			if (action.type == Action::Type::Click || action.type == Action::Type::Move || action.type == Action::Type::Drag || action.type == Action::Type::FindImage || action.type == Action::Type::Scroll)
+			{
+				if (m_backend->waitForCursorMove(action.lastPosition, deadline))
+				{
+					abort = ClickerMetrics::Abort::MouseMoved;
+					stop = 1;
+				}
+			}
+			else
+			{
+				m_backend->sleep(ms);
+			}
+		}
+
+		m_deadline = deadline;
+
+		m_metrics.addIteration(m_backend->getTime() - iterationStartTime);
+
+		emit actionExecuted();
+
+		// if not using simple mode
+		if (stop != 1 && model)
+		{
+			qint64 endTime = m_backend->getTime();
+
+			// check if we should pass to next spot
+			if (endTime - startTime > action.duration * 1000000LL)
+			{
+				// next spot, after following jumps, loops and calls
+				row = plan.resolveRow(row + 1, registers);
+
+				// new duration
+				startTime = endTime;
+
+				if (row < 0)
+				{
+					// infinite loop or recursion
+					emit actionChanged(tr("No action to execute"));
+
+					abort = ClickerMetrics::Abort::NoAction;
+					stop = 1;
+					break;
+				}
+
+				// new spot
+				action = model->getAction(row);
+
+				emit actionChanged(QString("[%1] %2").arg(row).arg(action.name));
+
+				m_metrics.setStep(row);
+
+				Trace::instant("step", row);
+
+				// apply window offset
+				action.originalPosition += rect.topLeft();
+				action.lastPosition = action.originalPosition;
+
+				expressionOffset = QPoint();
+			}
+		}
+	}
+
+	m_backend->finish();
+
+	// stop is only set to 1 by clicker
+	m_metrics.addAbort(stop == 1 ? abort : ClickerMetrics::Abort::User);
+	m_metrics.setStep(-1);
+
+	QMutexLocker locker(&m_usageMutex);
+
+	m_runEndUsage = getUsageSample();
+}
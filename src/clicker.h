@@ -0,0 +1,222 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CLICKER_H
+#define CLICKER_H
+
+#include "action.h"
+#include "utils.h"
+#include "latencyhistogram.h"
+#include "clickermetrics.h"
+
+class ActionModel;
+class ImageTemplate;
+
+// minimum time between 2 actions in ms
+static const int s_minimumDelay = 10;
+
+// Everything the clicker needs from the system, so scripts can also be run on a virtual clock.
+class ClickerBackend
+{
+public:
+	enum class WaitResult
+	{
+		Found,
+		// timeout or stopped
+		NotFound,
+		// user moved the mouse while waiting
+		CursorMoved
+	};
+
+	virtual ~ClickerBackend() {}
+
+	// name of the way events are sent, used in metrics
+	virtual QString getName() const = 0;
+
+	// open connections and initialize everything first actions need, so they are not delayed
+	virtual void prepare() = 0;
+
+	// stop what prepare started, called when clicker stops
+	virtual void finish() = 0;
+
+	// µs since backend creation
+	virtual qint64 getTime() = 0;
+
+	virtual void sleep(int ms) = 0;
+
+	// return when time reaches deadline in µs, more accurate than sleep
+	virtual void waitUntil(qint64 deadline) = 0;
+
+	virtual void sendInputEvents(const InputEvent* events, int count) = 0;
+
+	virtual QPoint getCursorPosition() = 0;
+
+	// name is the same as in QKeySequence or a modifier, null if key doesn't exist
+	virtual KeyStroke getKeyStroke(const QString& name) = 0;
+
+	// one key stroke per character, null if a character can't be typed
+	virtual QVector<KeyStroke> getKeyStrokes(const QString& text) = 0;
+
+	// return true as soon as cursor is not at pos anymore, false when time reaches deadline in µs
+	virtual bool waitForCursorMove(const QPoint& pos, qint64 deadline) = 0;
+
+	virtual QRandomGenerator& getRandomGenerator() = 0;
+
+	// return false if no window has this title
+	virtual bool findWindow(const QString& title, Window& window) = 0;
+
+	virtual bool isSameWindowAtPos(const Window& window, const QPoint& pos) = 0;
+
+	// wait until pixels around absolute position have expected color
+	virtual WaitResult waitPixel(const Action& action, const QAtomicInt& stop) = 0;
+
+	// search image in region until found, pos is the center of image
+	virtual WaitResult waitImage(const Action& action, const ImageTemplate& imageTemplate, const QAtomicInt& stop, QPoint& pos) = 0;
+};
+
+// Real time and real inputs.
+class SystemBackend : public ClickerBackend
+{
+public:
+	SystemBackend();
+
+	QString getName() const override;
+	void prepare() override;
+	void finish() override;
+	qint64 getTime() override;
+	void sleep(int ms) override;
+	void waitUntil(qint64 deadline) override;
+	void sendInputEvents(const InputEvent* events, int count) override;
+	QPoint getCursorPosition() override;
+	KeyStroke getKeyStroke(const QString& name) override;
+	QVector<KeyStroke> getKeyStrokes(const QString& text) override;
+	bool waitForCursorMove(const QPoint& pos, qint64 deadline) override;
+	QRandomGenerator& getRandomGenerator() override;
+	bool findWindow(const QString& title, Window& window) override;
+	bool isSameWindowAtPos(const Window& window, const QPoint& pos) override;
+	WaitResult waitPixel(const Action& action, const QAtomicInt& stop) override;
+	WaitResult waitImage(const Action& action, const ImageTemplate& imageTemplate, const QAtomicInt& stop, QPoint& pos) override;
+
+private:
+	QElapsedTimer m_clock;
+};
+
+// Execute actions using a backend, signals are emitted from the thread calling run.
+class Clicker : public QObject
+{
+	Q_OBJECT
+
+public:
+	Clicker(ClickerBackend* backend, QObject* parent = nullptr);
+
+	// stop when backend time reaches limit in µs, 0 for no limit
+	void setTimeLimit(qint64 limit) { m_timeLimit = limit; }
+
+	// countdown in s between preparation and first action, 0 to start immediately
+	void setStartDelay(int delay) { m_startDelay = delay; }
+
+	// µs between call to run and first button pressed during last run, without countdown,
+	// -1 if no button pressed yet, can be read from any thread
+	qint64 getStartLatency() const { return m_startLatency.loadAcquire(); }
+
+	// wakeups per second and CPU time per 1000 clicks of the whole process during last run,
+	// or since its start if still running, can be called from any thread
+	QString getUsageString() const;
+
+	// execute actions of model or repeat action if model is null, until stop is not 0
+	// stop is set to 1 if clicker stopped by itself (mouse moved, timeout, error)
+	void run(const ActionModel* model, const Action& action, QAtomicInt& stop);
+
+	// in µs, for each call to backend since last run, can be read from any thread:
+	// - time between end of previous wait and call (0 if events didn't follow a wait)
+	// - duration of call
+	// - time between end of previous wait and end of call
+	const LatencyHistogram& getLateness() const { return m_lateness; }
+	const LatencyHistogram& getInjectionLatency() const { return m_injectionLatency; }
+	const LatencyHistogram& getTotalLatency() const { return m_totalLatency; }
+
+	// since clicker creation, can be read from any thread
+	const ClickerMetrics& getMetrics() const { return m_metrics; }
+
+	// export metrics to file in Prometheus format
+	bool writeMetrics(const QString& filename) const;
+
+signals:
+	void actionChanged(const QString& label);
+	void actionExecuted();
+
+private:
+	int randomNumber(int min, int max);
+
+	// next events should be sent at the end of these waits
+	void sleep(int ms);
+	void waitUntil(qint64 deadline);
+
+	void sendInputEvents(const InputEvent* events, int count);
+
+	void mouseButtonDown(int button);
+	void mouseButtonUp(int button);
+	void mouseMoveTo(const QPoint& pos);
+	void keyDown(const KeyStroke& key);
+	void keyUp(const KeyStroke& key);
+	void typeKeyStrokes(const KeyStroke* keys, int count);
+
+	ClickerBackend* m_backend;
+	qint64 m_timeLimit;
+	int m_startDelay;
+
+	// time when run was called, without countdown, -1 when first button has been pressed
+	qint64 m_runStartTime;
+
+	QAtomicInteger<qint64> m_startLatency;
+
+	// process usage at start and end of last run
+	struct UsageSample
+	{
+		UsageSample() :time(-1), clicks(0)
+		{
+		}
+
+		// in ms, -1 if not sampled
+		qint64 time;
+		qint64 clicks;
+		ProcessUsage usage;
+	};
+
+	UsageSample getUsageSample() const;
+
+	QElapsedTimer m_usageClock;
+	mutable QMutex m_usageMutex;
+	UsageSample m_runStartUsage;
+	UsageSample m_runEndUsage;
+
+	// time when next events should be sent, -1 if as soon as possible
+	qint64 m_deadline;
+
+	LatencyHistogram m_lateness;
+	LatencyHistogram m_injectionLatency;
+	LatencyHistogram m_totalLatency;
+
+	ClickerMetrics m_metrics;
+
+	// buffer for typeKeyStrokes
+	QVector<InputEvent> m_events;
+};
+
+#endif
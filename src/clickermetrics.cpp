@@ -0,0 +1,119 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "clickermetrics.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// same order as InputEvent::Type
+static const char* s_eventTypes[] = { "move", "button_down", "button_up", "wheel", "key_down", "key_up" };
+
+// same order as ClickerMetrics::Abort
+static const char* s_abortCauses[] = { "user", "mouse_moved", "window_not_found", "window_changed", "invalid_script", "no_action", "timeout", "time_limit" };
+
+// quantiles exported for durations
+static const double s_quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+static void writeHeader(QTextStream& out, const QString& name, const QString& type, const QString& help)
+{
+	out << "# HELP " << name << " " << help << "\n";
+	out << "# TYPE " << name << " " << type << "\n";
+}
+
+// durations are exported in seconds like all Prometheus metrics
+static void writeSummary(QTextStream& out, const QString& name, const QString& labels, const QString& help, const LatencyHistogram& histogram)
+{
+	writeHeader(out, name, "summary", help);
+
+	for (double quantile : s_quantiles)
+	{
+		out << name << "{" << labels << ",quantile=\"" << quantile << "\"} " << histogram.getPercentile(quantile * 100.0) / 1000000.0 << "\n";
+	}
+
+	out << name << "_sum{" << labels << "} " << histogram.getSum() / 1000000.0 << "\n";
+	out << name << "_count{" << labels << "} " << histogram.getCount() << "\n";
+}
+
+ClickerMetrics::ClickerMetrics() :m_missedDeadlines(0), m_step(-1)
+{
+	for (int i = 0; i < s_eventTypesCount; ++i) m_events[i].storeRelease(0);
+	for (int i = 0; i < (int)Abort::Last; ++i) m_aborts[i].storeRelease(0);
+}
+
+qint64 ClickerMetrics::getClicks() const
+{
+	return m_events[(int)InputEvent::Type::ButtonDown].loadAcquire();
+}
+
+qint64 ClickerMetrics::getMissedDeadlines() const
+{
+	return m_missedDeadlines.loadAcquire();
+}
+
+QString ClickerMetrics::toPrometheus(const QString& backend) const
+{
+	QString res;
+	QTextStream out(&res);
+
+	QString labels = QString("backend=\"%1\"").arg(backend);
+
+	writeHeader(out, "kclicker_clicks_total", "counter", "Mouse buttons pressed by clicker.");
+	out << "kclicker_clicks_total{" << labels << "} " << getClicks() << "\n";
+
+	writeHeader(out, "kclicker_events_total", "counter", "Input events sent by clicker.");
+
+	for (int i = 0; i < s_eventTypesCount; ++i)
+	{
+		out << "kclicker_events_total{" << labels << ",type=\"" << s_eventTypes[i] << "\"} " << m_events[i].loadAcquire() << "\n";
+	}
+
+	writeHeader(out, "kclicker_missed_deadlines_total", "counter", "Input events sent too late after a wait.");
+	out << "kclicker_missed_deadlines_total{" << labels << "} " << getMissedDeadlines() << "\n";
+
+	writeHeader(out, "kclicker_aborts_total", "counter", "Times clicker stopped, by cause.");
+
+	for (int i = 0; i < (int)Abort::Last; ++i)
+	{
+		out << "kclicker_aborts_total{" << labels << ",cause=\"" << s_abortCauses[i] << "\"} " << m_aborts[i].loadAcquire() << "\n";
+	}
+
+	writeHeader(out, "kclicker_current_step", "gauge", "Row of action being executed, -1 if clicker is stopped.");
+	out << "kclicker_current_step{" << labels << "} " << m_step.loadAcquire() << "\n";
+
+	writeSummary(out, "kclicker_window_lookup_seconds", labels, "Time to find window of script.", m_windowLookup);
+	writeSummary(out, "kclicker_loop_iteration_seconds", labels, "Time to execute an action, including delay before next one.", m_iteration);
+
+	out.flush();
+
+	return res;
+}
+
+bool ClickerMetrics::write(const QString& filename, const QString& backend) const
+{
+	QSaveFile file(filename);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+	file.write(toPrometheus(backend).toUtf8());
+
+	return file.commit();
+}
@@ -0,0 +1,87 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CLICKERMETRICS_H
+#define CLICKERMETRICS_H
+
+#include "utils.h"
+#include "latencyhistogram.h"
+
+// Counters and gauges of the clicker since application start. They are only
+// updated by the clicker thread with atomic operations (no locks) and can be
+// read by any thread at the same time.
+class ClickerMetrics
+{
+public:
+	// why clicker stopped
+	enum class Abort
+	{
+		User,
+		MouseMoved,
+		WindowNotFound,
+		WindowChanged,
+		InvalidScript,
+		NoAction,
+		Timeout,
+		TimeLimit,
+		Last
+	};
+
+	ClickerMetrics();
+
+	void addEvents(const InputEvent* events, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			m_events[(int)events[i].type].fetchAndAddRelaxed(1);
+		}
+	}
+
+	void addMissedDeadline() { m_missedDeadlines.fetchAndAddRelaxed(1); }
+	void addAbort(Abort cause) { m_aborts[(int)cause].fetchAndAddRelaxed(1); }
+
+	// row of current action, 0 in simple mode and -1 when clicker is stopped
+	void setStep(int row) { m_step.storeRelease(row); }
+
+	// in µs
+	void addWindowLookup(qint64 duration) { m_windowLookup.add(duration); }
+	void addIteration(qint64 duration) { m_iteration.add(duration); }
+
+	qint64 getClicks() const;
+	qint64 getMissedDeadlines() const;
+
+	// all metrics in Prometheus text format, backend is used as a label
+	QString toPrometheus(const QString& backend) const;
+
+	// replace file atomically, so a collector never reads a partial file
+	bool write(const QString& filename, const QString& backend) const;
+
+private:
+	static const int s_eventTypesCount = (int)InputEvent::Type::KeyUp + 1;
+
+	QAtomicInteger<qint64> m_events[s_eventTypesCount];
+	QAtomicInteger<qint64> m_missedDeadlines;
+	QAtomicInteger<qint64> m_aborts[(int)Abort::Last];
+	QAtomicInt m_step;
+
+	LatencyHistogram m_windowLookup;
+	LatencyHistogram m_iteration;
+};
+
+#endif
@@ -1,299 +1,714 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "editscriptdialog.h"
-#include "ui_editscriptdialog.h"
-#include "configfile.h"
-#include "actionmodel.h"
-#include "utils.h"
-#include "capturedialog.h"
-
-#ifdef DEBUG_NEW
-	#define new DEBUG_NEW
-#endif
-
-EditScriptDialog::EditScriptDialog(QWidget *parent, ActionModel *model):QDialog(parent), m_stopExternalListener(0)
-{
-	m_ui = new Ui::EditScriptDialog();
-	m_ui->setupUi(this);
-
-	// clone the model to not change it if cancel dialog
-	m_model = model->clone(this);
-
-	m_ui->spotsListView->setModel(m_model);
-
-	m_ui->actionGroupBox->setVisible(false);
-
-	m_mapper = new QDataWidgetMapper(this);
-	m_mapper->setModel(m_model);
-	m_mapper->addMapping(m_ui->nameLineEdit, ActionColumnName);
-	m_mapper->addMapping(m_ui->typeComboBox, ActionColumnType, "currentIndex");
-	m_mapper->addMapping(m_ui->delayMinSpinBox, ActionColumnDelayMin);
-	m_mapper->addMapping(m_ui->delayMaxSpinBox, ActionColumnDelayMax);
-	m_mapper->addMapping(m_ui->durationSpinBox, ActionColumnDuration);
-	m_mapper->addMapping(m_ui->countSpinBox, ActionColumnOriginalCount);
-
-	QStandardItemModel* typesModel = new QStandardItemModel(this);
-	typesModel->appendRow(new QStandardItem(tr("None")));
-	typesModel->appendRow(new QStandardItem(tr("Click")));
-	typesModel->appendRow(new QStandardItem(tr("Repeat")));
-
-	m_ui->typeComboBox->setModel(typesModel);
-
-	connect(m_ui->typeComboBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &EditScriptDialog::onTypeChanged);
-	connect(m_ui->thisActionPushButton, &QPushButton::clicked, this, &EditScriptDialog::onThisActionClicked);
-
-	// Buttons
-	connect(m_ui->positionPushButton, &QPushButton::clicked, this, &EditScriptDialog::onPosition);
-	connect(m_ui->windowTitlePushButton, &QPushButton::clicked, this, &EditScriptDialog::onWindowTitleChanged);
-
-	QShortcut *shortcutDelete = new QShortcut(QKeySequence(Qt::Key_Delete), m_ui->spotsListView);
-	connect(shortcutDelete, &QShortcut::activated, this, &EditScriptDialog::onDeleteSpot);
-
-	QShortcut* shortcutInsert = new QShortcut(QKeySequence(Qt::Key_Insert), m_ui->spotsListView);
-	connect(shortcutInsert, &QShortcut::activated, this, &EditScriptDialog::onInsertSpot);
-
-	// Selection model
-	connect(m_ui->spotsListView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &EditScriptDialog::onSelectionChanged);
-	connect(m_ui->spotsListView->selectionModel(), &QItemSelectionModel::currentRowChanged, m_mapper, &QDataWidgetMapper::setCurrentModelIndex);
-
-	// MainWindow
-	connect(this, &EditScriptDialog::mousePositionChanged, this, &EditScriptDialog::onMousePositionChanged);
-
-	m_ui->nameEdit->setText(m_model->getName());
-
-	setWindowTitleButton(m_model->getWindowTitle());
-}
-
-EditScriptDialog::~EditScriptDialog()
-{
-	delete m_ui;
-}
-
-void EditScriptDialog::onInsertSpot()
-{
-	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
-
-	int row = indices.isEmpty() ? -1:indices.front().row()+1;
-
-	m_model->insertRow(row);
-}
-
-void EditScriptDialog::onDeleteSpot()
-{
-	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
-
-	if (indices.isEmpty()) return;
-
-	int row = indices.front().row();
-
-	m_model->removeRow(row);
-}
-
-void EditScriptDialog::emitMousePosition()
-{
-	// absolute coordinates
-	QPoint pos = QCursor::pos();
-
-	QString title = m_model->getWindowTitle();
-
-	if (!title.isEmpty())
-	{
-		// search a window with title
-		Window window = getWindowWithTitle(title);
-
-		// if found
-		if (window.id)
-		{
-			// convert to relative coordinates
-			pos -= window.rect.topLeft();
-		}
-		else
-		{
-			qDebug() << "No window with title" << title;
-		}
-	}
-
-	emit mousePositionChanged(pos);
-}
-
-void EditScriptDialog::onPosition()
-{
-	m_ui->positionPushButton->setEnabled(false);
-	m_ui->positionPushButton->setText("???");
-
-	// if cursor is outside window, begin to listen on keys
-	if (!rect().contains(mapFromGlobal(QCursor::pos())))
-	{
-		// reset external listener
-		m_stopExternalListener = 0;
-	}
-}
-
-void EditScriptDialog::onWindowTitleChanged()
-{
-	Window window;
-
-	{
-		CaptureDialog dlg(this);
-
-		if (!dlg.exec()) return;
-
-		window = dlg.getWindow();
-	}
-
-	// don't process window if minimized
-	if (isWindowMinimized(window.id)) return;
-
-	m_model->setWindowTitle(window.title);
-	m_model->updateSpotsPosition(window.rect.topLeft());
-
-	// only update the push button label
-	setWindowTitleButton(window.title);
-}
-
-void EditScriptDialog::onSelectionChanged(const QItemSelection& selected, const QItemSelection& /* deselected */)
-{
-	// update controls
-	m_ui->actionGroupBox->setVisible(!selected.empty());
-
-	if (selected.empty()) return;
-
-	// update controls
-	const QItemSelectionRange &range = selected.front();
-
-	QModelIndexList indices = range.indexes();
-
-	int row = indices.front().row();
-
-	Action action = m_model->getAction(row);
-
-	// manually update position because not handled by data mapper
-	QPoint pos = action.originalPosition;
-
-	m_ui->positionPushButton->setText(QString("(%1, %2)").arg(pos.x()).arg(pos.y()));
-
-	onTypeChanged(typeToInt(action.type));
-
-	m_ui->thisActionPushButton->setChecked(row == m_model->getStartFrom());
-}
-
-void EditScriptDialog::onMousePositionChanged(const QPoint& pos)
-{
-	// only when position button is disabled
-	if (m_ui->positionPushButton->isEnabled()) return;
-
-	QModelIndex index = m_ui->spotsListView->selectionModel()->currentIndex();
-
-	// update original and last positions
-	Action spot = m_model->getAction(index.row());
-	spot.lastPosition = pos;
-	spot.originalPosition = pos;
-	m_model->setAction(index.row(), spot);
-
-	m_ui->positionPushButton->setEnabled(true);
-	m_ui->positionPushButton->setText(QString("(%1, %2)").arg(pos.x()).arg(pos.y()));
-}
-
-void EditScriptDialog::onTypeChanged(int index)
-{
-	switch (typeFromInt(index))
-	{
-	case Action::Type::Repeat:
-		m_ui->durationLabel->setVisible(false);
-		m_ui->durationSpinBox->setVisible(false);
-
-		m_ui->positionLabel->setVisible(false);
-		m_ui->positionPushButton->setVisible(false);
-
-		m_ui->countLabel->setVisible(true);
-		m_ui->countSpinBox->setVisible(true);
-
-		break;
-
-	default:
-		m_ui->durationLabel->setVisible(true);
-		m_ui->durationSpinBox->setVisible(true);
-
-		m_ui->positionLabel->setVisible(true);
-		m_ui->positionPushButton->setVisible(true);
-
-		m_ui->countLabel->setVisible(false);
-		m_ui->countSpinBox->setVisible(false);
-	}
-}
-
-void EditScriptDialog::onThisActionClicked()
-{
-	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
-
-	int row = indices.isEmpty() ? -1 : indices.front().row();
-
-	if (row == -1) return;
-
-	m_model->setStartFrom(row);
-}
-
-void EditScriptDialog::setWindowTitleButton(const QString& title)
-{
-	QFontMetrics fm = m_ui->windowTitlePushButton->fontMetrics();
-	const int usableWidth = qRound(0.9 * m_ui->windowTitlePushButton->width());
-
-	QString elidedText = fm.elidedText(title, Qt::ElideRight, usableWidth);
-	bool elided = (elidedText != title);
-
-	QString text = elided ? elidedText : title;
-
-	if (text.isEmpty()) text = tr("Unknown");
-
-	m_ui->windowTitlePushButton->setText(text);
-}
-
-bool EditScriptDialog::event(QEvent *e)
-{
-	if (e->type() == QEvent::WindowDeactivate)
-	{
-		emitMousePosition();
-	}
-	else if (e->type() == QEvent::Enter)
-	{
-		m_stopExternalListener = 1;
-	}
-	else if (e->type() == QEvent::LanguageChange)
-	{
-		m_ui->retranslateUi(this);
-	}
-	else if (e->type() == QEvent::WindowStateChange)
-	{
-		if (windowState() & Qt::WindowMinimized)
-		{
-			QTimer::singleShot(250, this, SLOT(onMinimize()));
-		}
-	}
-
-	return QDialog::event(e);
-}
-
-void EditScriptDialog::accept()
-{
-	m_model->setName(m_ui->nameEdit->text());
-
-	QDialog::accept();
-}
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "editscriptdialog.h"
+#include "ui_editscriptdialog.h"
+#include "configfile.h"
+#include "actionmodel.h"
+#include "utils.h"
+#include "capturedialog.h"
+#include "recorder.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+EditScriptDialog::EditScriptDialog(QWidget *parent, ActionModel *model):QDialog(parent), m_stopExternalListener(0)
+{
+	m_ui = new Ui::EditScriptDialog();
+	m_ui->setupUi(this);
+
+	// clone the model to not change it if cancel dialog, actions are only copied when modified
+	m_model = model->clone(this);
+	m_model->setUndoDepth(ConfigFile::getInstance()->getUndoDepth());
+
+	m_recorder = new Recorder(this);
+
+	m_ui->spotsListView->setModel(m_model);
+	m_ui->spotsListView->viewport()->installEventFilter(this);
+
+	m_ui->actionGroupBox->setVisible(false);
+
+	m_mapper = new QDataWidgetMapper(this);
+	m_mapper->setModel(m_model);
+	m_mapper->addMapping(m_ui->nameLineEdit, ActionColumnName);
+	m_mapper->addMapping(m_ui->typeComboBox, ActionColumnType, "currentIndex");
+	m_mapper->addMapping(m_ui->delayMinSpinBox, ActionColumnDelayMin);
+	m_mapper->addMapping(m_ui->delayMaxSpinBox, ActionColumnDelayMax);
+	m_mapper->addMapping(m_ui->durationSpinBox, ActionColumnDuration);
+	m_mapper->addMapping(m_ui->countSpinBox, ActionColumnOriginalCount);
+	m_mapper->addMapping(m_ui->pathLineEdit, ActionColumnPath);
+	m_mapper->addMapping(m_ui->pathShapeComboBox, ActionColumnPathShape, "currentIndex");
+	m_mapper->addMapping(m_ui->speedProfileComboBox, ActionColumnSpeedProfile, "currentIndex");
+	m_mapper->addMapping(m_ui->sampleRateSpinBox, ActionColumnSampleRate);
+	m_mapper->addMapping(m_ui->moveDurationSpinBox, ActionColumnMoveDuration);
+	m_mapper->addMapping(m_ui->toleranceSpinBox, ActionColumnTolerance);
+	m_mapper->addMapping(m_ui->regionSizeSpinBox, ActionColumnRegionSize);
+	m_mapper->addMapping(m_ui->timeoutSpinBox, ActionColumnTimeout);
+	m_mapper->addMapping(m_ui->searchWidthSpinBox, ActionColumnSearchWidth);
+	m_mapper->addMapping(m_ui->searchHeightSpinBox, ActionColumnSearchHeight);
+	m_mapper->addMapping(m_ui->textLineEdit, ActionColumnText);
+	m_mapper->addMapping(m_ui->keyDelayMinSpinBox, ActionColumnKeyDelayMin);
+	m_mapper->addMapping(m_ui->keyDelayMaxSpinBox, ActionColumnKeyDelayMax);
+	m_mapper->addMapping(m_ui->buttonComboBox, ActionColumnButton, "currentIndex");
+	m_mapper->addMapping(m_ui->scrollXSpinBox, ActionColumnScrollX);
+	m_mapper->addMapping(m_ui->scrollYSpinBox, ActionColumnScrollY);
+	m_mapper->addMapping(m_ui->expressionLineEdit, ActionColumnExpression);
+
+	QStandardItemModel* typesModel = new QStandardItemModel(this);
+	typesModel->appendRow(new QStandardItem(tr("None")));
+	typesModel->appendRow(new QStandardItem(tr("Click")));
+	typesModel->appendRow(new QStandardItem(tr("Repeat")));
+	typesModel->appendRow(new QStandardItem(tr("Move")));
+	typesModel->appendRow(new QStandardItem(tr("Drag")));
+	typesModel->appendRow(new QStandardItem(tr("Wait pixel")));
+	typesModel->appendRow(new QStandardItem(tr("Find image")));
+	typesModel->appendRow(new QStandardItem(tr("Key press")));
+	typesModel->appendRow(new QStandardItem(tr("Key release")));
+	typesModel->appendRow(new QStandardItem(tr("Text")));
+	typesModel->appendRow(new QStandardItem(tr("Scroll")));
+	typesModel->appendRow(new QStandardItem(tr("Jump")));
+	typesModel->appendRow(new QStandardItem(tr("Loop")));
+	typesModel->appendRow(new QStandardItem(tr("Call")));
+	typesModel->appendRow(new QStandardItem(tr("Return")));
+
+	m_ui->typeComboBox->setModel(typesModel);
+
+	QStandardItemModel* pathShapesModel = new QStandardItemModel(this);
+	pathShapesModel->appendRow(new QStandardItem(tr("Polyline")));
+	pathShapesModel->appendRow(new QStandardItem(tr("Bezier")));
+
+	m_ui->pathShapeComboBox->setModel(pathShapesModel);
+
+	QStandardItemModel* speedProfilesModel = new QStandardItemModel(this);
+	speedProfilesModel->appendRow(new QStandardItem(tr("Constant")));
+	speedProfilesModel->appendRow(new QStandardItem(tr("Ease in/out")));
+
+	m_ui->speedProfileComboBox->setModel(speedProfilesModel);
+
+	QStandardItemModel* buttonsModel = new QStandardItemModel(this);
+	buttonsModel->appendRow(new QStandardItem(tr("Left")));
+	buttonsModel->appendRow(new QStandardItem(tr("Middle")));
+	buttonsModel->appendRow(new QStandardItem(tr("Right")));
+	buttonsModel->appendRow(new QStandardItem(tr("Back")));
+	buttonsModel->appendRow(new QStandardItem(tr("Forward")));
+
+	m_ui->buttonComboBox->setModel(buttonsModel);
+
+	connect(m_ui->typeComboBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &EditScriptDialog::onTypeChanged);
+	connect(m_ui->thisActionPushButton, &QPushButton::clicked, this, &EditScriptDialog::onThisActionClicked);
+
+	// Buttons
+	connect(m_ui->positionPushButton, &QPushButton::clicked, this, &EditScriptDialog::onPosition);
+	connect(m_ui->colorPushButton, &QPushButton::clicked, this, &EditScriptDialog::onColor);
+	connect(m_ui->imagePushButton, &QPushButton::clicked, this, &EditScriptDialog::onImage);
+	connect(m_ui->windowTitlePushButton, &QPushButton::clicked, this, &EditScriptDialog::onWindowTitleChanged);
+	connect(m_ui->recordPushButton, &QPushButton::toggled, this, &EditScriptDialog::onRecordToggled);
+
+	QShortcut *shortcutDelete = new QShortcut(QKeySequence(Qt::Key_Delete), m_ui->spotsListView);
+	connect(shortcutDelete, &QShortcut::activated, this, &EditScriptDialog::onDeleteSpot);
+
+	QShortcut* shortcutInsert = new QShortcut(QKeySequence(Qt::Key_Insert), m_ui->spotsListView);
+	connect(shortcutInsert, &QShortcut::activated, this, &EditScriptDialog::onInsertSpot);
+
+	QShortcut* shortcutCopy = new QShortcut(QKeySequence::Copy, m_ui->spotsListView);
+	connect(shortcutCopy, &QShortcut::activated, this, &EditScriptDialog::onCopySpots);
+
+	QShortcut* shortcutCut = new QShortcut(QKeySequence::Cut, m_ui->spotsListView);
+	connect(shortcutCut, &QShortcut::activated, this, &EditScriptDialog::onCutSpots);
+
+	QShortcut* shortcutPaste = new QShortcut(QKeySequence::Paste, m_ui->spotsListView);
+	connect(shortcutPaste, &QShortcut::activated, this, &EditScriptDialog::onPasteSpots);
+
+	QShortcut* shortcutUndo = new QShortcut(QKeySequence::Undo, this);
+	connect(shortcutUndo, &QShortcut::activated, m_model, &ActionModel::undo);
+
+	QShortcut* shortcutRedo = new QShortcut(QKeySequence::Redo, this);
+	connect(shortcutRedo, &QShortcut::activated, m_model, &ActionModel::redo);
+
+	// Model
+	connect(m_model, &ActionModel::undoStackChanged, this, &EditScriptDialog::onUndoStackChanged);
+
+	// Recorder
+	connect(m_recorder, &Recorder::actionsRecorded, this, &EditScriptDialog::onActionsRecorded, Qt::QueuedConnection);
+
+	// Selection model
+	connect(m_ui->spotsListView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &EditScriptDialog::onSelectionChanged);
+	connect(m_ui->spotsListView->selectionModel(), &QItemSelectionModel::currentRowChanged, m_mapper, &QDataWidgetMapper::setCurrentModelIndex);
+
+	// MainWindow
+	connect(this, &EditScriptDialog::mousePositionChanged, this, &EditScriptDialog::onMousePositionChanged);
+
+	m_ui->nameEdit->setText(m_model->getName());
+
+	setWindowTitleButton(m_model->getWindowTitle());
+
+	onUndoStackChanged();
+}
+
+EditScriptDialog::~EditScriptDialog()
+{
+	m_recorder->stop();
+
+	delete m_ui;
+}
+
+void EditScriptDialog::onInsertSpot()
+{
+	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+	int row = indices.isEmpty() ? -1:indices.front().row()+1;
+
+	m_model->insertRow(row);
+}
+
+void EditScriptDialog::onDeleteSpot()
+{
+	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+	if (indices.isEmpty()) return;
+
+	QList<int> rows;
+
+	for (const QModelIndex& index : indices) rows << index.row();
+
+	m_model->removeSelectedRows(rows);
+}
+
+void EditScriptDialog::onCopySpots()
+{
+	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+	if (indices.isEmpty()) return;
+
+	QApplication::clipboard()->setMimeData(m_model->mimeData(indices));
+}
+
+void EditScriptDialog::onCutSpots()
+{
+	onCopySpots();
+	onDeleteSpot();
+}
+
+void EditScriptDialog::onPasteSpots()
+{
+	const QMimeData* data = QApplication::clipboard()->mimeData();
+
+	if (!data) return;
+
+	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+	// paste after the last selected action
+	int row = -1;
+
+	for (const QModelIndex& index : indices) row = qMax(row, index.row() + 1);
+
+	m_model->dropMimeData(data, Qt::CopyAction, row, 0, QModelIndex());
+}
+
+void EditScriptDialog::emitMousePosition()
+{
+	// absolute coordinates
+	QPoint pos = QCursor::pos();
+
+	QString title = m_model->getWindowTitle();
+
+	if (!title.isEmpty())
+	{
+		// search a window with title
+		Window window = getWindowWithTitle(title);
+
+		// if found
+		if (window.id)
+		{
+			// convert to relative coordinates
+			pos -= window.rect.topLeft();
+		}
+		else
+		{
+			qDebug() << "No window with title" << title;
+		}
+	}
+
+	emit mousePositionChanged(pos);
+}
+
+void EditScriptDialog::onPosition()
+{
+	m_ui->positionPushButton->setEnabled(false);
+	m_ui->positionPushButton->setText("???");
+
+	// if cursor is outside window, begin to listen on keys
+	if (!rect().contains(mapFromGlobal(QCursor::pos())))
+	{
+		// reset external listener
+		m_stopExternalListener = 0;
+	}
+}
+
+void EditScriptDialog::onColor()
+{
+	QModelIndex index = m_ui->spotsListView->selectionModel()->currentIndex();
+
+	if (!index.isValid()) return;
+
+	Action spot = m_model->getAction(index.row());
+
+	QColor color = QColorDialog::getColor(QColor(spot.color), this, tr("Pixel color"));
+
+	if (!color.isValid()) return;
+
+	spot.color = color.rgb();
+	m_model->setAction(index.row(), spot);
+
+	setColorButton(spot.color);
+}
+
+void EditScriptDialog::onImage()
+{
+	QModelIndex index = m_ui->spotsListView->selectionModel()->currentIndex();
+
+	if (!index.isValid()) return;
+
+	QStringList extensions;
+
+	for (const QByteArray& format : QImageReader::supportedImageFormats())
+	{
+		extensions << "*." + QString::fromLatin1(format);
+	}
+
+	QString filename = QFileDialog::getOpenFileName(this, tr("Open image"), QString(), tr("Images (%1)").arg(extensions.join(' ')));
+
+	if (filename.isEmpty()) return;
+
+	QImage image(filename);
+
+	if (image.isNull())
+	{
+		QMessageBox::warning(this, tr("Error"), tr("Unable to load image %1.").arg(QDir::toNativeSeparators(filename)));
+		return;
+	}
+
+	// image is saved in script
+	Action spot = m_model->getAction(index.row());
+	spot.image = image.convertToFormat(QImage::Format_RGB32);
+	m_model->setAction(index.row(), spot);
+
+	setImageButton(spot.image);
+}
+
+void EditScriptDialog::onWindowTitleChanged()
+{
+	Window window;
+
+	{
+		CaptureDialog dlg(this);
+
+		if (!dlg.exec()) return;
+
+		window = dlg.getWindow();
+	}
+
+	// don't process window if minimized
+	if (isWindowMinimized(window.id)) return;
+
+	m_model->setWindow(window.title, window.rect.topLeft());
+
+	// only update the push button label
+	setWindowTitleButton(window.title);
+}
+
+void EditScriptDialog::onSelectionChanged(const QItemSelection& selected, const QItemSelection& /* deselected */)
+{
+	QModelIndexList indices = selected.indexes();
+
+	// some actions could still be selected
+	if (indices.isEmpty()) indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+	// update controls
+	m_ui->actionGroupBox->setVisible(!indices.isEmpty());
+
+	if (indices.isEmpty()) return;
+
+	// update controls
+	int row = indices.front().row();
+
+	Action action = m_model->getAction(row);
+
+	// manually update position because not handled by data mapper
+	QPoint pos = action.originalPosition;
+
+	m_ui->positionPushButton->setText(QString("(%1, %2)").arg(pos.x()).arg(pos.y()));
+
+	setColorButton(action.color);
+	setImageButton(action.image);
+
+	onTypeChanged(typeToInt(action.type));
+
+	m_ui->thisActionPushButton->setChecked(row == m_model->getStartFrom());
+}
+
+void EditScriptDialog::onMousePositionChanged(const QPoint& pos)
+{
+	// only when position button is disabled
+	if (m_ui->positionPushButton->isEnabled()) return;
+
+	QModelIndex index = m_ui->spotsListView->selectionModel()->currentIndex();
+
+	// update original and last positions
+	Action spot = m_model->getAction(index.row());
+	spot.lastPosition = pos;
+	spot.originalPosition = pos;
+
+	if (spot.type == Action::Type::WaitPixel)
+	{
+		ScreenImage image;
+
+		// use color under cursor
+		if (captureWindowRegion(0, QRect(QCursor::pos(), QSize(1, 1)), image))
+		{
+			spot.color = image.toImage().pixel(0, 0);
+
+			setColorButton(spot.color);
+		}
+	}
+
+	m_model->setAction(index.row(), spot);
+
+	m_ui->positionPushButton->setEnabled(true);
+	m_ui->positionPushButton->setText(QString("(%1, %2)").arg(pos.x()).arg(pos.y()));
+}
+
+void EditScriptDialog::onTypeChanged(int index)
+{
+	Action::Type type = typeFromInt(index);
+
+	bool hasPath = type == Action::Type::Move || type == Action::Type::Drag;
+
+	m_ui->pathLabel->setVisible(hasPath);
+	m_ui->pathLineEdit->setVisible(hasPath);
+	m_ui->pathShapeLabel->setVisible(hasPath);
+	m_ui->pathShapeComboBox->setVisible(hasPath);
+	m_ui->speedProfileLabel->setVisible(hasPath);
+	m_ui->speedProfileComboBox->setVisible(hasPath);
+	m_ui->sampleRateLabel->setVisible(hasPath);
+	m_ui->sampleRateSpinBox->setVisible(hasPath);
+	m_ui->moveDurationLabel->setVisible(hasPath);
+	m_ui->moveDurationSpinBox->setVisible(hasPath);
+
+	bool hasPixel = type == Action::Type::WaitPixel;
+
+	m_ui->colorLabel->setVisible(hasPixel);
+	m_ui->colorPushButton->setVisible(hasPixel);
+	m_ui->regionSizeLabel->setVisible(hasPixel);
+	m_ui->regionSizeSpinBox->setVisible(hasPixel);
+
+	bool hasImage = type == Action::Type::FindImage;
+
+	m_ui->imageLabel->setVisible(hasImage);
+	m_ui->imagePushButton->setVisible(hasImage);
+	m_ui->searchSizeLabel->setVisible(hasImage);
+	m_ui->searchWidthSpinBox->setVisible(hasImage);
+	m_ui->searchHeightSpinBox->setVisible(hasImage);
+
+	bool isWaiting = hasPixel || hasImage;
+
+	m_ui->toleranceLabel->setVisible(isWaiting);
+	m_ui->toleranceSpinBox->setVisible(isWaiting);
+	m_ui->timeoutLabel->setVisible(isWaiting);
+	m_ui->timeoutSpinBox->setVisible(isWaiting);
+
+	bool hasText = type == Action::Type::Text;
+	bool hasKey = type == Action::Type::KeyPress || type == Action::Type::KeyRelease;
+	bool hasTarget = type == Action::Type::Jump || type == Action::Type::Loop || type == Action::Type::Call;
+
+	m_ui->textLabel->setText(hasText ? tr("Text") : hasKey ? tr("Key") : tr("Target"));
+	m_ui->textLabel->setVisible(hasText || hasKey || hasTarget);
+	m_ui->textLineEdit->setVisible(hasText || hasKey || hasTarget);
+	m_ui->keyDelayLabel->setVisible(hasText);
+	m_ui->keyDelayMinSpinBox->setVisible(hasText);
+	m_ui->keyDelayMaxSpinBox->setVisible(hasText);
+
+	bool hasButton = type == Action::Type::Click || type == Action::Type::Drag || type == Action::Type::FindImage;
+
+	m_ui->buttonLabel->setVisible(hasButton);
+	m_ui->buttonComboBox->setVisible(hasButton);
+
+	bool hasScroll = type == Action::Type::Scroll;
+
+	m_ui->scrollLabel->setVisible(hasScroll);
+	m_ui->scrollXSpinBox->setVisible(hasScroll);
+	m_ui->scrollYSpinBox->setVisible(hasScroll);
+
+	// control actions are not executed
+	bool hasExpression = type != Action::Type::None && type != Action::Type::Repeat && type != Action::Type::Jump &&
+		type != Action::Type::Loop && type != Action::Type::Call && type != Action::Type::Return;
+
+	m_ui->expressionLabel->setVisible(hasExpression);
+	m_ui->expressionLineEdit->setVisible(hasExpression);
+
+	switch (type)
+	{
+	case Action::Type::Repeat:
+	case Action::Type::Loop:
+		m_ui->durationLabel->setVisible(false);
+		m_ui->durationSpinBox->setVisible(false);
+
+		m_ui->positionLabel->setVisible(false);
+		m_ui->positionPushButton->setVisible(false);
+
+		m_ui->countLabel->setVisible(true);
+		m_ui->countSpinBox->setVisible(true);
+
+		break;
+
+	case Action::Type::WaitPixel:
+	case Action::Type::FindImage:
+		m_ui->durationLabel->setVisible(false);
+		m_ui->durationSpinBox->setVisible(false);
+
+		m_ui->positionLabel->setVisible(true);
+		m_ui->positionPushButton->setVisible(true);
+
+		m_ui->countLabel->setVisible(false);
+		m_ui->countSpinBox->setVisible(false);
+
+		break;
+
+	case Action::Type::KeyPress:
+	case Action::Type::KeyRelease:
+	case Action::Type::Text:
+	case Action::Type::Jump:
+	case Action::Type::Call:
+	case Action::Type::Return:
+		m_ui->durationLabel->setVisible(false);
+		m_ui->durationSpinBox->setVisible(false);
+
+		m_ui->positionLabel->setVisible(false);
+		m_ui->positionPushButton->setVisible(false);
+
+		m_ui->countLabel->setVisible(false);
+		m_ui->countSpinBox->setVisible(false);
+
+		break;
+
+	default:
+		m_ui->durationLabel->setVisible(true);
+		m_ui->durationSpinBox->setVisible(true);
+
+		m_ui->positionLabel->setVisible(true);
+		m_ui->positionPushButton->setVisible(true);
+
+		m_ui->countLabel->setVisible(false);
+		m_ui->countSpinBox->setVisible(false);
+	}
+}
+
+void EditScriptDialog::onThisActionClicked()
+{
+	QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+	int row = indices.isEmpty() ? -1 : indices.front().row();
+
+	if (row == -1) return;
+
+	m_model->setStartFrom(row);
+}
+
+void EditScriptDialog::setWindowTitleButton(const QString& title)
+{
+	QFontMetrics fm = m_ui->windowTitlePushButton->fontMetrics();
+	const int usableWidth = qRound(0.9 * m_ui->windowTitlePushButton->width());
+
+	QString elidedText = fm.elidedText(title, Qt::ElideRight, usableWidth);
+	bool elided = (elidedText != title);
+
+	QString text = elided ? elidedText : title;
+
+	if (text.isEmpty()) text = tr("Unknown");
+
+	m_ui->windowTitlePushButton->setText(text);
+}
+
+void EditScriptDialog::setColorButton(QRgb color)
+{
+	QPixmap pixmap(16, 16);
+	pixmap.fill(QColor(color));
+
+	m_ui->colorPushButton->setIcon(QIcon(pixmap));
+	m_ui->colorPushButton->setText(QColor(color).name());
+}
+
+void EditScriptDialog::setImageButton(const QImage& image)
+{
+	if (image.isNull())
+	{
+		m_ui->imagePushButton->setIcon(QIcon());
+		m_ui->imagePushButton->setText(tr("Load image..."));
+	}
+	else
+	{
+		m_ui->imagePushButton->setIcon(QIcon(QPixmap::fromImage(image)));
+		m_ui->imagePushButton->setText(QString("%1x%2").arg(image.width()).arg(image.height()));
+	}
+}
+
+void EditScriptDialog::onUndoStackChanged()
+{
+	m_ui->undoLabel->setText(tr("Undo: %1 / Redo: %2 (%3 KiB)").arg(m_model->getUndoCount()).arg(m_model->getRedoCount()).arg(m_model->getUndoMemoryUsage() / 1024));
+
+	// window title can be restored by undo
+	setWindowTitleButton(m_model->getWindowTitle());
+}
+
+void EditScriptDialog::onRecordToggled(bool checked)
+{
+	if (!checked)
+	{
+		m_recorder->stop();
+
+		// add last action
+		onActionsRecorded();
+
+		m_ui->recordPushButton->setText(tr("Record"));
+		return;
+	}
+
+	QPoint offset;
+
+	QString title = m_model->getWindowTitle();
+
+	// recorded positions are relative to script window
+	if (!title.isEmpty())
+	{
+		Window window = getWindowWithTitle(title);
+
+		if (window.id) offset = window.rect.topLeft();
+	}
+
+	// don't record clicks on this dialog, like the one to stop recording
+	if (!m_recorder->start(offset, frameGeometry()))
+	{
+		QMessageBox::warning(this, tr("Error"), tr("Unable to record mouse events on this system."));
+
+		QSignalBlocker blocker(m_ui->recordPushButton);
+		m_ui->recordPushButton->setChecked(false);
+		return;
+	}
+
+	m_ui->recordPushButton->setText(tr("Stop"));
+}
+
+void EditScriptDialog::onActionsRecorded()
+{
+	QList<Action> actions = m_recorder->takeActions();
+
+	for (int i = 0; i < actions.size(); ++i)
+	{
+		actions[i].name = tr("Action #%1").arg(m_model->rowCount() + i + 1);
+	}
+
+	m_model->appendActions(actions);
+}
+
+bool EditScriptDialog::event(QEvent *e)
+{
+	if (e->type() == QEvent::WindowDeactivate)
+	{
+		emitMousePosition();
+	}
+	else if (e->type() == QEvent::Enter)
+	{
+		m_stopExternalListener = 1;
+	}
+	else if (e->type() == QEvent::LanguageChange)
+	{
+		m_ui->retranslateUi(this);
+	}
+	else if (e->type() == QEvent::WindowStateChange)
+	{
+		if (windowState() & Qt::WindowMinimized)
+		{
+			QTimer::singleShot(250, this, SLOT(onMinimize()));
+		}
+	}
+
+	return QDialog::event(e);
+}
+
+bool EditScriptDialog::eventFilter(QObject *watched, QEvent *e)
+{
+	if (watched == m_ui->spotsListView->viewport() && e->type() == QEvent::Drop)
+	{
+		QDropEvent* dropEvent = static_cast<QDropEvent*>(e);
+
+		// else view would insert copies and then remove each selected range with a different undo level
+		if (dropEvent->source() == m_ui->spotsListView && dropEvent->dropAction() == Qt::MoveAction)
+		{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+			QPoint pos = dropEvent->position().toPoint();
+#else
+			QPoint pos = dropEvent->pos();
+#endif
+
+			// insert before or after the action under cursor
+			QModelIndex index = m_ui->spotsListView->indexAt(pos);
+
+			int destination = m_model->rowCount();
+
+			if (index.isValid())
+			{
+				destination = index.row();
+
+				if (pos.y() > m_ui->spotsListView->visualRect(index).center().y()) ++destination;
+			}
+
+			QModelIndexList indices = m_ui->spotsListView->selectionModel()->selectedRows();
+
+			QList<int> rows;
+
+			for (const QModelIndex& selected : indices) rows << selected.row();
+
+			int first = m_model->moveSelectedRows(rows, destination);
+
+			// select moved actions
+			if (first >= 0)
+			{
+				QItemSelection selection(m_model->index(first, 0), m_model->index(first + rows.size() - 1, 0));
+				m_ui->spotsListView->selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+			}
+
+			// rows have already been moved, view must not remove them
+			dropEvent->setDropAction(Qt::CopyAction);
+			dropEvent->accept();
+
+			return true;
+		}
+	}
+
+	return QDialog::eventFilter(watched, e);
+}
+
+void EditScriptDialog::accept()
+{
+	m_model->setName(m_ui->nameEdit->text());
+
+	QDialog::accept();
+}
@@ -0,0 +1,421 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "expression.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// maximum number of values on the stack, checked when compiling
+static const int s_maximumDepth = 32;
+
+// maximum number of nested parentheses, signs, powers and function calls, so parser doesn't overflow the C++ stack
+static const int s_maximumNesting = 64;
+
+// maximum number of constants, so an index fits in an instruction
+static const int s_maximumConstants = 256;
+
+static const char* s_inputNames[] = { "t", "n", "runs", "row" };
+static const char* s_outputNames[] = { "delay", "x", "y" };
+
+Expression::Expression() :m_outputs(0), m_pos(0), m_depth(0), m_nesting(0)
+{
+}
+
+bool Expression::compile(const QString& source)
+{
+	m_code.clear();
+	m_constants.clear();
+	m_outputs = 0;
+	m_error.clear();
+
+	m_source = source;
+	m_pos = 0;
+	m_depth = 0;
+	m_nesting = 0;
+
+	skipSpaces();
+
+	while (m_pos < m_source.size())
+	{
+		if (!parseStatement()) break;
+
+		skipSpaces();
+
+		if (m_pos < m_source.size() && !accept(';'))
+		{
+			fail(QObject::tr("';' expected"));
+			break;
+		}
+
+		skipSpaces();
+	}
+
+	m_source.clear();
+
+	if (!m_error.isEmpty())
+	{
+		m_code.clear();
+		m_constants.clear();
+		m_outputs = 0;
+
+		return false;
+	}
+
+	m_code.squeeze();
+	m_constants.squeeze();
+
+	return true;
+}
+
+void Expression::evaluate(const double* inputs, double* outputs, QRandomGenerator& random) const
+{
+	double stack[s_maximumDepth];
+	double* top = stack;
+
+	const Instruction* instruction = m_code.constData();
+	const Instruction* end = instruction + m_code.size();
+
+	for (; instruction != end; ++instruction)
+	{
+		switch (instruction->code)
+		{
+			case OpCode::Constant: *top++ = m_constants[instruction->operand]; break;
+			case OpCode::Input: *top++ = inputs[instruction->operand]; break;
+			case OpCode::Store: outputs[instruction->operand] = *--top; break;
+			case OpCode::Add: --top; top[-1] += top[0]; break;
+			case OpCode::Subtract: --top; top[-1] -= top[0]; break;
+			case OpCode::Multiply: --top; top[-1] *= top[0]; break;
+			case OpCode::Divide: --top; top[-1] = top[0] != 0.0 ? top[-1] / top[0] : 0.0; break;
+			case OpCode::Modulo: --top; top[-1] = top[0] != 0.0 ? std::fmod(top[-1], top[0]) : 0.0; break;
+			case OpCode::Power: --top; top[-1] = std::pow(top[-1], top[0]); break;
+			case OpCode::Negate: top[-1] = -top[-1]; break;
+			case OpCode::Sin: top[-1] = std::sin(top[-1]); break;
+			case OpCode::Cos: top[-1] = std::cos(top[-1]); break;
+			case OpCode::Abs: top[-1] = std::fabs(top[-1]); break;
+			case OpCode::Sqrt: top[-1] = std::sqrt(qMax(0.0, top[-1])); break;
+			case OpCode::Floor: top[-1] = std::floor(top[-1]); break;
+			case OpCode::Round: top[-1] = std::round(top[-1]); break;
+			case OpCode::Min: --top; top[-1] = qMin(top[-1], top[0]); break;
+			case OpCode::Max: --top; top[-1] = qMax(top[-1], top[0]); break;
+			case OpCode::Random: --top; top[-1] += (top[0] - top[-1]) * random.generateDouble(); break;
+		}
+	}
+}
+
+bool Expression::parseStatement()
+{
+	QString name = readIdentifier();
+
+	int output = -1;
+
+	for (int i = 0; i < OutputLast; ++i)
+	{
+		if (name == s_outputNames[i]) output = i;
+	}
+
+	if (output < 0) return fail(name.isEmpty() ? QObject::tr("variable expected") : QObject::tr("unknown variable '%1'").arg(name));
+
+	skipSpaces();
+
+	if (!accept('=')) return fail(QObject::tr("'=' expected"));
+
+	if (!parseSum()) return false;
+
+	m_outputs |= 1 << output;
+
+	return append(OpCode::Store, output);
+}
+
+bool Expression::parseSum()
+{
+	if (!parseProduct()) return false;
+
+	for (;;)
+	{
+		skipSpaces();
+
+		if (accept('+'))
+		{
+			if (!parseProduct() || !append(OpCode::Add)) return false;
+		}
+		else if (accept('-'))
+		{
+			if (!parseProduct() || !append(OpCode::Subtract)) return false;
+		}
+		else
+		{
+			return true;
+		}
+	}
+}
+
+bool Expression::parseProduct()
+{
+	if (!parseUnary()) return false;
+
+	for (;;)
+	{
+		skipSpaces();
+
+		if (accept('*'))
+		{
+			if (!parseUnary() || !append(OpCode::Multiply)) return false;
+		}
+		else if (accept('/'))
+		{
+			if (!parseUnary() || !append(OpCode::Divide)) return false;
+		}
+		else if (accept('%'))
+		{
+			if (!parseUnary() || !append(OpCode::Modulo)) return false;
+		}
+		else
+		{
+			return true;
+		}
+	}
+}
+
+bool Expression::parseUnary()
+{
+	// all recursions go through this function
+	if (m_nesting >= s_maximumNesting) return fail(QObject::tr("expression is too complex"));
+
+	++m_nesting;
+
+	bool res;
+
+	skipSpaces();
+
+	if (accept('-'))
+	{
+		res = parseUnary() && append(OpCode::Negate);
+	}
+	else if (accept('+'))
+	{
+		res = parseUnary();
+	}
+	else
+	{
+		res = parsePower();
+	}
+
+	--m_nesting;
+
+	return res;
+}
+
+bool Expression::parsePower()
+{
+	if (!parsePrimary()) return false;
+
+	skipSpaces();
+
+	// right associative, so 2^3^2 is 2^9
+	if (accept('^')) return parseUnary() && append(OpCode::Power);
+
+	return true;
+}
+
+bool Expression::parsePrimary()
+{
+	skipSpaces();
+
+	if (m_pos >= m_source.size()) return fail(QObject::tr("value expected"));
+
+	if (accept('('))
+	{
+		if (!parseSum()) return false;
+
+		skipSpaces();
+
+		return accept(')') || fail(QObject::tr("')' expected"));
+	}
+
+	QChar c = m_source[m_pos];
+
+	if (c.isDigit() || c == '.')
+	{
+		int start = m_pos;
+
+		while (m_pos < m_source.size() && (m_source[m_pos].isDigit() || m_source[m_pos] == '.')) ++m_pos;
+
+		bool ok = false;
+		double value = m_source.mid(start, m_pos - start).toDouble(&ok);
+
+		if (!ok) return fail(QObject::tr("invalid number"));
+
+		return appendConstant(value);
+	}
+
+	QString name = readIdentifier();
+
+	if (name.isEmpty()) return fail(QObject::tr("unexpected character '%1'").arg(c));
+
+	skipSpaces();
+
+	if (accept('(')) return parseFunction(name);
+
+	for (int i = 0; i < InputLast; ++i)
+	{
+		if (name == s_inputNames[i]) return append(OpCode::Input, i);
+	}
+
+	if (name == "pi") return appendConstant(M_PI);
+
+	return fail(QObject::tr("unknown variable '%1'").arg(name));
+}
+
+bool Expression::parseFunction(const QString& name)
+{
+	struct Function
+	{
+		const char* name;
+		OpCode code;
+		int arguments;
+	};
+
+	static const Function s_functions[] =
+	{
+		{ "sin", OpCode::Sin, 1 },
+		{ "cos", OpCode::Cos, 1 },
+		{ "abs", OpCode::Abs, 1 },
+		{ "sqrt", OpCode::Sqrt, 1 },
+		{ "floor", OpCode::Floor, 1 },
+		{ "round", OpCode::Round, 1 },
+		{ "min", OpCode::Min, 2 },
+		{ "max", OpCode::Max, 2 },
+		{ "random", OpCode::Random, 2 }
+	};
+
+	for (const Function& function : s_functions)
+	{
+		if (name != function.name) continue;
+
+		for (int i = 0; i < function.arguments; ++i)
+		{
+			if (i > 0)
+			{
+				skipSpaces();
+
+				if (!accept(',')) return fail(QObject::tr("',' expected"));
+			}
+
+			if (!parseSum()) return false;
+		}
+
+		skipSpaces();
+
+		if (!accept(')')) return fail(QObject::tr("')' expected"));
+
+		return append(function.code);
+	}
+
+	return fail(QObject::tr("unknown function '%1'").arg(name));
+}
+
+void Expression::skipSpaces()
+{
+	while (m_pos < m_source.size() && m_source[m_pos].isSpace()) ++m_pos;
+}
+
+bool Expression::accept(QChar c)
+{
+	if (m_pos >= m_source.size() || m_source[m_pos] != c) return false;
+
+	++m_pos;
+
+	return true;
+}
+
+QString Expression::readIdentifier()
+{
+	skipSpaces();
+
+	int start = m_pos;
+
+	while (m_pos < m_source.size() && (m_source[m_pos].isLetter() || m_source[m_pos] == '_')) ++m_pos;
+
+	return m_source.mid(start, m_pos - start);
+}
+
+bool Expression::append(OpCode code, int operand)
+{
+	// update number of values on the stack
+	switch (code)
+	{
+		case OpCode::Constant:
+		case OpCode::Input:
+		++m_depth;
+		break;
+
+		case OpCode::Store:
+		case OpCode::Add:
+		case OpCode::Subtract:
+		case OpCode::Multiply:
+		case OpCode::Divide:
+		case OpCode::Modulo:
+		case OpCode::Power:
+		case OpCode::Min:
+		case OpCode::Max:
+		case OpCode::Random:
+		--m_depth;
+		break;
+
+		default:
+		break;
+	}
+
+	if (m_depth > s_maximumDepth) return fail(QObject::tr("expression is too complex"));
+
+	Instruction instruction;
+	instruction.code = code;
+	instruction.operand = operand;
+
+	m_code << instruction;
+
+	return true;
+}
+
+bool Expression::appendConstant(double value)
+{
+	// reuse same constant
+	int index = m_constants.indexOf(value);
+
+	if (index < 0)
+	{
+		if (m_constants.size() >= s_maximumConstants) return fail(QObject::tr("too many constants"));
+
+		index = m_constants.size();
+		m_constants << value;
+	}
+
+	return append(OpCode::Constant, index);
+}
+
+bool Expression::fail(const QString& error)
+{
+	// keep first error
+	if (m_error.isEmpty()) m_error = QObject::tr("%1 at position %2").arg(error).arg(m_pos + 1);
+
+	return false;
+}
@@ -0,0 +1,125 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+// Assignments of arithmetic expressions, parsed once and compiled to a
+// bytecode evaluated by a small stack machine without any allocation.
+// Example: "delay = 80 + 20 * sin(t); x = n % 3"
+class Expression
+{
+public:
+	// values which can be read: t (seconds since script start), n (executions of this action),
+	// runs (times the script restarted from first action) and row
+	enum Input
+	{
+		InputTime,
+		InputExecutions,
+		InputRuns,
+		InputRow,
+		InputLast
+	};
+
+	// values which can be assigned: delay (in ms), x and y (offset of position in pixels)
+	enum Output
+	{
+		OutputDelay,
+		OutputX,
+		OutputY,
+		OutputLast
+	};
+
+	Expression();
+
+	// return false and set error if source is invalid
+	bool compile(const QString& source);
+
+	QString getError() const { return m_error; }
+
+	bool isNull() const { return m_code.isEmpty(); }
+
+	bool hasOutput(Output output) const { return (m_outputs & (1 << output)) != 0; }
+
+	// inputs and outputs have InputLast and OutputLast values, outputs not assigned are not modified
+	void evaluate(const double* inputs, double* outputs, QRandomGenerator& random) const;
+
+private:
+	enum class OpCode : quint8
+	{
+		Constant,
+		Input,
+		Store,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Modulo,
+		Power,
+		Negate,
+		Sin,
+		Cos,
+		Abs,
+		Sqrt,
+		Floor,
+		Round,
+		Min,
+		Max,
+		Random
+	};
+
+	struct Instruction
+	{
+		OpCode code;
+
+		// index of constant, input or output
+		quint8 operand;
+	};
+
+	// recursive descent parser, each function emits the instructions of what it parsed
+	bool parseStatement();
+	bool parseSum();
+	bool parseProduct();
+	bool parseUnary();
+	bool parsePower();
+	bool parsePrimary();
+	bool parseFunction(const QString& name);
+
+	void skipSpaces();
+	bool accept(QChar c);
+	QString readIdentifier();
+
+	bool append(OpCode code, int operand = 0);
+	bool appendConstant(double value);
+	bool fail(const QString& error);
+
+	QVector<Instruction> m_code;
+	QVector<double> m_constants;
+
+	int m_outputs;
+
+	// only used while compiling
+	QString m_source;
+	int m_pos;
+	int m_depth;
+	int m_nesting;
+	QString m_error;
+};
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HOTKEYLISTENER_H
+#define HOTKEYLISTENER_H
+
+struct HotkeyListenerData;
+
+// Wait for a global key press in a dedicated thread. The thread is blocked
+// until the system notifies the key, so it never wakes up while idle.
+// keyPressed is only emitted once, listener must be started again after.
+class HotkeyListener : public QObject
+{
+	Q_OBJECT
+
+public:
+	HotkeyListener(QObject* parent);
+	virtual ~HotkeyListener();
+
+	// key is a virtual key returned by QKeySequenceToVK, return false if it can't be listened
+	bool start(int key);
+	void stop();
+
+	bool isListening() const { return m_data != nullptr; }
+
+signals:
+	void keyPressed();
+
+private:
+	// implemented in hotkeylistener_*.cpp
+	bool startListener(int key);
+	void stopListener();
+
+	HotkeyListenerData* m_data;
+};
+
+#endif
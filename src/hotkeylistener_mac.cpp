@@ -0,0 +1,79 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "hotkeylistener.h"
+#include "utils.h"
+
+#ifdef Q_OS_MAC
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// time between 2 checks of key state
+static const int s_pollingInterval = 50;
+
+struct HotkeyListenerData
+{
+	HotkeyListenerData() :stop(0)
+	{
+	}
+
+	QAtomicInt stop;
+
+	QFuture<void> thread;
+};
+
+bool HotkeyListener::startListener(int key)
+{
+	HotkeyListenerData* data = new HotkeyListenerData();
+
+	// not implemented with system events yet, so key state is polled
+	data->thread = QtConcurrent::run([this, data, key]()
+	{
+		while (!data->stop)
+		{
+			if (isKeyPressed(key))
+			{
+				emit keyPressed();
+				return;
+			}
+
+			QThread::msleep(s_pollingInterval);
+		}
+	});
+
+	m_data = data;
+
+	return true;
+}
+
+void HotkeyListener::stopListener()
+{
+	m_data->stop = 1;
+
+	m_data->thread.waitForFinished();
+
+	delete m_data;
+
+	m_data = nullptr;
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "hotkeylistener.h"
+
+#ifdef Q_OS_WIN
+
+#include <windows.h>
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+#ifndef MOD_NOREPEAT
+	#define MOD_NOREPEAT 0x4000
+#endif
+
+// only one hotkey is registered by each thread
+static const int s_hotkeyId = 1;
+
+struct HotkeyListenerData
+{
+	HotkeyListenerData() :threadId(0)
+	{
+	}
+
+	// to post WM_QUIT to listener thread
+	DWORD threadId;
+
+	QFuture<void> thread;
+};
+
+bool HotkeyListener::startListener(int key)
+{
+	HotkeyListenerData* data = new HotkeyListenerData();
+
+	QSemaphore started;
+	bool success = false;
+
+	data->thread = QtConcurrent::run([this, data, key, &started, &success]()
+	{
+		MSG msg;
+
+		// create message queue before stopListener can post WM_QUIT
+		PeekMessageW(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+
+		data->threadId = GetCurrentThreadId();
+
+		// WM_HOTKEY is posted to the thread which registered the hotkey
+		success = RegisterHotKey(NULL, s_hotkeyId, MOD_NOREPEAT, key) != 0;
+
+		started.release();
+
+		if (!success) return;
+
+		bool registered = true;
+
+		// blocked until hotkey is pressed or listener is stopped
+		while (GetMessageW(&msg, NULL, 0, 0) > 0)
+		{
+			if (msg.message == WM_HOTKEY && registered)
+			{
+				// only once, like a click on Start button
+				UnregisterHotKey(NULL, s_hotkeyId);
+				registered = false;
+
+				emit keyPressed();
+			}
+		}
+
+		if (registered) UnregisterHotKey(NULL, s_hotkeyId);
+	});
+
+	started.acquire();
+
+	if (!success)
+	{
+		qDebug() << "Unable to register hotkey" << key;
+
+		data->thread.waitForFinished();
+
+		delete data;
+
+		return false;
+	}
+
+	m_data = data;
+
+	return true;
+}
+
+void HotkeyListener::stopListener()
+{
+	PostThreadMessageW(m_data->threadId, WM_QUIT, 0, 0);
+
+	m_data->thread.waitForFinished();
+
+	delete m_data;
+
+	m_data = nullptr;
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "hotkeylistener.h"
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+struct HotkeyListenerData
+{
+};
+
+bool HotkeyListener::startListener(int key)
+{
+	// keys can't be converted to X11 key codes yet
+	return false;
+}
+
+void HotkeyListener::stopListener()
+{
+}
+
+#endif
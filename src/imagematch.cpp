@@ -0,0 +1,480 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "imagematch.h"
+#include "utils.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define USE_X86_SIMD
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define TARGET_AVX2
+	#else
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// templates smaller than this size are not reduced
+static const int s_minimumTemplateSize = 8;
+
+static const int s_maximumLevels = 4;
+
+// number of best positions found on smallest level refined on larger ones
+static const int s_maximumCandidates = 4;
+
+// number of pixels comparisons above which search is split between threads
+static const qint64 s_parallelThreshold = 1 << 20;
+
+typedef int (*MatchRowFunction)(const quint32* pixels, int count, quint32 color, int tolerance);
+
+// sum of absolute differences of red, green and blue components
+typedef quint32 (*DifferenceRowFunction)(const quint32* pixels1, const quint32* pixels2, int count);
+
+static int matchRowScalar(const quint32* pixels, int count, quint32 color, int tolerance)
+{
+	int res = 0;
+
+	int r = qRed(color), g = qGreen(color), b = qBlue(color);
+
+	for (int i = 0; i < count; ++i)
+	{
+		quint32 pixel = pixels[i];
+
+		if (qAbs(qRed(pixel) - r) <= tolerance && qAbs(qGreen(pixel) - g) <= tolerance && qAbs(qBlue(pixel) - b) <= tolerance) ++res;
+	}
+
+	return res;
+}
+
+static quint32 differenceRowScalar(const quint32* pixels1, const quint32* pixels2, int count)
+{
+	quint32 res = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		quint32 p1 = pixels1[i], p2 = pixels2[i];
+
+		res += qAbs(qRed(p1) - qRed(p2)) + qAbs(qGreen(p1) - qGreen(p2)) + qAbs(qBlue(p1) - qBlue(p2));
+	}
+
+	return res;
+}
+
+#ifdef USE_X86_SIMD
+
+static int popCount(unsigned int value)
+{
+	int res = 0;
+
+	for (; value; value &= value - 1) ++res;
+
+	return res;
+}
+
+// SSE2 is available on all x86_64 CPUs
+static int matchRowSSE2(const quint32* pixels, int count, quint32 color, int tolerance)
+{
+	const __m128i target = _mm_set1_epi32((int)color);
+	const __m128i limit = _mm_set1_epi8((char)tolerance);
+	const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+	const __m128i zero = _mm_setzero_si128();
+
+	int res = 0;
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i values = _mm_loadu_si128((const __m128i*)(pixels + i));
+
+		// |a - b| with saturated unsigned subtractions
+		__m128i diff = _mm_or_si128(_mm_subs_epu8(values, target), _mm_subs_epu8(target, values));
+
+		// not null if difference is greater than tolerance
+		__m128i over = _mm_and_si128(_mm_subs_epu8(diff, limit), rgbMask);
+
+		// one bit per pixel
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(over, zero)));
+
+		res += popCount(mask);
+	}
+
+	return res + matchRowScalar(pixels + i, count - i, color, tolerance);
+}
+
+static quint32 differenceRowSSE2(const quint32* pixels1, const quint32* pixels2, int count)
+{
+	const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+
+	__m128i sum = _mm_setzero_si128();
+
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// alpha is undefined on captured images
+		__m128i values1 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(pixels1 + i)), rgbMask);
+		__m128i values2 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(pixels2 + i)), rgbMask);
+
+		// 2 sums of 8 absolute differences
+		sum = _mm_add_epi64(sum, _mm_sad_epu8(values1, values2));
+	}
+
+	quint32 res = (quint32)_mm_cvtsi128_si32(sum) + (quint32)_mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+
+	return res + differenceRowScalar(pixels1 + i, pixels2 + i, count - i);
+}
+
+TARGET_AVX2 static quint32 differenceRowAVX2(const quint32* pixels1, const quint32* pixels2, int count)
+{
+	const __m256i rgbMask = _mm256_set1_epi32(0x00ffffff);
+
+	__m256i sum = _mm256_setzero_si256();
+
+	int i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i values1 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(pixels1 + i)), rgbMask);
+		__m256i values2 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(pixels2 + i)), rgbMask);
+
+		sum = _mm256_add_epi64(sum, _mm256_sad_epu8(values1, values2));
+	}
+
+	__m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+
+	quint32 res = (quint32)_mm_cvtsi128_si32(sum128) + (quint32)_mm_cvtsi128_si32(_mm_srli_si128(sum128, 8));
+
+	return res + differenceRowSSE2(pixels1 + i, pixels2 + i, count - i);
+}
+
+TARGET_AVX2 static int matchRowAVX2(const quint32* pixels, int count, quint32 color, int tolerance)
+{
+	const __m256i target = _mm256_set1_epi32((int)color);
+	const __m256i limit = _mm256_set1_epi8((char)tolerance);
+	const __m256i rgbMask = _mm256_set1_epi32(0x00ffffff);
+	const __m256i zero = _mm256_setzero_si256();
+
+	int res = 0;
+	int i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i values = _mm256_loadu_si256((const __m256i*)(pixels + i));
+
+		__m256i diff = _mm256_or_si256(_mm256_subs_epu8(values, target), _mm256_subs_epu8(target, values));
+		__m256i over = _mm256_and_si256(_mm256_subs_epu8(diff, limit), rgbMask);
+
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(over, zero)));
+
+		res += popCount(mask);
+	}
+
+	return res + matchRowSSE2(pixels + i, count - i, color, tolerance);
+}
+
+static bool hasAVX2()
+{
+#ifdef _MSC_VER
+	int info[4];
+
+	__cpuid(info, 0);
+
+	if (info[0] < 7) return false;
+
+	__cpuid(info, 1);
+
+	// OS must save YMM registers
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+
+	if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+
+	__cpuidex(info, 7, 0);
+
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+struct MatchImplementation
+{
+	MatchImplementation()
+	{
+#ifdef USE_X86_SIMD
+		if (hasAVX2())
+		{
+			function = matchRowAVX2;
+			differenceFunction = differenceRowAVX2;
+			name = "avx2";
+		}
+		else
+		{
+			function = matchRowSSE2;
+			differenceFunction = differenceRowSSE2;
+			name = "sse2";
+		}
+#else
+		function = matchRowScalar;
+		differenceFunction = differenceRowScalar;
+		name = "scalar";
+#endif
+	}
+
+	MatchRowFunction function;
+	DifferenceRowFunction differenceFunction;
+	const char* name;
+};
+
+// CPU is only checked once
+static const MatchImplementation& getMatchImplementation()
+{
+	static const MatchImplementation s_implementation;
+
+	return s_implementation;
+}
+
+int countMatchingPixels(const ScreenImage& image, QRgb color, int tolerance)
+{
+	if (image.isNull()) return 0;
+
+	MatchRowFunction function = getMatchImplementation().function;
+
+	tolerance = qBound(0, tolerance, 255);
+
+	int res = 0;
+
+	for (int y = 0; y < image.height; ++y)
+	{
+		res += function((const quint32*)(image.bits + y * image.bytesPerLine), image.width, color, tolerance);
+	}
+
+	return res;
+}
+
+// average of 2x2 pixels blocks
+static QImage reduceImage(const QImage& image)
+{
+	int width = image.width() / 2, height = image.height() / 2;
+
+	QImage res(width, height, QImage::Format_RGB32);
+
+	for (int y = 0; y < height; ++y)
+	{
+		const QRgb* src1 = (const QRgb*)image.constScanLine(y * 2);
+		const QRgb* src2 = (const QRgb*)image.constScanLine(y * 2 + 1);
+
+		QRgb* dst = (QRgb*)res.scanLine(y);
+
+		for (int x = 0; x < width; ++x)
+		{
+			QRgb p1 = src1[x * 2], p2 = src1[x * 2 + 1], p3 = src2[x * 2], p4 = src2[x * 2 + 1];
+
+			dst[x] = qRgb((qRed(p1) + qRed(p2) + qRed(p3) + qRed(p4)) / 4,
+				(qGreen(p1) + qGreen(p2) + qGreen(p3) + qGreen(p4)) / 4,
+				(qBlue(p1) + qBlue(p2) + qBlue(p3) + qBlue(p4)) / 4);
+		}
+	}
+
+	return res;
+}
+
+// sum of differences of all pixels of template at pos, stop as soon as it's greater than limit
+static quint32 computeDifference(const QImage& image, const QImage& imageTemplate, const QPoint& pos, quint32 limit)
+{
+	DifferenceRowFunction function = getMatchImplementation().differenceFunction;
+
+	quint32 res = 0;
+
+	for (int y = 0; y < imageTemplate.height() && res <= limit; ++y)
+	{
+		res += function((const quint32*)image.constScanLine(pos.y() + y) + pos.x(), (const quint32*)imageTemplate.constScanLine(y), imageTemplate.width());
+	}
+
+	return res;
+}
+
+struct Candidate
+{
+	Candidate() :difference(UINT_MAX)
+	{
+	}
+
+	bool operator < (const Candidate& other) const { return difference < other.difference; }
+
+	QPoint pos;
+	quint32 difference;
+};
+
+// best position in rows [firstRow, lastRow[
+static Candidate searchRows(const QImage& image, const QImage& imageTemplate, int firstRow, int lastRow)
+{
+	Candidate best;
+
+	int lastColumn = image.width() - imageTemplate.width();
+
+	for (int y = firstRow; y < lastRow; ++y)
+	{
+		for (int x = 0; x <= lastColumn; ++x)
+		{
+			quint32 difference = computeDifference(image, imageTemplate, QPoint(x, y), best.difference);
+
+			if (difference < best.difference)
+			{
+				best.difference = difference;
+				best.pos = QPoint(x, y);
+			}
+		}
+	}
+
+	return best;
+}
+
+// best position around pos
+static Candidate refineCandidate(const QImage& image, const QImage& imageTemplate, const QPoint& pos, int radius)
+{
+	Candidate best;
+
+	int minX = qMax(0, pos.x() - radius), maxX = qMin(image.width() - imageTemplate.width(), pos.x() + radius);
+	int minY = qMax(0, pos.y() - radius), maxY = qMin(image.height() - imageTemplate.height(), pos.y() + radius);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			quint32 difference = computeDifference(image, imageTemplate, QPoint(x, y), best.difference);
+
+			if (difference < best.difference)
+			{
+				best.difference = difference;
+				best.pos = QPoint(x, y);
+			}
+		}
+	}
+
+	return best;
+}
+
+ImageTemplate::ImageTemplate()
+{
+}
+
+ImageTemplate::ImageTemplate(const QImage& image)
+{
+	if (image.isNull()) return;
+
+	m_levels << image.convertToFormat(QImage::Format_RGB32);
+
+	while (m_levels.size() < s_maximumLevels && qMin(m_levels.last().width(), m_levels.last().height()) >= s_minimumTemplateSize * 2)
+	{
+		m_levels << reduceImage(m_levels.last());
+	}
+}
+
+QSize ImageTemplate::size() const
+{
+	return isNull() ? QSize() : m_levels.front().size();
+}
+
+ImageMatch findImage(const ScreenImage& screenImage, const ImageTemplate& imageTemplate)
+{
+	ImageMatch match;
+
+	if (screenImage.isNull() || imageTemplate.isNull()) return match;
+
+	QSize templateSize = imageTemplate.size();
+
+	if (screenImage.width < templateSize.width() || screenImage.height < templateSize.height()) return match;
+
+	// use captured pixels without copy
+	QVector<QImage> levels;
+	levels << QImage(screenImage.bits, screenImage.width, screenImage.height, screenImage.bytesPerLine, QImage::Format_RGB32);
+
+	while (levels.size() < imageTemplate.getLevelsCount())
+	{
+		levels << reduceImage(levels.last());
+	}
+
+	int top = levels.size() - 1;
+
+	const QImage& image = levels[top];
+	const QImage& topTemplate = imageTemplate.getLevel(top);
+
+	int rows = image.height() - topTemplate.height() + 1;
+
+	qint64 comparisons = (qint64)rows * (image.width() - topTemplate.width() + 1) * topTemplate.width() * topTemplate.height();
+
+	// exhaustive search on smallest level
+	QVector<Candidate> candidates;
+
+	if (comparisons > s_parallelThreshold && rows > 1)
+	{
+		// split rows between all cores
+		int chunks = qMin(rows, QThread::idealThreadCount() * 4);
+
+		QVector<QPair<int, int> > ranges;
+
+		for (int i = 0; i < chunks; ++i)
+		{
+			ranges << qMakePair(rows * i / chunks, rows * (i + 1) / chunks);
+		}
+
+		candidates = QtConcurrent::blockingMapped<QVector<Candidate> >(ranges, [&image, &topTemplate](const QPair<int, int>& range)
+		{
+			return searchRows(image, topTemplate, range.first, range.second);
+		});
+
+		std::sort(candidates.begin(), candidates.end());
+
+		if (candidates.size() > s_maximumCandidates) candidates.resize(s_maximumCandidates);
+	}
+	else
+	{
+		candidates << searchRows(image, topTemplate, 0, rows);
+	}
+
+	// refine best candidates on larger levels
+	for (int level = top - 1; level >= 0; --level)
+	{
+		for (Candidate& candidate : candidates)
+		{
+			candidate = refineCandidate(levels[level], imageTemplate.getLevel(level), candidate.pos * 2, 2);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	match.pos = candidates.front().pos;
+	match.difference = (int)(candidates.front().difference / ((quint32)templateSize.width() * templateSize.height() * 3));
+
+	return match;
+}
+
+const char* getImageMatchImplementation()
+{
+	return getMatchImplementation().name;
+}
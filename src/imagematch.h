@@ -0,0 +1,68 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IMAGEMATCH_H
+#define IMAGEMATCH_H
+
+struct ScreenImage;
+
+// return the number of pixels of image whose red, green and blue components
+// differ from color by tolerance or less, alpha is ignored
+int countMatchingPixels(const ScreenImage& image, QRgb color, int tolerance);
+
+// Image to search on screen with its reduced versions.
+// Search starts on smallest versions and is refined on larger ones.
+class ImageTemplate
+{
+public:
+	ImageTemplate();
+	explicit ImageTemplate(const QImage& image);
+
+	bool isNull() const { return m_levels.isEmpty(); }
+	QSize size() const;
+
+	int getLevelsCount() const { return m_levels.size(); }
+	const QImage& getLevel(int level) const { return m_levels[level]; }
+
+private:
+	QVector<QImage> m_levels;
+};
+
+struct ImageMatch
+{
+	ImageMatch() :difference(-1)
+	{
+	}
+
+	bool isValid() const { return difference >= 0; }
+
+	// position of top left corner of template in image
+	QPoint pos;
+
+	// mean difference of each component (0-255)
+	int difference;
+};
+
+// return position where image is the most similar to template
+ImageMatch findImage(const ScreenImage& image, const ImageTemplate& imageTemplate);
+
+// name of the fastest implementation supported by this CPU
+const char* getImageMatchImplementation();
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "latencyhistogram.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+void LatencyHistogram::reset()
+{
+	for (int i = 0; i < s_bucketsCount; ++i) m_counts[i].storeRelease(0);
+
+	m_sum.storeRelease(0);
+	m_minimum.storeRelease(-1);
+	m_maximum.storeRelease(0);
+}
+
+qint64 LatencyHistogram::getBucketMinimum(int bucket)
+{
+	if (bucket < s_subBuckets) return bucket;
+
+	int shift = bucket / s_subBuckets - 1;
+
+	return (qint64)(s_subBuckets + bucket % s_subBuckets) << shift;
+}
+
+qint64 LatencyHistogram::getBucketMaximum(int bucket)
+{
+	if (bucket < s_subBuckets) return bucket;
+
+	int shift = bucket / s_subBuckets - 1;
+
+	return getBucketMinimum(bucket) + (Q_INT64_C(1) << shift) - 1;
+}
+
+qint64 LatencyHistogram::getCount() const
+{
+	qint64 count = 0;
+
+	for (int i = 0; i < s_bucketsCount; ++i) count += m_counts[i].loadAcquire();
+
+	return count;
+}
+
+qint64 LatencyHistogram::getMinimum() const
+{
+	return qMax(Q_INT64_C(0), m_minimum.loadAcquire());
+}
+
+qint64 LatencyHistogram::getMaximum() const
+{
+	return m_maximum.loadAcquire();
+}
+
+double LatencyHistogram::getMean() const
+{
+	qint64 count = getCount();
+
+	return count > 0 ? (double)m_sum.loadAcquire() / count : 0.0;
+}
+
+qint64 LatencyHistogram::getSum() const
+{
+	return m_sum.loadAcquire();
+}
+
+qint64 LatencyHistogram::getPercentile(double percent) const
+{
+	qint64 count = getCount();
+
+	if (count == 0) return 0;
+
+	qint64 rank = qMax(Q_INT64_C(1), (qint64)qCeil(count * percent / 100.0));
+	qint64 total = 0;
+
+	for (int i = 0; i < s_bucketsCount; ++i)
+	{
+		total += m_counts[i].loadAcquire();
+
+		// values can't be greater than maximum
+		if (total >= rank) return qMin(getBucketMaximum(i), getMaximum());
+	}
+
+	return getMaximum();
+}
+
+QString LatencyHistogram::toString() const
+{
+	return QString("count %1, min %2, p50 %3, p90 %4, p99 %5, p99.9 %6, max %7, mean %8").arg(getCount()).arg(getMinimum())
+		.arg(getPercentile(50.0)).arg(getPercentile(90.0)).arg(getPercentile(99.0)).arg(getPercentile(99.9)).arg(getMaximum()).arg(getMean(), 0, 'f', 1);
+}
+
+QString LatencyHistogram::getBucketsString() const
+{
+	QString res;
+
+	for (int i = 0; i < s_bucketsCount; ++i)
+	{
+		int count = m_counts[i].loadAcquire();
+
+		if (count > 0) res += QString("%1-%2: %3\n").arg(getBucketMinimum(i)).arg(getBucketMaximum(i)).arg(count);
+	}
+
+	return res;
+}
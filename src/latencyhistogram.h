@@ -0,0 +1,100 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+// Histogram of durations in µs with buckets growing exponentially, so the error
+// is less than 1/16 of the value whatever its magnitude (like HdrHistogram).
+// Only one thread can add values but any thread can read them at the same time.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	// only call it when no value is added
+	void reset();
+
+	// negative values are counted as 0
+	void add(qint64 value)
+	{
+		if (value < 0) value = 0;
+
+		m_counts[getBucket(value)].fetchAndAddRelaxed(1);
+		m_sum.fetchAndAddRelaxed(value);
+
+		// only one writer, so no need to compare and swap
+		if (value > m_maximum.loadAcquire()) m_maximum.storeRelease(value);
+		if (m_minimum.loadAcquire() < 0 || value < m_minimum.loadAcquire()) m_minimum.storeRelease(value);
+	}
+
+	qint64 getCount() const;
+
+	// 0 if no values
+	qint64 getMinimum() const;
+	qint64 getMaximum() const;
+	double getMean() const;
+
+	// sum of all values
+	qint64 getSum() const;
+
+	// smallest value greater or equal to percent % of values, with the error of its bucket
+	qint64 getPercentile(double percent) const;
+
+	// count, minimum, percentiles, maximum and mean on one line
+	QString toString() const;
+
+	// one line per non-empty bucket with its range and count
+	QString getBucketsString() const;
+
+private:
+	static int getBucket(qint64 value)
+	{
+		if (value >= s_maximumValue) value = s_maximumValue - 1;
+
+		if (value < s_subBuckets) return (int)value;
+
+		// position of most significant bit, at least s_subBucketBits
+		int exponent = 63 - qCountLeadingZeroBits((quint64)value);
+		int shift = exponent - s_subBucketBits;
+
+		return (shift + 1) * s_subBuckets + (int)(value >> shift) - s_subBuckets;
+	}
+
+	// range of values counted in a bucket
+	static qint64 getBucketMinimum(int bucket);
+	static qint64 getBucketMaximum(int bucket);
+
+	static const int s_subBucketBits = 4;
+	static const int s_subBuckets = 1 << s_subBucketBits;
+
+	// larger values are counted in last bucket, about 25 days
+	static const int s_maximumExponent = 41;
+	static const qint64 s_maximumValue = Q_INT64_C(1) << s_maximumExponent;
+	static const int s_bucketsCount = (s_maximumExponent - s_subBucketBits + 1) * s_subBuckets;
+
+	QAtomicInt m_counts[s_bucketsCount];
+	QAtomicInteger<qint64> m_sum;
+
+	// -1 if no values
+	QAtomicInteger<qint64> m_minimum;
+	QAtomicInteger<qint64> m_maximum;
+};
+
+#endif
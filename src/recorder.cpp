@@ -0,0 +1,228 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "recorder.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// delay after the last recorded click
+static const int s_defaultDelay = 150;
+
+// below this distance in pixels, a mouse motion is ignored
+static const int s_minimumDragDistance = 4;
+
+// timestamps are 32 bits milliseconds counters on all systems, so they can wrap
+static int elapsed(qint64 from, qint64 to)
+{
+	return (int)(quint32)(to - from);
+}
+
+Recorder::Recorder(QObject* parent) :QObject(parent), m_eventsCount(0), m_droppedEventsCount(0), m_stopCompressor(1),
+	m_listener(nullptr), m_pressed(false), m_lastReleaseTime(0), m_hasPendingAction(false)
+{
+}
+
+Recorder::~Recorder()
+{
+	stop();
+}
+
+bool Recorder::start(const QPoint& offset, const QRect& ignoredRect)
+{
+	if (isRecording()) return false;
+
+	m_offset = offset;
+	m_ignoredRect = ignoredRect;
+	m_pressed = false;
+	m_lastReleaseTime = 0;
+	m_hasPendingAction = false;
+
+	m_events.clear();
+	m_eventsCount = 0;
+	m_droppedEventsCount = 0;
+
+	if (!startListener()) return false;
+
+	m_stopCompressor = 0;
+	m_compressor = QtConcurrent::run(&Recorder::compress, this);
+
+	return true;
+}
+
+void Recorder::stop()
+{
+	if (!isRecording()) return;
+
+	// no more events will be pushed after that
+	stopListener();
+
+	// compressor processes remaining events before leaving
+	m_stopCompressor = 1;
+	m_eventsAvailable.release();
+	m_compressor.waitForFinished();
+
+	if (m_hasPendingAction) flushPendingAction(s_defaultDelay);
+}
+
+bool Recorder::isRecording() const
+{
+	return m_listener != nullptr;
+}
+
+QList<Action> Recorder::takeActions()
+{
+	QMutexLocker locker(&m_actionsMutex);
+
+	QList<Action> actions;
+	actions.swap(m_actions);
+
+	return actions;
+}
+
+int Recorder::getEventsCount() const
+{
+	return m_eventsCount;
+}
+
+int Recorder::getDroppedEventsCount() const
+{
+	return m_droppedEventsCount;
+}
+
+void Recorder::pushEvent(const RecordedEvent& event)
+{
+	// we can't wait for compressor, so we prefer to lose an event
+	if (m_events.push(event))
+	{
+		m_eventsCount.ref();
+		m_eventsAvailable.release();
+	}
+	else
+	{
+		m_droppedEventsCount.ref();
+	}
+}
+
+void Recorder::compress()
+{
+	RecordedEvent event;
+
+	for(;;)
+	{
+		// released once per event and once when stopping
+		m_eventsAvailable.acquire();
+
+		if (m_events.pop(event))
+		{
+			processEvent(event);
+		}
+		else if (m_stopCompressor)
+		{
+			// all events have been processed
+			break;
+		}
+	}
+}
+
+void Recorder::processEvent(const RecordedEvent& event)
+{
+	if (event.type == RecordedEvent::Type::Motion)
+	{
+		// only motions with a button pressed are part of a drag
+		if (!m_pressed) return;
+
+		QPoint last = m_dragPath.isEmpty() ? m_press.pos : m_dragPath.last();
+
+		// don't keep all positions received from a 1000 Hz mouse
+		if ((event.pos - last).manhattanLength() >= s_minimumDragDistance) m_dragPath << event.pos;
+
+		return;
+	}
+
+	// only left (1), middle (2) and right (3) buttons are converted to actions, not wheel
+	if (event.button < 1 || event.button > 3) return;
+
+	if (event.type == RecordedEvent::Type::ButtonPress)
+	{
+		if (m_pressed) return;
+
+		m_pressed = true;
+		m_press = event;
+		m_dragPath.clear();
+
+		// clicks on kClicker window are not part of the script
+		if (m_ignoredRect.contains(event.pos)) return;
+
+		// now we know the delay of previous action
+		if (m_hasPendingAction) flushPendingAction(elapsed(m_lastReleaseTime, event.time));
+	}
+	else
+	{
+		if (!m_pressed || event.button != m_press.button) return;
+
+		m_pressed = false;
+
+		if (m_ignoredRect.contains(m_press.pos)) return;
+
+		Action action;
+		action.originalPosition = m_press.pos - m_offset;
+		action.lastPosition = action.originalPosition;
+		action.button = (Action::Button)(m_press.button - 1);
+
+		if ((event.pos - m_press.pos).manhattanLength() < s_minimumDragDistance)
+		{
+			action.type = Action::Type::Click;
+		}
+		else
+		{
+			action.type = Action::Type::Drag;
+			action.moveDuration = elapsed(m_press.time, event.time);
+
+			if (m_dragPath.isEmpty() || m_dragPath.last() != event.pos) m_dragPath << event.pos;
+
+			for (const QPoint& point : m_dragPath)
+			{
+				action.path << point - m_offset;
+			}
+		}
+
+		m_pendingAction = action;
+		m_hasPendingAction = true;
+		m_lastReleaseTime = event.time;
+	}
+}
+
+void Recorder::flushPendingAction(int delay)
+{
+	m_pendingAction.delayMin = delay;
+	m_pendingAction.delayMax = delay;
+
+	m_hasPendingAction = false;
+
+	{
+		QMutexLocker locker(&m_actionsMutex);
+
+		m_actions << m_pendingAction;
+	}
+
+	emit actionsRecorded();
+}
@@ -0,0 +1,121 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "action.h"
+#include "ringbuffer.h"
+
+struct RecorderListener;
+
+// Raw mouse event received from the system
+struct RecordedEvent
+{
+	enum class Type : quint8
+	{
+		Motion,
+		ButtonPress,
+		ButtonRelease
+	};
+
+	RecordedEvent() :type(Type::Motion), button(0), time(0)
+	{
+	}
+
+	Type type;
+
+	// 1 = left, 2 = middle, 3 = right
+	quint8 button;
+
+	// absolute coordinates
+	QPoint pos;
+
+	// in ms, only differences between events are meaningful
+	qint64 time;
+};
+
+// Record global mouse events and convert them to actions.
+// Events are received by a system hook in a dedicated thread, pushed in a
+// lock-free ring buffer and converted to Click or Drag actions in a background thread,
+// so the hook never waits for the conversion or the GUI.
+class Recorder : public QObject
+{
+	Q_OBJECT
+
+public:
+	Recorder(QObject* parent);
+	virtual ~Recorder();
+
+	// offset is subtracted from recorded positions and clicks in ignoredRect are discarded
+	bool start(const QPoint& offset, const QRect& ignoredRect);
+	void stop();
+
+	bool isRecording() const;
+
+	// return actions converted since last call
+	QList<Action> takeActions();
+
+	int getEventsCount() const;
+	int getDroppedEventsCount() const;
+
+	// called by system hook, must never block
+	void pushEvent(const RecordedEvent& event);
+
+signals:
+	void actionsRecorded();
+
+private:
+	// implemented in recorder_*.cpp
+	bool startListener();
+	void stopListener();
+
+	void compress();
+	void processEvent(const RecordedEvent& event);
+	void flushPendingAction(int delay);
+
+	// 1000 Hz mice can fill 16 s of events if converter is late
+	RingBuffer<RecordedEvent, 16384> m_events;
+
+	QAtomicInt m_eventsCount;
+	QAtomicInt m_droppedEventsCount;
+	QAtomicInt m_stopCompressor;
+
+	// compressor sleeps until an event is pushed or it's stopped
+	QSemaphore m_eventsAvailable;
+
+	RecorderListener* m_listener;
+	QFuture<void> m_compressor;
+
+	// only used by compressor thread
+	QPoint m_offset;
+	QRect m_ignoredRect;
+	bool m_pressed;
+	RecordedEvent m_press;
+	QVector<QPoint> m_dragPath;
+	qint64 m_lastReleaseTime;
+	bool m_hasPendingAction;
+	Action m_pendingAction;
+
+	// converted actions not yet retrieved by GUI
+	QMutex m_actionsMutex;
+	QList<Action> m_actions;
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "recorder.h"
+
+#ifdef Q_OS_WIN
+
+#include <windows.h>
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+struct RecorderListener
+{
+	RecorderListener() :threadId(0)
+	{
+	}
+
+	// to post WM_QUIT to hook thread
+	DWORD threadId;
+
+	QFuture<void> thread;
+};
+
+// low level hooks don't have a user parameter
+static Recorder* s_recorder = nullptr;
+
+static LRESULT CALLBACK mouseHookProc(int code, WPARAM wParam, LPARAM lParam)
+{
+	if (code == HC_ACTION && s_recorder)
+	{
+		const MSLLHOOKSTRUCT* data = (const MSLLHOOKSTRUCT*)lParam;
+
+		// ignore clicks sent by kClicker or other programs
+		if (!(data->flags & LLMHF_INJECTED))
+		{
+			RecordedEvent event;
+			event.pos = QPoint(data->pt.x, data->pt.y);
+			event.time = data->time;
+
+			switch (wParam)
+			{
+				case WM_LBUTTONDOWN:
+				case WM_MBUTTONDOWN:
+				case WM_RBUTTONDOWN:
+				event.type = RecordedEvent::Type::ButtonPress;
+				break;
+
+				case WM_LBUTTONUP:
+				case WM_MBUTTONUP:
+				case WM_RBUTTONUP:
+				event.type = RecordedEvent::Type::ButtonRelease;
+				break;
+
+				default:
+				event.type = RecordedEvent::Type::Motion;
+			}
+
+			switch (wParam)
+			{
+				case WM_LBUTTONDOWN:
+				case WM_LBUTTONUP:
+				event.button = 1;
+				break;
+
+				case WM_MBUTTONDOWN:
+				case WM_MBUTTONUP:
+				event.button = 2;
+				break;
+
+				case WM_RBUTTONDOWN:
+				case WM_RBUTTONUP:
+				event.button = 3;
+				break;
+			}
+
+			s_recorder->pushEvent(event);
+		}
+	}
+
+	return CallNextHookEx(NULL, code, wParam, lParam);
+}
+
+bool Recorder::startListener()
+{
+	if (s_recorder) return false;
+
+	RecorderListener* listener = new RecorderListener();
+
+	QSemaphore started;
+	bool success = false;
+
+	s_recorder = this;
+
+	listener->thread = QtConcurrent::run([listener, &started, &success]()
+	{
+		// hook is called in the thread which installed it, so it needs a message loop
+		HHOOK hook = SetWindowsHookExW(WH_MOUSE_LL, mouseHookProc, GetModuleHandleW(NULL), 0);
+
+		MSG msg;
+
+		// create message queue before stopListener can post WM_QUIT
+		PeekMessageW(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+
+		listener->threadId = GetCurrentThreadId();
+		success = hook != NULL;
+
+		started.release();
+
+		if (!hook) return;
+
+		while (GetMessageW(&msg, NULL, 0, 0) > 0)
+		{
+			TranslateMessage(&msg);
+			DispatchMessageW(&msg);
+		}
+
+		UnhookWindowsHookEx(hook);
+	});
+
+	started.acquire();
+
+	if (!success)
+	{
+		qDebug() << "Unable to install mouse hook";
+
+		listener->thread.waitForFinished();
+
+		delete listener;
+
+		s_recorder = nullptr;
+
+		return false;
+	}
+
+	m_listener = listener;
+
+	return true;
+}
+
+void Recorder::stopListener()
+{
+	if (!m_listener) return;
+
+	PostThreadMessageW(m_listener->threadId, WM_QUIT, 0, 0);
+
+	m_listener->thread.waitForFinished();
+
+	delete m_listener;
+
+	m_listener = nullptr;
+
+	s_recorder = nullptr;
+}
+
+#endif
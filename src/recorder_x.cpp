@@ -0,0 +1,151 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "recorder.h"
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+struct RecorderListener
+{
+	RecorderListener() :controlDisplay(nullptr), dataDisplay(nullptr), context(0)
+	{
+	}
+
+	// XRecordEnableContext blocks its display, so we need another one to stop it
+	Display* controlDisplay;
+	Display* dataDisplay;
+
+	XRecordContext context;
+
+	QFuture<void> thread;
+};
+
+static void recordCallback(XPointer closure, XRecordInterceptData* data)
+{
+	if (data->category == XRecordFromServer)
+	{
+		const xEvent* xevent = (const xEvent*)data->data;
+
+		RecordedEvent event;
+		event.button = xevent->u.u.detail;
+		event.pos = QPoint(xevent->u.keyButtonPointer.rootX, xevent->u.keyButtonPointer.rootY);
+		event.time = xevent->u.keyButtonPointer.time;
+
+		switch (xevent->u.u.type & 0x7f)
+		{
+			case ButtonPress:
+			event.type = RecordedEvent::Type::ButtonPress;
+			break;
+
+			case ButtonRelease:
+			event.type = RecordedEvent::Type::ButtonRelease;
+			break;
+
+			default:
+			event.type = RecordedEvent::Type::Motion;
+			event.button = 0;
+		}
+
+		((Recorder*)closure)->pushEvent(event);
+	}
+
+	XRecordFreeData(data);
+}
+
+static void closeListener(RecorderListener* listener)
+{
+	if (listener->context) XRecordFreeContext(listener->controlDisplay, listener->context);
+	if (listener->dataDisplay) XCloseDisplay(listener->dataDisplay);
+	if (listener->controlDisplay) XCloseDisplay(listener->controlDisplay);
+
+	delete listener;
+}
+
+bool Recorder::startListener()
+{
+	RecorderListener* listener = new RecorderListener();
+
+	listener->controlDisplay = XOpenDisplay(nullptr);
+	listener->dataDisplay = XOpenDisplay(nullptr);
+
+	int major = 0, minor = 0;
+
+	if (!listener->controlDisplay || !listener->dataDisplay || !XRecordQueryVersion(listener->controlDisplay, &major, &minor))
+	{
+		qDebug() << "RECORD extension is not available";
+
+		closeListener(listener);
+		return false;
+	}
+
+	// only mouse events are needed
+	XRecordRange* range = XRecordAllocRange();
+	range->device_events.first = ButtonPress;
+	range->device_events.last = MotionNotify;
+
+	XRecordClientSpec clients = XRecordAllClients;
+
+	listener->context = XRecordCreateContext(listener->controlDisplay, 0, &clients, 1, &range, 1);
+
+	XFree(range);
+
+	if (!listener->context)
+	{
+		closeListener(listener);
+		return false;
+	}
+
+	// context must be known by server before enabling it on the other display
+	XSync(listener->controlDisplay, False);
+
+	listener->thread = QtConcurrent::run([listener, this]()
+	{
+		// returns when context is disabled
+		XRecordEnableContext(listener->dataDisplay, listener->context, recordCallback, (XPointer)this);
+	});
+
+	m_listener = listener;
+
+	return true;
+}
+
+void Recorder::stopListener()
+{
+	if (!m_listener) return;
+
+	XRecordDisableContext(m_listener->controlDisplay, m_listener->context);
+	XSync(m_listener->controlDisplay, False);
+
+	m_listener->thread.waitForFinished();
+
+	closeListener(m_listener);
+
+	m_listener = nullptr;
+}
+
+#endif
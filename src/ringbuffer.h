@@ -0,0 +1,84 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+// Lock-free ring buffer with a single producer and a single consumer.
+// N must be a power of 2, the buffer can contain N - 1 items.
+template<typename T, int N>
+class RingBuffer
+{
+public:
+	RingBuffer() :m_head(0), m_tail(0)
+	{
+		static_assert((N & (N - 1)) == 0, "N must be a power of 2");
+	}
+
+	// only called by producer, return false if buffer is full
+	bool push(const T& value)
+	{
+		int head = m_head.loadAcquire();
+		int next = (head + 1) & (N - 1);
+
+		if (next == m_tail.loadAcquire()) return false;
+
+		m_items[head] = value;
+
+		// publish item to consumer
+		m_head.storeRelease(next);
+
+		return true;
+	}
+
+	// only called by consumer, return false if buffer is empty
+	bool pop(T& value)
+	{
+		int tail = m_tail.loadAcquire();
+
+		if (tail == m_head.loadAcquire()) return false;
+
+		value = m_items[tail];
+
+		// give slot back to producer
+		m_tail.storeRelease((tail + 1) & (N - 1));
+
+		return true;
+	}
+
+	bool isEmpty() const
+	{
+		return m_tail.loadAcquire() == m_head.loadAcquire();
+	}
+
+	void clear()
+	{
+		m_head.storeRelease(0);
+		m_tail.storeRelease(0);
+	}
+
+private:
+	// head and tail are modified by different threads, keep them on different cache lines
+	alignas(64) QAtomicInt m_head;
+	alignas(64) QAtomicInt m_tail;
+
+	alignas(64) T m_items[N];
+};
+
+#endif
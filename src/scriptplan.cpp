@@ -0,0 +1,401 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "scriptplan.h"
+#include "actionmodel.h"
+#include "clicker.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// number of segments used to approximate a Bezier curve between 2 control points
+static const int s_bezierSteps = 32;
+
+static const int s_maximumSampleRate = 1000;
+
+// number of nested calls before considering it's an infinite recursion
+static const int s_maximumCallDepth = 1024;
+
+// number of consecutive jumps before considering no action will ever be executed
+static const int s_maximumJumps = 1 << 20;
+
+// return distance ratio for time ratio t
+static qreal applySpeedProfile(Action::SpeedProfile profile, qreal t)
+{
+	if (profile == Action::SpeedProfile::Constant) return t;
+
+	// minimum jerk, like a human hand
+	return t * t * t * (10.0 + t * (-15.0 + t * 6.0));
+}
+
+static QPointF computeBezierPoint(QVector<QPointF>& points, qreal t)
+{
+	// De Casteljau algorithm, points are modified
+	for (int n = points.size() - 1; n > 0; --n)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			points[i] += (points[i + 1] - points[i]) * t;
+		}
+	}
+
+	return points[0];
+}
+
+ScriptPlan::ScriptPlan() :m_invalidTargetRow(-1), m_invalidExpressionRow(-1)
+{
+}
+
+void ScriptPlan::compile(const ActionModel* model, ClickerBackend* backend)
+{
+	m_paths.clear();
+	m_samples.clear();
+	m_imageTemplates.clear();
+	m_keys.clear();
+	m_keyStrokes.clear();
+	m_jumps.clear();
+	m_loopRows.clear();
+	m_invalidTargetRow = -1;
+	m_expressions.clear();
+	m_invalidExpressionRow = -1;
+	m_expressionError.clear();
+
+	int rows = model ? model->rowCount() : 0;
+
+	m_paths.resize(rows);
+	m_imageTemplates.resize(rows);
+	m_keys.resize(rows);
+	m_jumps.resize(rows);
+	m_expressions.resize(rows);
+
+	// targets are actions names, first one is used if several actions have the same name
+	QHash<QString, int> labels;
+
+	for (int row = rows - 1; row >= 0; --row)
+	{
+		QString name = model->getAction(row).name;
+
+		if (!name.isEmpty()) labels[name] = row;
+	}
+
+	for (int row = 0; row < rows; ++row)
+	{
+		Action action = model->getAction(row);
+
+		Path& path = m_paths[row];
+		path.first = m_samples.size();
+		path.count = 0;
+		path.period = 0;
+
+		Keys& keys = m_keys[row];
+		keys.first = m_keyStrokes.size();
+		keys.count = 0;
+
+		Jump& jump = m_jumps[row];
+		jump.type = Action::Type::None;
+		jump.target = -1;
+		jump.count = 0;
+
+		// parsed once, only bytecode is evaluated by clicker
+		if (!action.expression.isEmpty() && !m_expressions[row].compile(action.expression) && m_invalidExpressionRow < 0)
+		{
+			m_invalidExpressionRow = row;
+			m_expressionError = m_expressions[row].getError();
+		}
+
+		if (action.type == Action::Type::Repeat)
+		{
+			// same as a loop on first action
+			jump.type = Action::Type::Loop;
+			jump.target = 0;
+			jump.count = action.originalCount;
+
+			m_loopRows << row;
+			continue;
+		}
+
+		if (action.type == Action::Type::Jump || action.type == Action::Type::Loop || action.type == Action::Type::Call)
+		{
+			jump.type = action.type;
+			jump.target = labels.value(action.text, -1);
+			jump.count = action.originalCount;
+
+			if (action.type == Action::Type::Loop) m_loopRows << row;
+
+			if (jump.target < 0 && m_invalidTargetRow < 0) m_invalidTargetRow = row;
+
+			continue;
+		}
+
+		if (action.type == Action::Type::Return)
+		{
+			jump.type = action.type;
+			continue;
+		}
+
+		if (action.type == Action::Type::KeyPress || action.type == Action::Type::KeyRelease)
+		{
+			m_keyStrokes << backend->getKeyStroke(action.text);
+			keys.count = 1;
+			continue;
+		}
+
+		if (action.type == Action::Type::Text)
+		{
+			// looking up keysyms is slow, so it's only done once
+			QVector<KeyStroke> strokes = backend->getKeyStrokes(action.text);
+
+			keys.count = strokes.size();
+			m_keyStrokes += strokes;
+			continue;
+		}
+
+		if (action.type == Action::Type::FindImage)
+		{
+			m_imageTemplates[row] = ImageTemplate(action.image);
+			continue;
+		}
+
+		if (action.type != Action::Type::Move && action.type != Action::Type::Drag) continue;
+
+		QVector<QPoint> samples = computeSamples(action);
+
+		path.count = samples.size();
+		path.period = path.count > 1 ? (qint64)action.moveDuration * 1000 / (path.count - 1) : 0;
+
+		m_samples += samples;
+	}
+}
+
+const QPoint* ScriptPlan::getSamples(int row) const
+{
+	if (row < 0 || row >= m_paths.size() || !m_paths[row].count) return nullptr;
+
+	return m_samples.constData() + m_paths[row].first;
+}
+
+int ScriptPlan::getSamplesCount(int row) const
+{
+	if (row < 0 || row >= m_paths.size()) return 0;
+
+	return m_paths[row].count;
+}
+
+qint64 ScriptPlan::getSamplePeriod(int row) const
+{
+	if (row < 0 || row >= m_paths.size()) return 0;
+
+	return m_paths[row].period;
+}
+
+void ScriptPlan::resetRegisters(Registers& registers) const
+{
+	// counters of other actions are never used
+	registers.counters.fill(0, m_jumps.size());
+
+	restartRegisters(registers);
+
+	registers.executions.fill(0, m_jumps.size());
+	registers.runs = 0;
+}
+
+void ScriptPlan::restartRegisters(Registers& registers) const
+{
+	for (int row : m_loopRows)
+	{
+		registers.counters[row] = m_jumps[row].count;
+	}
+
+	// no allocation during calls
+	registers.returnRows.reserve(s_maximumCallDepth);
+	registers.returnRows.clear();
+}
+
+int ScriptPlan::resolveRow(int row, Registers& registers) const
+{
+	int rows = m_jumps.size();
+
+	if (row < 0 || registers.counters.size() != rows) return -1;
+
+	for (int i = 0; i < s_maximumJumps; ++i)
+	{
+		// last action, restart from first one
+		if (row >= rows)
+		{
+			if (rows == 0) return -1;
+
+			restartRegisters(registers);
+
+			++registers.runs;
+
+			row = 0;
+		}
+
+		const Jump& jump = m_jumps[row];
+
+		switch (jump.type)
+		{
+			case Action::Type::Jump:
+			row = jump.target;
+			break;
+
+			case Action::Type::Loop:
+			if (registers.counters[row] > 0)
+			{
+				--registers.counters[row];
+
+				row = jump.target;
+			}
+			else
+			{
+				// loop can be executed again by an outer loop
+				registers.counters[row] = jump.count;
+
+				++row;
+			}
+			break;
+
+			case Action::Type::Call:
+			if (registers.returnRows.size() >= s_maximumCallDepth) return -1;
+
+			registers.returnRows << row + 1;
+
+			row = jump.target;
+			break;
+
+			case Action::Type::Return:
+			// return without call ends the script
+			row = registers.returnRows.isEmpty() ? rows : registers.returnRows.takeLast();
+			break;
+
+			default:
+			return row;
+		}
+
+		// invalid target
+		if (row < 0) return -1;
+	}
+
+	// infinite loop without any action to execute
+	return -1;
+}
+
+const Expression& ScriptPlan::getExpression(int row) const
+{
+	static const Expression s_nullExpression;
+
+	if (row < 0 || row >= m_expressions.size()) return s_nullExpression;
+
+	return m_expressions[row];
+}
+
+const KeyStroke* ScriptPlan::getKeyStrokes(int row) const
+{
+	if (row < 0 || row >= m_keys.size() || !m_keys[row].count) return nullptr;
+
+	return m_keyStrokes.constData() + m_keys[row].first;
+}
+
+int ScriptPlan::getKeyStrokesCount(int row) const
+{
+	if (row < 0 || row >= m_keys.size()) return 0;
+
+	return m_keys[row].count;
+}
+
+const ImageTemplate& ScriptPlan::getImageTemplate(int row) const
+{
+	static const ImageTemplate s_nullTemplate;
+
+	if (row < 0 || row >= m_imageTemplates.size()) return s_nullTemplate;
+
+	return m_imageTemplates[row];
+}
+
+QVector<QPoint> ScriptPlan::computeSamples(const Action& action)
+{
+	QVector<QPointF> points;
+	points.reserve(action.path.size() + 1);
+	points << action.originalPosition;
+
+	for (const QPoint& point : action.path) points << point;
+
+	QVector<QPoint> samples;
+
+	if (points.size() < 2)
+	{
+		samples << action.originalPosition;
+		return samples;
+	}
+
+	if (action.pathShape == Action::PathShape::Bezier && points.size() > 2)
+	{
+		// approximate curve with a polyline
+		int steps = s_bezierSteps * (points.size() - 1);
+
+		QVector<QPointF> curve;
+		curve.reserve(steps + 1);
+
+		QVector<QPointF> tmp;
+
+		for (int i = 0; i <= steps; ++i)
+		{
+			tmp = points;
+
+			curve << computeBezierPoint(tmp, (qreal)i / steps);
+		}
+
+		points = curve;
+	}
+
+	// distance from first point
+	QVector<qreal> distances(points.size());
+	distances[0] = 0.0;
+
+	for (int i = 1; i < points.size(); ++i)
+	{
+		distances[i] = distances[i - 1] + QLineF(points[i - 1], points[i]).length();
+	}
+
+	qreal length = distances.last();
+
+	int sampleRate = qBound(1, action.sampleRate, s_maximumSampleRate);
+	int count = qMax(2, (int)((qint64)qMax(0, action.moveDuration) * sampleRate / 1000) + 1);
+
+	samples.reserve(count);
+
+	int segment = 1;
+
+	for (int i = 0; i < count; ++i)
+	{
+		qreal distance = applySpeedProfile(action.speedProfile, (qreal)i / (count - 1)) * length;
+
+		// distance always increases, so we never need to go back
+		while (segment < points.size() - 1 && distances[segment] < distance) ++segment;
+
+		qreal segmentLength = distances[segment] - distances[segment - 1];
+		qreal ratio = segmentLength > 0.0 ? (distance - distances[segment - 1]) / segmentLength : 1.0;
+
+		samples << (points[segment - 1] + (points[segment] - points[segment - 1]) * qBound(0.0, ratio, 1.0)).toPoint();
+	}
+
+	return samples;
+}
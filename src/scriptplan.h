@@ -0,0 +1,144 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCRIPTPLAN_H
+#define SCRIPTPLAN_H
+
+#include "action.h"
+#include "imagematch.h"
+#include "utils.h"
+#include "expression.h"
+
+class ActionModel;
+class ClickerBackend;
+
+// Data computed once before running a script, so the clicker doesn't
+// need to compute or allocate anything between two input events.
+class ScriptPlan
+{
+public:
+	// loop counters and return rows of a running script, only used by clicker
+	struct Registers
+	{
+		Registers() :runs(0)
+		{
+		}
+
+		QVector<int> counters;
+		QVector<int> returnRows;
+
+		// number of times each action has been executed
+		QVector<int> executions;
+
+		// number of times the script restarted from first action
+		int runs;
+	};
+
+	ScriptPlan();
+
+	// compute cursor positions of all Move and Drag actions, keys of keyboard actions and targets of jumps,
+	// keys are resolved by backend
+	void compile(const ActionModel* model, ClickerBackend* backend);
+
+	// first row with a target which doesn't exist, -1 if all targets were found
+	int getInvalidTargetRow() const { return m_invalidTargetRow; }
+
+	// first row with an invalid expression and its error, -1 if all expressions are valid
+	int getInvalidExpressionRow() const { return m_invalidExpressionRow; }
+	QString getExpressionError() const { return m_expressionError; }
+
+	// null if action has no expression
+	const Expression& getExpression(int row) const;
+
+	// set loop counters to their initial values, clear return rows and executions
+	void resetRegisters(Registers& registers) const;
+
+	// follow Jump, Loop, Call, Return and Repeat actions starting at row and return the first row to execute,
+	// restart from first row after last one, -1 if no action can be executed
+	int resolveRow(int row, Registers& registers) const;
+
+	// positions relative to script window, all samples of a path are contiguous
+	const QPoint* getSamples(int row) const;
+	int getSamplesCount(int row) const;
+
+	// time between 2 samples in µs
+	qint64 getSamplePeriod(int row) const;
+
+	// image and its reduced versions for FindImage actions
+	const ImageTemplate& getImageTemplate(int row) const;
+
+	// keys to press, release or type, all keys of an action are contiguous
+	const KeyStroke* getKeyStrokes(int row) const;
+	int getKeyStrokesCount(int row) const;
+
+	// return all cursor positions of a path with the same time between them
+	static QVector<QPoint> computeSamples(const Action& action);
+
+private:
+	// set loop counters to their initial values and clear return rows
+	void restartRegisters(Registers& registers) const;
+
+	struct Path
+	{
+		int first;
+		int count;
+		qint64 period;
+	};
+
+	struct Keys
+	{
+		int first;
+		int count;
+	};
+
+	// None for actions which are executed
+	struct Jump
+	{
+		Action::Type type;
+		int target;
+		int count;
+	};
+
+	// one per action
+	QVector<Path> m_paths;
+	QVector<Keys> m_keys;
+	QVector<Jump> m_jumps;
+
+	// Loop and Repeat actions, only their counters are reset when restarting
+	QVector<int> m_loopRows;
+
+	int m_invalidTargetRow;
+
+	// one per action, null if action has no expression
+	QVector<Expression> m_expressions;
+
+	int m_invalidExpressionRow;
+	QString m_expressionError;
+
+	// samples of all paths
+	QVector<QPoint> m_samples;
+
+	// one per action, null if not a FindImage
+	QVector<ImageTemplate> m_imageTemplates;
+
+	// keys of all actions
+	QVector<KeyStroke> m_keyStrokes;
+};
+
+#endif
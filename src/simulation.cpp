@@ -0,0 +1,299 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "simulation.h"
+#include "actionmodel.h"
+#include "imagematch.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+static const char* s_eventNames[] = { "move", "down", "up", "wheel", "keydown", "keyup" };
+
+SimulationBackend::SimulationBackend(quint32 seed, QTextStream* output) :m_time(0), m_screen(0, 0, 1920, 1080), m_random(seed), m_output(output),
+	m_lastButtonDown(-1), m_clickIntervals(0), m_clickIntervalMin(0), m_clickIntervalMax(0), m_clickIntervalSum(0.0), m_clickIntervalSquaresSum(0.0)
+{
+	memset(m_counts, 0, sizeof(m_counts));
+}
+
+QString SimulationBackend::getName() const
+{
+	return "simulation";
+}
+
+void SimulationBackend::prepare()
+{
+	// nothing to open
+}
+
+void SimulationBackend::finish()
+{
+}
+
+qint64 SimulationBackend::getTime()
+{
+	return m_time;
+}
+
+void SimulationBackend::sleep(int ms)
+{
+	m_time += ms * 1000LL;
+}
+
+void SimulationBackend::waitUntil(qint64 deadline)
+{
+	m_time = qMax(m_time, deadline);
+}
+
+void SimulationBackend::sendInputEvents(const InputEvent* events, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		const InputEvent& event = events[i];
+
+		++m_counts[(int)event.type];
+
+		if (event.type == InputEvent::Type::Move) m_cursor = event.pos;
+
+		if (event.type == InputEvent::Type::ButtonDown)
+		{
+			if (m_lastButtonDown > -1)
+			{
+				qint64 interval = m_time - m_lastButtonDown;
+
+				m_clickIntervalMin = m_clickIntervals ? qMin(m_clickIntervalMin, interval) : interval;
+				m_clickIntervalMax = qMax(m_clickIntervalMax, interval);
+				m_clickIntervalSum += interval;
+				m_clickIntervalSquaresSum += (double)interval * interval;
+
+				++m_clickIntervals;
+			}
+
+			m_lastButtonDown = m_time;
+		}
+
+		if (!m_output) continue;
+
+		*m_output << m_time << "\t" << s_eventNames[(int)event.type];
+
+		switch (event.type)
+		{
+			case InputEvent::Type::Move:
+			case InputEvent::Type::Wheel:
+			*m_output << "\t" << event.pos.x() << "\t" << event.pos.y();
+			break;
+
+			case InputEvent::Type::ButtonDown:
+			case InputEvent::Type::ButtonUp:
+			*m_output << "\t" << event.button;
+			break;
+
+			default:
+			*m_output << "\t" << event.key.code << "\t" << event.key.modifier;
+			break;
+		}
+
+		*m_output << "\n";
+	}
+}
+
+QPoint SimulationBackend::getCursorPosition()
+{
+	// nobody moves the mouse
+	return m_cursor;
+}
+
+bool SimulationBackend::waitForCursorMove(const QPoint& pos, qint64 deadline)
+{
+	waitUntil(deadline);
+
+	return m_cursor != pos;
+}
+
+KeyStroke SimulationBackend::getKeyStroke(const QString& name)
+{
+	KeyStroke key;
+
+	// modifiers can't be parsed by QKeySequence
+	if (name == "Shift") key.code = Qt::Key_Shift;
+	else if (name == "Control" || name == "Ctrl") key.code = Qt::Key_Control;
+	else if (name == "Alt") key.code = Qt::Key_Alt;
+	else if (name == "AltGr") key.code = Qt::Key_AltGr;
+	else if (name == "Meta") key.code = Qt::Key_Meta;
+	else
+	{
+		QKeySequence sequence = QKeySequence::fromString(name, QKeySequence::PortableText);
+
+		if (!sequence.isEmpty())
+		{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+			key.code = sequence[0].key();
+#else
+			key.code = sequence[0] & ~Qt::KeyboardModifierMask;
+#endif
+		}
+
+		if (key.code == Qt::Key_unknown) key.code = 0;
+	}
+
+	return key;
+}
+
+QVector<KeyStroke> SimulationBackend::getKeyStrokes(const QString& text)
+{
+	QVector<KeyStroke> keys;
+
+	// a virtual keyboard with one key per character
+	for (uint c : text.toUcs4())
+	{
+		KeyStroke key;
+		key.code = c;
+
+		keys << key;
+	}
+
+	return keys;
+}
+
+QRandomGenerator& SimulationBackend::getRandomGenerator()
+{
+	return m_random;
+}
+
+bool SimulationBackend::findWindow(const QString& title, Window& window)
+{
+	window.title = title;
+	window.rect = m_screen;
+
+	return true;
+}
+
+bool SimulationBackend::isSameWindowAtPos(const Window& window, const QPoint& pos)
+{
+	return true;
+}
+
+ClickerBackend::WaitResult SimulationBackend::waitPixel(const Action& action, const QAtomicInt& stop)
+{
+	return WaitResult::Found;
+}
+
+ClickerBackend::WaitResult SimulationBackend::waitImage(const Action& action, const ImageTemplate& imageTemplate, const QAtomicInt& stop, QPoint& pos)
+{
+	if (imageTemplate.isNull()) return WaitResult::NotFound;
+
+	// image is always found at top left corner of search region
+	QRect region = action.searchSize.isEmpty() ? m_screen : QRect(action.originalPosition, action.searchSize);
+
+	QSize size = imageTemplate.size();
+
+	pos = region.topLeft() + QPoint(size.width() / 2, size.height() / 2);
+
+	return WaitResult::Found;
+}
+
+void SimulationBackend::writeLabel(const QString& label)
+{
+	if (m_output) *m_output << m_time << "\tlabel\t" << label << "\n";
+}
+
+void SimulationBackend::writeStatistics(QTextStream& out) const
+{
+	out << "# time " << m_time << "\n";
+
+	for (int i = 0; i <= (int)InputEvent::Type::KeyUp; ++i)
+	{
+		out << "# " << s_eventNames[i] << " " << m_counts[i] << "\n";
+	}
+
+	if (m_clickIntervals > 0)
+	{
+		double mean = m_clickIntervalSum / m_clickIntervals;
+		double deviation = qSqrt(qMax(0.0, m_clickIntervalSquaresSum / m_clickIntervals - mean * mean));
+
+		out << "# click interval min " << m_clickIntervalMin << " max " << m_clickIntervalMax << " mean " << qRound64(mean) << " deviation " << qRound64(deviation) << "\n";
+	}
+}
+
+int runSimulation(const QString& filename, quint32 seed, qint64 duration, const QString& output)
+{
+	QTextStream err(stderr);
+
+	ActionModel model;
+
+	bool loaded = filename.endsWith(".txt", Qt::CaseInsensitive) ? model.loadText(filename) : model.load(filename);
+
+	if (!loaded)
+	{
+		err << QCoreApplication::translate("main", "Unable to load %1").arg(filename) << "\n";
+		return 1;
+	}
+
+	QFile file;
+	QTextStream timeline(stdout);
+
+	if (!output.isEmpty())
+	{
+		file.setFileName(output);
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		{
+			err << QCoreApplication::translate("main", "Unable to create %1").arg(output) << "\n";
+			return 1;
+		}
+
+		timeline.setDevice(&file);
+	}
+
+	SimulationBackend backend(seed, &timeline);
+
+	Clicker clicker(&backend);
+	clicker.setTimeLimit(duration);
+
+	QObject::connect(&clicker, &Clicker::actionChanged, [&backend](const QString& label) { backend.writeLabel(label); });
+
+	QElapsedTimer clock;
+	clock.start();
+
+	QAtomicInt stop(0);
+	clicker.run(&model, Action(), stop);
+
+	qint64 elapsed = clock.nsecsElapsed() / 1000;
+
+	timeline.flush();
+
+	// statistics are written after the timeline
+	QTextStream out(stdout);
+
+	backend.writeStatistics(out);
+
+	// wall time changes between runs, so it's not written with the timeline
+	err << QCoreApplication::translate("main", "Simulated in %1 ms").arg(elapsed / 1000) << "\n";
+
+	// script stopped by itself before the end
+	if (backend.getTime() < duration)
+	{
+		out << "# stopped before the end\n";
+		return 2;
+	}
+
+	return 0;
+}
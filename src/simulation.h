@@ -0,0 +1,82 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "clicker.h"
+
+// Virtual clock and recorded inputs, so a script runs as fast as possible
+// and always produces the same events for the same seed. Screen conditions
+// are always satisfied and the script window covers the whole virtual screen.
+// Keys don't depend on the system: codes are Qt keys for named keys and
+// Unicode characters for typed text.
+class SimulationBackend : public ClickerBackend
+{
+public:
+	// timeline is written to output if not null, one line per event
+	SimulationBackend(quint32 seed, QTextStream* output);
+
+	QString getName() const override;
+	void prepare() override;
+	void finish() override;
+	qint64 getTime() override;
+	void sleep(int ms) override;
+	void waitUntil(qint64 deadline) override;
+	void sendInputEvents(const InputEvent* events, int count) override;
+	QPoint getCursorPosition() override;
+	KeyStroke getKeyStroke(const QString& name) override;
+	QVector<KeyStroke> getKeyStrokes(const QString& text) override;
+	bool waitForCursorMove(const QPoint& pos, qint64 deadline) override;
+	QRandomGenerator& getRandomGenerator() override;
+	bool findWindow(const QString& title, Window& window) override;
+	bool isSameWindowAtPos(const Window& window, const QPoint& pos) override;
+	WaitResult waitPixel(const Action& action, const QAtomicInt& stop) override;
+	WaitResult waitImage(const Action& action, const ImageTemplate& imageTemplate, const QAtomicInt& stop, QPoint& pos) override;
+
+	// write a line in timeline at current time
+	void writeLabel(const QString& label);
+
+	// write number of events and statistics about clicks
+	void writeStatistics(QTextStream& out) const;
+
+private:
+	qint64 m_time;
+	QPoint m_cursor;
+	QRect m_screen;
+	QRandomGenerator m_random;
+	QTextStream* m_output;
+
+	// number of events of each type
+	qint64 m_counts[(int)InputEvent::Type::KeyUp + 1];
+
+	// time between 2 button presses in µs
+	qint64 m_lastButtonDown;
+	qint64 m_clickIntervals;
+	qint64 m_clickIntervalMin;
+	qint64 m_clickIntervalMax;
+	double m_clickIntervalSum;
+	double m_clickIntervalSquaresSum;
+};
+
+// run script during duration in µs of virtual time and write timeline to output or standard output if empty,
+// return 0 if script was still running at the end, 1 if a file can't be read or written and 2 if script stopped before
+int runSimulation(const QString& filename, quint32 seed, qint64 duration, const QString& output);
+
+#endif
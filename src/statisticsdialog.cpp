@@ -0,0 +1,119 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "statisticsdialog.h"
+#include "moc_statisticsdialog.cpp"
+#include "clicker.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// refresh rate of histograms in ms
+static const int s_refreshDelay = 500;
+
+StatisticsDialog::StatisticsDialog(QWidget* parent, const Clicker* clicker):QDialog(parent, Qt::Dialog | Qt::WindowCloseButtonHint), m_clicker(clicker)
+{
+	setupUi(this);
+
+	latenciesTableWidget->selectRow(2);
+
+	m_timer = new QTimer(this);
+	m_timer->setInterval(s_refreshDelay);
+
+	connect(m_timer, &QTimer::timeout, this, &StatisticsDialog::onRefresh);
+	connect(latenciesTableWidget, &QTableWidget::itemSelectionChanged, this, &StatisticsDialog::onRefresh);
+}
+
+StatisticsDialog::~StatisticsDialog()
+{
+}
+
+void StatisticsDialog::onRefresh()
+{
+	// same order as rows
+	QList<const LatencyHistogram*> histograms;
+	histograms << &m_clicker->getLateness() << &m_clicker->getInjectionLatency() << &m_clicker->getTotalLatency();
+
+	for (int row = 0; row < histograms.size(); ++row)
+	{
+		const LatencyHistogram* histogram = histograms[row];
+
+		QStringList values;
+		values << QString::number(histogram->getCount()) << QString::number(histogram->getMinimum());
+		values << QString::number(histogram->getPercentile(50.0)) << QString::number(histogram->getPercentile(90.0));
+		values << QString::number(histogram->getPercentile(99.0)) << QString::number(histogram->getPercentile(99.9));
+		values << QString::number(histogram->getMaximum()) << QString::number(histogram->getMean(), 'f', 1);
+
+		for (int column = 0; column < values.size(); ++column)
+		{
+			QTableWidgetItem* item = latenciesTableWidget->item(row, column);
+
+			if (!item)
+			{
+				item = new QTableWidgetItem();
+				item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+				latenciesTableWidget->setItem(row, column, item);
+			}
+
+			item->setText(values[column]);
+		}
+	}
+
+	qint64 startLatency = m_clicker->getStartLatency();
+
+	if (startLatency < 0)
+	{
+		startLatencyLabel->setText(tr("Start to first click: no click yet"));
+	}
+	else
+	{
+		startLatencyLabel->setText(tr("Start to first click: %1 µs").arg(startLatency));
+	}
+
+	// this dialog also wakes up the process while it's displayed
+	usageLabel->setText(tr("Usage: %1").arg(m_clicker->getUsageString()));
+
+	int row = latenciesTableWidget->currentRow();
+
+	if (row < 0 || row >= histograms.size()) return;
+
+	QString buckets = histograms[row]->getBucketsString();
+
+	// keep scrollbar position if nothing changed
+	if (buckets != bucketsPlainTextEdit->toPlainText()) bucketsPlainTextEdit->setPlainText(buckets);
+}
+
+void StatisticsDialog::showEvent(QShowEvent* e)
+{
+	onRefresh();
+
+	m_timer->start();
+
+	e->accept();
+}
+
+void StatisticsDialog::hideEvent(QHideEvent* e)
+{
+	m_timer->stop();
+
+	e->accept();
+}
@@ -0,0 +1,48 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STATISTICSDIALOG_H
+#define STATISTICSDIALOG_H
+
+#include "ui_statisticsdialog.h"
+
+class Clicker;
+
+class StatisticsDialog : public QDialog, public Ui::StatisticsDialog
+{
+	Q_OBJECT
+
+public:
+	StatisticsDialog(QWidget* parent, const Clicker* clicker);
+	virtual ~StatisticsDialog();
+
+public slots:
+	// histograms are updated by clicker while dialog is visible
+	void onRefresh();
+
+protected:
+	void showEvent(QShowEvent* e);
+	void hideEvent(QHideEvent* e);
+
+private:
+	const Clicker* m_clicker;
+	QTimer* m_timer;
+};
+
+#endif
@@ -1,108 +1,302 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "testdialog.h"
-#include "moc_testdialog.cpp"
-#include "configfile.h"
-
-#ifdef DEBUG_NEW
-	#define new DEBUG_NEW
-#endif
-
-TestDialog::TestDialog(QWidget* parent):QDialog(parent, Qt::Dialog | Qt::WindowCloseButtonHint), m_clicks(0), m_minClickDelay(0.0), m_maxClickDelay(0.0)
-{
-	setupUi(this);
-
-	setMouseTracking(true);
-
-	reset();
-}
-
-TestDialog::~TestDialog()
-{
-}
-
-void TestDialog::reset()
-{
-	m_firstPress = QDateTime();
-	m_lastPress = QDateTime();
-	m_lastRelease = QDateTime();
-
-	m_clicks = 0;
-	m_minClickDelay = 0.0;
-	m_maxClickDelay = 0.0;
-}
-
-void TestDialog::mousePressEvent(QMouseEvent* /* event */)
-{
-	QDateTime now = QDateTime::currentDateTime();
-
-	if (m_firstPress.isNull()) m_firstPress = now;
-
-	m_lastPress = now;
-}
-
-void TestDialog::mouseReleaseEvent(QMouseEvent* /* event */)
-{
-	QDateTime now = QDateTime::currentDateTime();
-
-	++m_clicks;
-
-	qint64 lastClickDelay = m_lastRelease.msecsTo(now);
-
-	if (m_minClickDelay == 0.0 || lastClickDelay < m_minClickDelay) m_minClickDelay = lastClickDelay;
-	if (m_maxClickDelay == 0.0 || lastClickDelay > m_maxClickDelay) m_maxClickDelay = lastClickDelay;
-
-	qint64 clicksDuration = m_firstPress.msecsTo(now); // total ms
-	double averageCPS = (double)m_clicks / (double)clicksDuration * 1000.0;
-	double averageClicksDelay = 1000.0 / averageCPS;
-
-	m_lastRelease = now;
-
-	clicksLabel->setText(tr("Number of clicks: %1").arg(m_clicks));
-	releaseLabel->setText(tr("Click delay: %1 ms (average: %2 / min: %3 / max: %4)").arg(lastClickDelay).arg(averageClicksDelay).arg(m_minClickDelay).arg(m_maxClickDelay));
-	averageLabel->setText(tr("CPS: %1 cps").arg(averageCPS));
-}
-
-void TestDialog::mouseMoveEvent(QMouseEvent* event)
-{
-	positionLabel->setText(tr("Mouse position: (%1, %2)").arg(event->globalPosition().x()).arg(event->globalPosition().y()));
-}
-
-void TestDialog::closeEvent(QCloseEvent* e)
-{
-	hide();
-
-	e->accept();
-}
-
-void TestDialog::resizeEvent(QResizeEvent* e)
-{
-	ConfigFile::getInstance()->setTestDialogSize(e->size());
-
-	e->accept();
-}
-
-void TestDialog::moveEvent(QMoveEvent* e)
-{
-	ConfigFile::getInstance()->setTestDialogPosition(QPoint(x(), y()));
-
-	e->accept();
-}
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "testdialog.h"
+#include "moc_testdialog.cpp"
+#include "configfile.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// CPS is computed on presses during this window in ns
+static const qint64 s_cpsWindow = Q_INT64_C(5000000000);
+
+// minimum time in ms between 2 updates of labels
+static const int s_updateDelay = 100;
+
+TestDialog::TestDialog(QWidget* parent):QDialog(parent, Qt::Dialog | Qt::WindowCloseButtonHint)
+{
+	setupUi(this);
+
+	setMouseTracking(true);
+
+	// fixed width to align histogram columns
+	QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+	intervalsHistogramLabel->setFont(font);
+	holdsHistogramLabel->setFont(font);
+
+	m_updateTimer = new QTimer(this);
+	m_updateTimer->setSingleShot(true);
+	m_updateTimer->setInterval(s_updateDelay);
+
+	connect(m_updateTimer, &QTimer::timeout, this, &TestDialog::onUpdateLabels);
+	connect(resetPushButton, &QPushButton::clicked, this, &TestDialog::onReset);
+	connect(exportPushButton, &QPushButton::clicked, this, &TestDialog::onExport);
+
+	reset();
+}
+
+TestDialog::~TestDialog()
+{
+}
+
+void TestDialog::reset()
+{
+	m_clock.start();
+
+	m_clicks.clear();
+	m_intervals.clear();
+	m_holds.clear();
+	m_eventIntervals.clear();
+	m_eventHolds.clear();
+	m_pressedButtons.clear();
+	m_recentPresses.clear();
+
+	m_intervalsHistogram.reset();
+	m_holdsHistogram.reset();
+
+	onUpdateLabels();
+}
+
+void TestDialog::onReset()
+{
+	reset();
+}
+
+void TestDialog::onExport()
+{
+	QString filename = QFileDialog::getSaveFileName(this, tr("Export clicks"), ConfigFile::getInstance()->getLocalDataDirectory() + "/clicks.csv", "CSV Files (*.csv)");
+
+	if (filename.isEmpty()) return;
+
+	QFile file(filename);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Unable to create %1").arg(filename));
+		return;
+	}
+
+	QTextStream stream(&file);
+
+	stream << "button,press_ns,release_ns,press_timestamp_ms,release_timestamp_ms,interval_us,hold_us,event_interval_ms,event_hold_ms\n";
+
+	for (int i = 0; i < m_clicks.size(); ++i)
+	{
+		const Click& click = m_clicks[i];
+
+		// empty fields if not available
+		QString interval = i > 0 ? QString::number((click.pressTime - m_clicks[i - 1].pressTime) / 1000) : QString();
+		QString release = click.releaseTime > -1 ? QString::number(click.releaseTime) : QString();
+		QString releaseTimestamp = click.releaseTime > -1 ? QString::number(click.releaseTimestamp) : QString();
+		QString hold = click.releaseTime > -1 ? QString::number((click.releaseTime - click.pressTime) / 1000) : QString();
+		QString eventInterval = i > 0 ? QString::number((qint64)click.pressTimestamp - (qint64)m_clicks[i - 1].pressTimestamp) : QString();
+		QString eventHold = click.releaseTime > -1 ? QString::number((qint64)click.releaseTimestamp - (qint64)click.pressTimestamp) : QString();
+
+		stream << (int)click.button << "," << click.pressTime << "," << release << "," << click.pressTimestamp << "," << releaseTimestamp << "," << interval << "," << hold << ","
+			<< eventInterval << "," << eventHold << "\n";
+	}
+}
+
+QString TestDialog::formatDuration(double duration)
+{
+	return tr("%1 ms").arg(duration / 1000.0, 0, 'f', 3);
+}
+
+QString TestDialog::formatPercentiles(QVector<qint64>& durations)
+{
+	if (durations.isEmpty()) return QString("-");
+
+	QStringList res;
+
+	// exact values, durations are partially sorted
+	for (int percent : { 50, 95, 99 })
+	{
+		int rank = qMin(durations.size() - 1, (durations.size() * percent + 99) / 100 - 1);
+
+		std::nth_element(durations.begin(), durations.begin() + rank, durations.end());
+
+		res << formatDuration(durations[rank]);
+	}
+
+	return res.join(" / ");
+}
+
+void TestDialog::onUpdateLabels()
+{
+	qint64 clicks = m_clicks.size();
+
+	clicksLabel->setText(tr("Number of clicks: %1").arg(clicks));
+
+	if (m_intervals.isEmpty())
+	{
+		intervalLabel->setText(tr("Click interval (dispatch time): -"));
+		jitterLabel->setText(tr("Jitter: -"));
+	}
+	else
+	{
+		double mean = 0.0, squares = 0.0;
+
+		for (qint64 interval : m_intervals)
+		{
+			mean += interval;
+			squares += (double)interval * interval;
+		}
+
+		mean /= m_intervals.size();
+
+		double deviation = qSqrt(qMax(0.0, squares / m_intervals.size() - mean * mean));
+
+		intervalLabel->setText(tr("Click interval (dispatch time): %1 (average: %2 / min: %3 / max: %4)").arg(formatDuration(m_intervals.last())).arg(formatDuration(mean))
+			.arg(formatDuration(m_intervalsHistogram.getMinimum())).arg(formatDuration(m_intervalsHistogram.getMaximum())));
+
+		jitterLabel->setText(tr("Jitter: %1 (p50 / p95 / p99: %2)").arg(formatDuration(deviation)).arg(formatPercentiles(m_intervals)));
+	}
+
+	if (m_holds.isEmpty())
+	{
+		holdLabel->setText(tr("Hold time (dispatch time): -"));
+	}
+	else
+	{
+		holdLabel->setText(tr("Hold time (dispatch time): %1 (average: %2 / p50 / p95 / p99: %3)").arg(formatDuration(m_holds.last())).arg(formatDuration(m_holdsHistogram.getMean()))
+			.arg(formatPercentiles(m_holds)));
+	}
+
+	// system timestamps are not delayed by the event loop but only have a ms resolution
+	if (m_eventIntervals.isEmpty() && m_eventHolds.isEmpty())
+	{
+		eventTimeLabel->setText(tr("Event time: -"));
+	}
+	else
+	{
+		double intervalMean = 0.0, holdMean = 0.0;
+
+		for (qint64 interval : m_eventIntervals) intervalMean += interval;
+		for (qint64 hold : m_eventHolds) holdMean += hold;
+
+		QString interval = m_eventIntervals.isEmpty() ? QString("-") : tr("%1 ms (average: %2 ms)").arg(m_eventIntervals.last()).arg(intervalMean / m_eventIntervals.size(), 0, 'f', 3);
+		QString hold = m_eventHolds.isEmpty() ? QString("-") : tr("%1 ms (average: %2 ms)").arg(m_eventHolds.last()).arg(holdMean / m_eventHolds.size(), 0, 'f', 3);
+
+		eventTimeLabel->setText(tr("Event time: interval %1, hold %2").arg(interval).arg(hold));
+	}
+
+	if (clicks < 2)
+	{
+		averageLabel->setText(tr("CPS: -"));
+	}
+	else
+	{
+		// average on all clicks and on last seconds
+		double averageCPS = (clicks - 1) * 1000000000.0 / (m_clicks.last().pressTime - m_clicks.first().pressTime);
+
+		double recentCPS = 0.0;
+
+		if (m_recentPresses.size() > 1)
+		{
+			recentCPS = (m_recentPresses.size() - 1) * 1000000000.0 / (m_recentPresses.last() - m_recentPresses.first());
+		}
+
+		averageLabel->setText(tr("CPS: %1 cps (last %2 s: %3 cps)").arg(averageCPS, 0, 'f', 2).arg(s_cpsWindow / 1000000000).arg(recentCPS, 0, 'f', 2));
+	}
+
+	intervalsHistogramLabel->setText(tr("Intervals (µs)") + "\n" + m_intervalsHistogram.getBucketsString());
+	holdsHistogramLabel->setText(tr("Hold times (µs)") + "\n" + m_holdsHistogram.getBucketsString());
+}
+
+void TestDialog::mousePressEvent(QMouseEvent* event)
+{
+	qint64 now = m_clock.nsecsElapsed();
+
+	Click click;
+	click.button = event->button();
+	click.pressTime = now;
+	click.releaseTime = -1;
+	click.pressTimestamp = event->timestamp();
+	click.releaseTimestamp = 0;
+
+	// no interval for first click
+	if (!m_clicks.isEmpty())
+	{
+		qint64 interval = (now - m_clicks.last().pressTime) / 1000;
+
+		m_intervals << interval;
+		m_intervalsHistogram.add(interval);
+
+		m_eventIntervals << (qint64)click.pressTimestamp - (qint64)m_clicks.last().pressTimestamp;
+	}
+
+	m_pressedButtons[click.button] = m_clicks.size();
+	m_clicks << click;
+
+	m_recentPresses.enqueue(now);
+
+	while (now - m_recentPresses.head() > s_cpsWindow) m_recentPresses.dequeue();
+
+	if (!m_updateTimer->isActive()) m_updateTimer->start();
+}
+
+void TestDialog::mouseReleaseEvent(QMouseEvent* event)
+{
+	qint64 now = m_clock.nsecsElapsed();
+
+	// press happened before reset or outside dialog
+	if (!m_pressedButtons.contains(event->button())) return;
+
+	Click& click = m_clicks[m_pressedButtons.take(event->button())];
+	click.releaseTime = now;
+	click.releaseTimestamp = event->timestamp();
+
+	qint64 hold = (now - click.pressTime) / 1000;
+
+	m_holds << hold;
+	m_holdsHistogram.add(hold);
+
+	m_eventHolds << (qint64)click.releaseTimestamp - (qint64)click.pressTimestamp;
+
+	if (!m_updateTimer->isActive()) m_updateTimer->start();
+}
+
+void TestDialog::mouseMoveEvent(QMouseEvent* event)
+{
+	positionLabel->setText(tr("Mouse position: (%1, %2)").arg(event->globalPosition().x()).arg(event->globalPosition().y()));
+}
+
+void TestDialog::closeEvent(QCloseEvent* e)
+{
+	hide();
+
+	e->accept();
+}
+
+void TestDialog::resizeEvent(QResizeEvent* e)
+{
+	ConfigFile::getInstance()->setTestDialogSize(e->size());
+
+	e->accept();
+}
+
+void TestDialog::moveEvent(QMoveEvent* e)
+{
+	ConfigFile::getInstance()->setTestDialogPosition(QPoint(x(), y()));
+
+	e->accept();
+}
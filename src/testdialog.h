@@ -1,55 +1,93 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#ifndef TESTDIALOG_H
-#define TESTDIALOG_H
-
-#include "ui_testdialog.h"
-
-class TestDialog : public QDialog, public Ui::TestDialog
-{
-	Q_OBJECT
-
-public:
-	TestDialog(QWidget* parent);
-	virtual ~TestDialog();
-
-	void reset();
-
-private:
-	QDateTime m_firstPress;
-	QDateTime m_lastPress;
-	QDateTime m_lastRelease;
-	qint64 m_clicks;
-	double m_minClickDelay;
-	double m_maxClickDelay;
-
-protected:
-	// mouse events
-	void mousePressEvent(QMouseEvent* event);
-	void mouseReleaseEvent(QMouseEvent* event);
-	void mouseMoveEvent(QMouseEvent* event);
-
-	// dialog events
-	void closeEvent(QCloseEvent* e);
-	void resizeEvent(QResizeEvent* e);
-	void moveEvent(QMoveEvent* e);
-};
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TESTDIALOG_H
+#define TESTDIALOG_H
+
+#include "ui_testdialog.h"
+#include "latencyhistogram.h"
+
+class TestDialog : public QDialog, public Ui::TestDialog
+{
+	Q_OBJECT
+
+public:
+	TestDialog(QWidget* parent);
+	virtual ~TestDialog();
+
+	void reset();
+
+public slots:
+	void onReset();
+	void onExport();
+	void onUpdateLabels();
+
+private:
+	// times in ns since reset, timestamps in ms given by the system
+	struct Click
+	{
+		Qt::MouseButton button;
+		qint64 pressTime;
+		qint64 releaseTime;
+		ulong pressTimestamp;
+		ulong releaseTimestamp;
+	};
+
+	// durations in µs
+	static QString formatDuration(double duration);
+	static QString formatPercentiles(QVector<qint64>& durations);
+
+	QElapsedTimer m_clock;
+
+	QVector<Click> m_clicks;
+
+	// time between 2 presses and between press and release in µs, measured when events are dispatched
+	// so they include delays of the event loop
+	QVector<qint64> m_intervals;
+	QVector<qint64> m_holds;
+
+	// same durations in ms computed from timestamps given by the system
+	QVector<qint64> m_eventIntervals;
+	QVector<qint64> m_eventHolds;
+
+	LatencyHistogram m_intervalsHistogram;
+	LatencyHistogram m_holdsHistogram;
+
+	// index of last press of each button not released yet
+	QMap<Qt::MouseButton, int> m_pressedButtons;
+
+	// press times during last seconds to compute current CPS
+	QQueue<qint64> m_recentPresses;
+
+	// labels are not updated more often than that
+	QTimer* m_updateTimer;
+
+protected:
+	// mouse events
+	void mousePressEvent(QMouseEvent* event);
+	void mouseReleaseEvent(QMouseEvent* event);
+	void mouseMoveEvent(QMouseEvent* event);
+
+	// dialog events
+	void closeEvent(QCloseEvent* e);
+	void resizeEvent(QResizeEvent* e);
+	void moveEvent(QMoveEvent* e);
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "trace.h"
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// maximum number of events kept for each thread, oldest ones are overwritten
+static const int s_eventsCount = 16384;
+
+struct TraceEvent
+{
+	const char* name;
+	qint64 start;
+	qint64 duration;
+	qint64 value;
+};
+
+// events of one thread, only this thread writes in it
+struct TraceBuffer
+{
+	TraceBuffer() :id(0), count(0)
+	{
+	}
+
+	int id;
+	QString name;
+
+	// total number of events added since start, may be more than s_eventsCount
+	QAtomicInteger<qint64> count;
+
+	TraceEvent events[s_eventsCount];
+};
+
+QBasicAtomicInt Trace::s_enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static QElapsedTimer s_clock;
+
+// buffers are only created for threads adding events and are never deleted,
+// because threads of the pool are reused
+static QMutex s_buffersMutex;
+static QList<TraceBuffer*> s_buffers;
+
+static thread_local TraceBuffer* s_buffer = nullptr;
+
+static TraceBuffer* getBuffer()
+{
+	if (s_buffer) return s_buffer;
+
+	s_buffer = new TraceBuffer();
+
+	QThread* thread = QThread::currentThread();
+
+	s_buffer->name = thread == QCoreApplication::instance()->thread() ? "main" : thread->objectName();
+
+	QMutexLocker locker(&s_buffersMutex);
+
+	s_buffer->id = s_buffers.size() + 1;
+
+	if (s_buffer->name.isEmpty()) s_buffer->name = QString("thread %1").arg(s_buffer->id);
+
+	s_buffers << s_buffer;
+
+	return s_buffer;
+}
+
+void Trace::start()
+{
+	stop();
+
+	{
+		QMutexLocker locker(&s_buffersMutex);
+
+		for (TraceBuffer* buffer : s_buffers) buffer->count.storeRelease(0);
+	}
+
+	s_clock.start();
+
+	s_enabled.storeRelease(1);
+}
+
+void Trace::stop()
+{
+	s_enabled.storeRelease(0);
+}
+
+qint64 Trace::getTime()
+{
+	return s_clock.nsecsElapsed();
+}
+
+void Trace::addEvent(const char* name, qint64 start, qint64 duration, qint64 value)
+{
+	TraceBuffer* buffer = getBuffer();
+
+	qint64 count = buffer->count.loadAcquire();
+
+	TraceEvent& event = buffer->events[count % s_eventsCount];
+	event.name = name;
+	event.start = start;
+	event.duration = duration;
+	event.value = value;
+
+	buffer->count.storeRelease(count + 1);
+}
+
+bool Trace::write(const QString& filename)
+{
+	QJsonArray events;
+
+	qint64 pid = QCoreApplication::applicationPid();
+
+	QMutexLocker locker(&s_buffersMutex);
+
+	for (const TraceBuffer* buffer : s_buffers)
+	{
+		QJsonObject metadata;
+		metadata["name"] = "thread_name";
+		metadata["ph"] = "M";
+		metadata["pid"] = pid;
+		metadata["tid"] = buffer->id;
+		metadata["args"] = QJsonObject({ { "name", buffer->name } });
+
+		events.append(metadata);
+
+		qint64 count = buffer->count.loadAcquire();
+
+		// only the last events are still in buffer
+		for (qint64 i = qMax(Q_INT64_C(0), count - s_eventsCount); i < count; ++i)
+		{
+			const TraceEvent& event = buffer->events[i % s_eventsCount];
+
+			// times are in µs
+			QJsonObject object;
+			object["name"] = event.name;
+			object["ph"] = event.duration < 0 ? "i" : "X";
+			object["ts"] = event.start / 1000.0;
+			object["pid"] = pid;
+			object["tid"] = buffer->id;
+
+			if (event.duration < 0)
+			{
+				// instant is only drawn on its thread
+				object["s"] = "t";
+			}
+			else
+			{
+				object["dur"] = event.duration / 1000.0;
+			}
+
+			if (event.value >= 0) object["args"] = QJsonObject({ { "value", event.value } });
+
+			events.append(object);
+		}
+	}
+
+	locker.unlock();
+
+	QJsonObject root;
+	root["traceEvents"] = events;
+	root["displayTimeUnit"] = "ms";
+
+	QSaveFile file(filename);
+
+	if (!file.open(QIODevice::WriteOnly)) return false;
+
+	file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+
+	return file.commit();
+}
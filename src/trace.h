@@ -0,0 +1,85 @@
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Record spans and instants of each thread in a ring buffer, to find what
+// delayed clicks. Events are written in Chrome trace-event format, so they
+// can be viewed in Perfetto or chrome://tracing.
+// When tracing is disabled, recording an event only tests a flag.
+class Trace
+{
+public:
+	// start a new trace, all previous events are discarded
+	static void start();
+	static void stop();
+
+	static bool isEnabled() { return s_enabled.loadAcquire() != 0; }
+
+	// name must be a string literal, value is shown as argument if not negative
+	static void instant(const char* name, qint64 value = -1)
+	{
+		if (Q_UNLIKELY(isEnabled())) addEvent(name, getTime(), -1, value);
+	}
+
+	// write events of all threads, they should not be adding events at the same time except the current one
+	static bool write(const QString& filename);
+
+private:
+	friend class TraceSpan;
+
+	// ns since start
+	static qint64 getTime();
+
+	// duration is -1 for instants
+	static void addEvent(const char* name, qint64 start, qint64 duration, qint64 value);
+
+	static QBasicAtomicInt s_enabled;
+};
+
+// Record a span from its creation to its destruction.
+class TraceSpan
+{
+public:
+	explicit TraceSpan(const char* name, qint64 value = -1) :m_name(nullptr), m_value(-1), m_start(0)
+	{
+		if (Q_UNLIKELY(Trace::isEnabled()))
+		{
+			m_name = name;
+			m_value = value;
+			m_start = Trace::getTime();
+		}
+	}
+
+	~TraceSpan()
+	{
+		if (Q_UNLIKELY(m_name != nullptr)) Trace::addEvent(m_name, m_start, Trace::getTime() - m_start, m_value);
+	}
+
+private:
+	Q_DISABLE_COPY(TraceSpan)
+
+	// null if tracing was disabled at creation
+	const char* m_name;
+	qint64 m_value;
+	qint64 m_start;
+};
+
+#endif
@@ -1,60 +1,166 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#ifndef UTILS_H
-#define UTILS_H
-
-#include "window.h"
-
-typedef QVector<Window> Windows;
-
-class QAbstractItemModel;
-
-void mouseLeftClickUp(const QPoint& pos);
-void mouseLeftClickDown(const QPoint& pos);
-
-int QKeySequenceToVK(const QKeySequence& seq);
-bool isKeyPressed(int key);
-
-void createWindowsList(Windows &windows);
-void createWindowsList(QAbstractItemModel *model);
-bool RestoreMinimizedWindow(WId id);
-void MinimizeWindow(WId id);
-void PutForegroundWindow(WId id);
-bool IsUsingComposition();
-bool IsOS64bits();
-bool isWindowMinimized(WId id);
-bool isSameWindowAtPos(Window window, const QPoint& pos);
-
-QPixmap grabWindow(WId window);
-Window getWindowWithTitle(const QString& title);
-
-QString GetUserAgent();
-QString GetSupportedImageFormatsFilter();
-
-QString encodeEntities(const QString& src, const QString& force = QString());
-QString decodeEntities(const QString& src);
-
-QString convertDateToISO(const QString &date);
-QString convertIDOToDate(const QString &date);
-
-QString base36enc(qint64 value);
-QColor average(const QColor &color1, const QColor &color2, qreal coef);
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef UTILS_H
+#define UTILS_H
+
+#include "window.h"
+
+typedef QVector<Window> Windows;
+
+// Raw view of captured screen pixels, 32 bits per pixel in BGRA order (alpha is undefined).
+// Pixels belong to the capture buffer of current thread and are valid until next capture.
+struct ScreenImage
+{
+	ScreenImage() :bits(nullptr), width(0), height(0), bytesPerLine(0)
+	{
+	}
+
+	bool isNull() const { return bits == nullptr; }
+
+	// copy pixels in a new image
+	QImage toImage() const;
+
+	const uchar* bits;
+	int width;
+	int height;
+	int bytesPerLine;
+
+	// absolute position of first pixel
+	QPoint pos;
+};
+
+// Platform dependent key, computed once before typing it.
+struct KeyStroke
+{
+	KeyStroke() :code(0), modifier(0)
+	{
+	}
+
+	bool isNull() const { return code == 0; }
+
+	// X11 key code or Windows virtual key
+	quint32 code;
+
+	// key to hold while pressing code to type a character (Shift, AltGr), 0 if none
+	quint32 modifier;
+};
+
+// Input event sent to the system by sendInputEvents.
+struct InputEvent
+{
+	enum class Type
+	{
+		Move,
+		ButtonDown,
+		ButtonUp,
+		Wheel,
+		KeyDown,
+		KeyUp
+	};
+
+	InputEvent(Type t = Type::Move, const QPoint& p = QPoint(), int b = 0) :type(t), pos(p), button(b)
+	{
+	}
+
+	InputEvent(Type t, const KeyStroke& k) :type(t), button(0), key(k)
+	{
+	}
+
+	Type type;
+
+	// absolute position for Move, horizontal and vertical steps for Wheel (positive to the right and down)
+	QPoint pos;
+
+	// 0 left, 1 middle, 2 right, 3 back and 4 forward, same values as Action::Button
+	int button;
+
+	// modifier is pressed before key and released after it
+	KeyStroke key;
+};
+
+// CPU time and wakeups of the whole process since its start
+struct ProcessUsage
+{
+	ProcessUsage() :cpuTime(-1), wakeups(-1)
+	{
+	}
+
+	// user and system time in µs, -1 if not available
+	qint64 cpuTime;
+
+	// number of times a thread waited and was woken up (voluntary context switches), -1 if not available
+	qint64 wakeups;
+};
+
+class QAbstractItemModel;
+
+// send all events in a single call to the system, so they can't be interleaved with other events
+void sendInputEvents(const InputEvent* events, int count);
+
+// name is the same as in QKeySequence ("Return", "F1", "A") or a modifier ("Shift", "Control", "Alt", "Meta")
+KeyStroke keyStrokeFromName(const QString& name);
+
+// one key stroke per character, null if a character can't be typed with current keyboard layout
+QVector<KeyStroke> keyStrokesFromText(const QString& text);
+
+int QKeySequenceToVK(const QKeySequence& seq);
+bool isKeyPressed(int key);
+
+// return true as soon as cursor is not at pos anymore, false after timeout in ms
+bool waitForCursorMove(const QPoint& pos, int timeout);
+
+// on X11, cursor moves are only notified to waitForCursorMove between these calls
+void startCursorMonitoring();
+void stopCursorMonitoring();
+
+// sleep during duration in µs with the most accurate timer of the system, without spinning
+void preciseSleep(qint64 duration);
+
+ProcessUsage getProcessUsage();
+
+void createWindowsList(Windows &windows);
+void createWindowsList(QAbstractItemModel *model);
+bool RestoreMinimizedWindow(WId id);
+void MinimizeWindow(WId id);
+void PutForegroundWindow(WId id);
+bool IsUsingComposition();
+bool IsOS64bits();
+bool isWindowMinimized(WId id);
+bool isSameWindowAtPos(Window window, const QPoint& pos);
+
+// capture a part of the screen, rect is relative to window (or screen if window is 0) or whole window if rect is null
+bool captureWindowRegion(WId window, const QRect& rect, ScreenImage& image);
+
+QPixmap grabWindow(WId window);
+Window getWindowWithTitle(const QString& title);
+
+QString GetUserAgent();
+QString GetSupportedImageFormatsFilter();
+
+QString encodeEntities(const QString& src, const QString& force = QString());
+QString decodeEntities(const QString& src);
+
+QString convertDateToISO(const QString &date);
+QString convertIDOToDate(const QString &date);
+
+QString base36enc(qint64 value);
+QColor average(const QColor &color1, const QColor &color2, qreal coef);
+
+#endif
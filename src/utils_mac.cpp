@@ -1,147 +1,355 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "utils.h"
-
-#ifdef Q_OS_MAC
-
-#include <Carbon/Carbon.h>
-
-void mouseLeftClickUp(const QPoint& pos)
-{
-	CGEventRef click = CGEventCreateMouseEvent(NULL, kCGEventLeftMouseUp, CGPointMake(pos.x(), pos.y()), kCGMouseButtonLeft);
-
-	CGEventPost(kCGHIDEventTap, click);
-
-	CFRelease(click);
-}
-
-void mouseLeftClickDown(const QPoint& pos)
-{
-	CGEventRef click = CGEventCreateMouseEvent(NULL, kCGEventLeftMouseDown, CGPointMake(pos.x(), pos.y()), kCGMouseButtonLeft);
-
-	CGEventPost(kCGHIDEventTap, click);
-
-	CFRelease(click);
-}
-
-int QKeySequenceToVK(const QKeySequence& seq)
-{
-	/*
-	kVK_Return = 0x24,
-		kVK_Tab = 0x30,
-		kVK_Space = 0x31,
-		kVK_Delete = 0x33,
-		kVK_Escape = 0x35,
-		kVK_Command = 0x37,
-		kVK_Shift = 0x38,
-		kVK_CapsLock = 0x39,
-		kVK_Option = 0x3A,
-		kVK_Control = 0x3B,
-		kVK_RightShift = 0x3C,
-		kVK_RightOption = 0x3D,
-		kVK_RightControl = 0x3E,
-		kVK_Function = 0x3F,
-		kVK_F17 = 0x40,
-		kVK_VolumeUp = 0x48,
-		kVK_VolumeDown = 0x49,
-		kVK_Mute = 0x4A,
-		kVK_F18 = 0x4F,
-		kVK_F19 = 0x50,
-		kVK_F20 = 0x5A,
-		kVK_F5 = 0x60,
-		kVK_F6 = 0x61,
-		kVK_F7 = 0x62,
-		kVK_F3 = 0x63,
-		kVK_F8 = 0x64,
-		kVK_F9 = 0x65,
-		kVK_F11 = 0x67,
-		kVK_F13 = 0x69,
-		kVK_F16 = 0x6A,
-		kVK_F14 = 0x6B,
-		kVK_F10 = 0x6D,
-		kVK_F12 = 0x6F,
-		kVK_F15 = 0x71,
-		kVK_Help = 0x72,
-		kVK_Home = 0x73,
-		kVK_PageUp = 0x74,
-		kVK_ForwardDelete = 0x75,
-		kVK_F4 = 0x76,
-		kVK_End = 0x77,
-		kVK_F2 = 0x78,
-		kVK_PageDown = 0x79,
-		kVK_F1 = 0x7A,
-		kVK_LeftArrow = 0x7B,
-		kVK_RightArrow = 0x7C,
-		kVK_DownArrow = 0x7D,
-		kVK_UpArrow = 0x7E
-*/
-	return 0;
-}
-
-bool isKeyPressed(int key)
-{
-	unsigned char keyMap[16];
-	GetKeys((BigEndianUInt32*)&keyMap);
-	return (0 != ((keyMap[key >> 3] >> (key & 7)) & 1));
-}
-
-bool isSameWindowAtPos(Window window, const QPoint& pos)
-{
-	return false;
-}
-
-void createWindowsList(Windows& windows)
-{
-}
-
-void createWindowsList(QAbstractItemModel* model)
-{
-}
-
-bool isWindowMinimized(WId id)
-{
-	return false;
-}
-
-bool RestoreMinimizedWindow(WId &id)
-{
-	return false;
-}
-
-void MinimizeWindow(WId id)
-{
-}
-
-bool IsUsingComposition()
-{
-	return true;
-}
-
-void PutForegroundWindow(WId id)
-{
-}
-
-bool IsOS64bits()
-{
-	return true;
-}
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "utils.h"
+
+#ifdef Q_OS_MAC
+
+#include <Carbon/Carbon.h>
+#include <sys/resource.h>
+#include <mach/mach_time.h>
+
+// buttons currently pressed, needed to send dragged events instead of moved ones
+static int s_pressedButtons = 0;
+
+static CGPoint getCursorPosition()
+{
+	CGEventRef event = CGEventCreate(NULL);
+	CGPoint pos = CGEventGetLocation(event);
+	CFRelease(event);
+
+	return pos;
+}
+
+static CGEventType getButtonEventType(int button, InputEvent::Type type)
+{
+	switch (button)
+	{
+		case 0:
+		if (type == InputEvent::Type::ButtonDown) return kCGEventLeftMouseDown;
+		if (type == InputEvent::Type::ButtonUp) return kCGEventLeftMouseUp;
+		return kCGEventLeftMouseDragged;
+
+		case 2:
+		if (type == InputEvent::Type::ButtonDown) return kCGEventRightMouseDown;
+		if (type == InputEvent::Type::ButtonUp) return kCGEventRightMouseUp;
+		return kCGEventRightMouseDragged;
+
+		default:
+		if (type == InputEvent::Type::ButtonDown) return kCGEventOtherMouseDown;
+		if (type == InputEvent::Type::ButtonUp) return kCGEventOtherMouseUp;
+		return kCGEventOtherMouseDragged;
+	}
+}
+
+// left, middle, right, back and forward
+static const CGMouseButton s_buttons[] = { kCGMouseButtonLeft, kCGMouseButtonCenter, kCGMouseButtonRight, (CGMouseButton)3, (CGMouseButton)4 };
+
+void sendInputEvents(const InputEvent* events, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		const InputEvent& event = events[i];
+
+		CGEventRef cgEvent = NULL;
+
+		switch (event.type)
+		{
+			case InputEvent::Type::Move:
+			{
+				CGPoint pos = CGPointMake(event.pos.x(), event.pos.y());
+
+				// use first pressed button
+				int button = 0;
+
+				while (button < 5 && !(s_pressedButtons & (1 << button))) ++button;
+
+				if (button < 5)
+				{
+					cgEvent = CGEventCreateMouseEvent(NULL, getButtonEventType(button, event.type), pos, s_buttons[button]);
+				}
+				else
+				{
+					cgEvent = CGEventCreateMouseEvent(NULL, kCGEventMouseMoved, pos, kCGMouseButtonLeft);
+				}
+				break;
+			}
+
+			case InputEvent::Type::ButtonDown:
+			case InputEvent::Type::ButtonUp:
+			if (event.button < 0 || event.button >= 5) break;
+
+			if (event.type == InputEvent::Type::ButtonDown)
+			{
+				s_pressedButtons |= 1 << event.button;
+			}
+			else
+			{
+				s_pressedButtons &= ~(1 << event.button);
+			}
+
+			cgEvent = CGEventCreateMouseEvent(NULL, getButtonEventType(event.button, event.type), getCursorPosition(), s_buttons[event.button]);
+			break;
+
+			case InputEvent::Type::Wheel:
+			// positive values scroll up and to the left
+			cgEvent = CGEventCreateScrollWheelEvent(NULL, kCGScrollEventUnitLine, 2, -event.pos.y(), -event.pos.x());
+			break;
+
+			default:
+			// keys are not implemented yet
+			break;
+		}
+
+		if (!cgEvent) continue;
+
+		CGEventPost(kCGHIDEventTap, cgEvent);
+
+		CFRelease(cgEvent);
+	}
+}
+
+int QKeySequenceToVK(const QKeySequence& seq)
+{
+	/*
+	kVK_Return = 0x24,
+		kVK_Tab = 0x30,
+		kVK_Space = 0x31,
+		kVK_Delete = 0x33,
+		kVK_Escape = 0x35,
+		kVK_Command = 0x37,
+		kVK_Shift = 0x38,
+		kVK_CapsLock = 0x39,
+		kVK_Option = 0x3A,
+		kVK_Control = 0x3B,
+		kVK_RightShift = 0x3C,
+		kVK_RightOption = 0x3D,
+		kVK_RightControl = 0x3E,
+		kVK_Function = 0x3F,
+		kVK_F17 = 0x40,
+		kVK_VolumeUp = 0x48,
+		kVK_VolumeDown = 0x49,
+		kVK_Mute = 0x4A,
+		kVK_F18 = 0x4F,
+		kVK_F19 = 0x50,
+		kVK_F20 = 0x5A,
+		kVK_F5 = 0x60,
+		kVK_F6 = 0x61,
+		kVK_F7 = 0x62,
+		kVK_F3 = 0x63,
+		kVK_F8 = 0x64,
+		kVK_F9 = 0x65,
+		kVK_F11 = 0x67,
+		kVK_F13 = 0x69,
+		kVK_F16 = 0x6A,
+		kVK_F14 = 0x6B,
+		kVK_F10 = 0x6D,
+		kVK_F12 = 0x6F,
+		kVK_F15 = 0x71,
+		kVK_Help = 0x72,
+		kVK_Home = 0x73,
+		kVK_PageUp = 0x74,
+		kVK_ForwardDelete = 0x75,
+		kVK_F4 = 0x76,
+		kVK_End = 0x77,
+		kVK_F2 = 0x78,
+		kVK_PageDown = 0x79,
+		kVK_F1 = 0x7A,
+		kVK_LeftArrow = 0x7B,
+		kVK_RightArrow = 0x7C,
+		kVK_DownArrow = 0x7D,
+		kVK_UpArrow = 0x7E
+*/
+	return 0;
+}
+
+KeyStroke keyStrokeFromName(const QString& name)
+{
+	// not implemented yet
+	return KeyStroke();
+}
+
+QVector<KeyStroke> keyStrokesFromText(const QString& text)
+{
+	// not implemented yet
+	return QVector<KeyStroke>(text.size());
+}
+
+bool isKeyPressed(int key)
+{
+	unsigned char keyMap[16];
+	GetKeys((BigEndianUInt32*)&keyMap);
+	return (0 != ((keyMap[key >> 3] >> (key & 7)) & 1));
+}
+
+// set by event tap of waiting thread when cursor moves
+static thread_local bool s_cursorMoved = false;
+
+static CGEventRef cursorTapCallback(CGEventTapProxy proxy, CGEventType type, CGEventRef event, void* userInfo)
+{
+	s_cursorMoved = true;
+
+	return event;
+}
+
+bool waitForCursorMove(const QPoint& pos, int timeout)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	CGEventMask mask = CGEventMaskBit(kCGEventMouseMoved) | CGEventMaskBit(kCGEventLeftMouseDragged) | CGEventMaskBit(kCGEventRightMouseDragged) | CGEventMaskBit(kCGEventOtherMouseDragged);
+
+	// tap is only installed while waiting, like the hook on Windows
+	CFMachPortRef tap = CGEventTapCreate(kCGSessionEventTap, kCGHeadInsertEventTap, kCGEventTapOptionListenOnly, mask, cursorTapCallback, NULL);
+
+	if (!tap)
+	{
+		// application is not allowed to listen to events
+		QThread::msleep(timeout);
+
+		CGPoint cursor = getCursorPosition();
+
+		return QPoint(cursor.x, cursor.y) != pos;
+	}
+
+	CFRunLoopSourceRef source = CFMachPortCreateRunLoopSource(kCFAllocatorDefault, tap, 0);
+	CFRunLoopAddSource(CFRunLoopGetCurrent(), source, kCFRunLoopDefaultMode);
+
+	s_cursorMoved = false;
+
+	bool moved = false;
+
+	for(;;)
+	{
+		qint64 remaining = timeout - timer.elapsed();
+
+		if (remaining <= 0) break;
+
+		// woken up by tap calls or timeout
+		CFRunLoopRunInMode(kCFRunLoopDefaultMode, remaining / 1000.0, true);
+
+		if (s_cursorMoved)
+		{
+			s_cursorMoved = false;
+
+			// moves sent by kClicker are also received
+			CGPoint cursor = getCursorPosition();
+
+			if (QPoint(cursor.x, cursor.y) != pos)
+			{
+				moved = true;
+				break;
+			}
+		}
+	}
+
+	CFRunLoopRemoveSource(CFRunLoopGetCurrent(), source, kCFRunLoopDefaultMode);
+	CFRelease(source);
+
+	CFMachPortInvalidate(tap);
+	CFRelease(tap);
+
+	return moved;
+}
+
+void startCursorMonitoring()
+{
+	// event tap is installed by waitForCursorMove
+}
+
+void stopCursorMonitoring()
+{
+}
+
+void preciseSleep(qint64 duration)
+{
+	static mach_timebase_info_data_t s_timebase = []()
+	{
+		mach_timebase_info_data_t timebase;
+		mach_timebase_info(&timebase);
+		return timebase;
+	}();
+
+	// absolute deadline in ticks of the system clock
+	mach_wait_until(mach_absolute_time() + duration * 1000 * s_timebase.denom / s_timebase.numer);
+}
+
+ProcessUsage getProcessUsage()
+{
+	ProcessUsage usage;
+
+	struct rusage resources;
+
+	if (getrusage(RUSAGE_SELF, &resources) == 0)
+	{
+		usage.cpuTime = (resources.ru_utime.tv_sec + resources.ru_stime.tv_sec) * 1000000LL + resources.ru_utime.tv_usec + resources.ru_stime.tv_usec;
+		usage.wakeups = resources.ru_nvcsw;
+	}
+
+	return usage;
+}
+
+bool captureWindowRegion(WId window, const QRect& rect, ScreenImage& image)
+{
+	return false;
+}
+
+bool isSameWindowAtPos(Window window, const QPoint& pos)
+{
+	return false;
+}
+
+void createWindowsList(Windows& windows)
+{
+}
+
+void createWindowsList(QAbstractItemModel* model)
+{
+}
+
+bool isWindowMinimized(WId id)
+{
+	return false;
+}
+
+bool RestoreMinimizedWindow(WId &id)
+{
+	return false;
+}
+
+void MinimizeWindow(WId id)
+{
+}
+
+bool IsUsingComposition()
+{
+	return true;
+}
+
+void PutForegroundWindow(WId id)
+{
+}
+
+bool IsOS64bits()
+{
+	return true;
+}
+
+#endif
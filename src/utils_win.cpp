@@ -1,594 +1,997 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "utils.h"
-
-#ifdef Q_OS_WIN
-
-enum HBitmapFormat
-{
-	HBitmapNoAlpha,
-	HBitmapPremultipliedAlpha,
-	HBitmapAlpha
-};
-
-QPixmap qt_pixmapFromWinHBITMAP(HBITMAP bitmap, int hbitmapFormat = 0);
-
-//#include <QtWin>
-#include <windows.h>
-#include <tlhelp32.h>
-#include <tchar.h>
-#include <stdio.h>
-#include <ShellAPI.h>
-#include <sdkddkver.h>
-
-#ifdef DEBUG_NEW
-#define new DEBUG_NEW
-#endif
-
-void mouseLeftClickUp(const QPoint& pos)
-{
-	mouse_event(MOUSEEVENTF_LEFTUP, pos.x(), pos.y(), 0, 0);
-}
-
-void mouseLeftClickDown(const QPoint& pos)
-{
-	mouse_event(MOUSEEVENTF_LEFTDOWN, pos.x(), pos.y(), 0, 0);
-}
-
-int QKeySequenceToVK(const QKeySequence& seq)
-{
-	QString str = seq.toString();
-
-	if (str.isEmpty()) return 0;
-
-	static QMap<QString, qint16> s_keyArray;
-
-	if (s_keyArray.isEmpty())
-	{
-		// special characters
-		s_keyArray["Space"] = VK_SPACE;
-		s_keyArray["Ins"] = VK_INSERT;
-		s_keyArray["Del"] = VK_DELETE;
-		s_keyArray["Esc"] = VK_ESCAPE;
-		s_keyArray["Tab"] = VK_TAB;
-		// s_keyArray["Backtab"] = VK_BACK;
-		s_keyArray["Backspace"] = VK_BACK;
-		s_keyArray["Return"] = VK_RETURN;
-		// s_keyArray["Enter"] = VK_ENTER;
-		s_keyArray["Pause"] = VK_PAUSE;
-		s_keyArray["Print"] = VK_PRINT;
-		// s_keyArray["SysReq"] = VK_SYSREQ;
-		s_keyArray["Home"] = VK_HOME;
-		s_keyArray["End"] = VK_END;
-		s_keyArray["Left"] = VK_LEFT;
-		s_keyArray["Up"] = VK_UP;
-		s_keyArray["Right"] = VK_RIGHT;
-		s_keyArray["Down"] = VK_DOWN;
-		s_keyArray["PgUp"] = VK_PRIOR;
-		s_keyArray["PgDown"] = VK_NEXT;
-		s_keyArray["Help"] = VK_HELP;
-		s_keyArray["Menu"] = VK_MENU;
-		s_keyArray["NumLock"] = VK_CAPITAL;
-		s_keyArray["CapsLock"] = VK_NUMLOCK;
-		s_keyArray["ScrollLock"] = VK_SCROLL;
-		s_keyArray["+"] = VK_ADD;
-		s_keyArray["-"] = VK_SUBTRACT;
-		s_keyArray["*"] = VK_MULTIPLY;
-		s_keyArray["/"] = VK_DIVIDE;
-		s_keyArray["/"] = VK_SNAPSHOT;
-		s_keyArray["\xC2\xB2"] = VK_OEM_7;
-		
-		// modifiers
-		s_keyArray["Shift"] = VK_SHIFT;
-		s_keyArray["Control"] = VK_CONTROL;
-		s_keyArray["Alt"] = VK_MENU;
-
-		// numbers numpad
-		for (int i = '0'; i <= '9'; ++i) s_keyArray[QString((const char)i)] = VK_NUMPAD0 + i;
-
-		// letters
-		for (int i = 'A'; i <= 'Z'; ++i) s_keyArray[QString((const char)i)] = i;
-
-		// function keys
-		for (int i = 1; i <= 24; ++i) s_keyArray[QString("F%1").arg(i)] = VK_F1 + i - 1;
-	}
-
-	QMap<QString, qint16>::iterator it = s_keyArray.find(str);
-
-	if (it != s_keyArray.end()) return *it;
-
-	qDebug() << "unable to find" << str;
-
-	return -1;
-}
-
-bool isKeyPressed(int key)
-{
-	SHORT res = GetAsyncKeyState(key);
-
-	if (res)
-	{
-		qDebug() << "key" << res;
-	}
-
-	// only take current keypresses (0x8000) and not previous ones (0x0001)
-	return res & 0x8000;
-}
-
-QPixmap grabWindow(WId /* window */)
-{
-	return QPixmap();
-}
-
-bool isSameWindowAtPos(Window window, const QPoint& pos)
-{
-	POINT p;
-	p.x = pos.x();
-	p.y = pos.y();
-
-	HWND underCursorWindowId = WindowFromPoint(p);
-
-#ifdef _DEBUG
-	QString underCursorWindowTitle;
-
-	if (underCursorWindowId)
-	{
-		wchar_t buffer[1025];
-
-		int len = GetWindowTextW(underCursorWindowId, buffer, 1024);
-
-		if (len > 0) underCursorWindowTitle = QString::fromWCharArray(buffer);
-	}
-#endif
-
-	if (((HWND)window.id == underCursorWindowId) || IsChild((HWND)window.id, underCursorWindowId))
-	{
-#ifdef _DEBUG
-		qDebug() << "same window" << underCursorWindowTitle;
-#endif
-
-		return true;
-	}
-
-#ifdef _DEBUG
-	qDebug() << "different window" << underCursorWindowTitle;
-#endif
-
-	return false;
-}
-
-static QPixmap fancyPants( ICONINFO const &icon_info )
-{
-	int result;
-
-	HBITMAP h_bitmap = icon_info.hbmColor;
-
-	/// adapted from qpixmap_win.cpp so we can have a _non_ premultiplied alpha
-	/// conversion and also apply the icon mask to bitmaps with no alpha channel
-	/// remaining comments are Trolltech originals
-
-
-	////// get dimensions
-	BITMAP bitmap;
-	memset( &bitmap, 0, sizeof(BITMAP) );
-
-	result = GetObjectW( h_bitmap, sizeof(BITMAP), &bitmap );
-
-	if (!result) return QPixmap();
-
-	int const w = bitmap.bmWidth;
-	int const h = bitmap.bmHeight;
-
-	//////
-	BITMAPINFO info;
-	memset( &info, 0, sizeof(info) );
-
-	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-	info.bmiHeader.biWidth = w;
-
-	info.bmiHeader.biHeight = -h;
-	info.bmiHeader.biPlanes = 1;
-
-	info.bmiHeader.biBitCount = 32;
-	info.bmiHeader.biCompression = BI_RGB;
-
-	info.bmiHeader.biSizeImage = w * h * 4;
-
-	// Get bitmap bits
-	uchar *data = new uchar[info.bmiHeader.biSizeImage];
-
-	result = GetDIBits(GetDC(0), h_bitmap, 0, h, data, &info, DIB_RGB_COLORS );
-
-	QPixmap p;
-	if (result)
-	{
-		// test for a completely invisible image
-		// we need to do this because there is apparently no way to determine
-
-		// if an icon's bitmaps have alpha channels or not. If they don't the
-		// alpha bits are set to 0 by default and the icon becomes invisible
-		// so we do this long check. I've investigated everything, the bitmaps
-		// don't seem to carry the BITMAPV4HEADER as they should, that would tell
-		// us what we want to know if it was there, but apparently MS are SHIT SHIT
-		const int N = info.bmiHeader.biSizeImage;
-
-		int x;
-		for (x = 3; x < N; x += 4)
-
-			if (data[x] != 0)
-				break;
-
-		if (x < N)
-		{
-			p = QPixmap::fromImage( QImage( data, w, h, QImage::Format_ARGB32 ) );
-		}
-		else
-		{
-			QImage image( data, w, h, QImage::Format_RGB32 );
-
-			QImage mask = image.createHeuristicMask();
-			mask.invertPixels(); //prolly efficient as is a 1bpp bitmap really
-
-			image.setAlphaChannel( mask );
-			p = QPixmap::fromImage( image );
-		}
-
-		// force the pixmap to make a deep copy of the image data
-		// otherwise `delete data` will corrupt the pixmap
-		QPixmap copy = p;
-		copy.detach();
-
-		p = copy;
-	}
-
-	delete [] data;
-
-	return p;
-}
-
-static QPixmap pixmap( const HICON &icon, bool alpha = true )
-{
-	try
-	{
-		ICONINFO info;
-		::GetIconInfo(icon, &info);
-
-		QPixmap pixmap = alpha ? fancyPants( info )
-#ifdef USE_QT5
-				: qt_pixmapFromWinHBITMAP(info.hbmColor, HBitmapNoAlpha);
-#else
-				: QPixmap::fromWinHBITMAP( info.hbmColor, QPixmap::NoAlpha );
-#endif
-
-		// gah Win32 is annoying!
-		::DeleteObject( info.hbmColor );
-		::DeleteObject( info.hbmMask );
-
-		::DestroyIcon( icon );
-
-		return pixmap;
-	}
-	catch (...)
-	{
-		return QPixmap();
-	}
-}
-
-QPixmap associatedIcon( const QString &path )
-{
-	// performance tuned using:
-	// http://www.codeguru.com/Cpp/COM-Tech/shell/article.php/c4511/
-
-	SHFILEINFOW file_info;
-	memset(&file_info, 0, sizeof(file_info));
-	::SHGetFileInfoW((wchar_t*)path.utf16(), FILE_ATTRIBUTE_NORMAL, &file_info, sizeof(SHFILEINFOW), SHGFI_USEFILEATTRIBUTES | SHGFI_ICON | SHGFI_LARGEICON );
-
-	return pixmap( file_info.hIcon );
-}
-
-static BOOL CALLBACK EnumWindowsProc(HWND hWnd, LPARAM inst)
-{
-	if (IsWindowVisible(hWnd) && IsWindowEnabled(hWnd))
-	{
-		LONG style = GetWindowLong(hWnd, GWL_STYLE);
-
-		if (style & (WS_THICKFRAME|WS_DLGFRAME|WS_POPUP))
-		{
-			wchar_t WindowTitle[80];
-
-			int len = GetWindowTextW(hWnd, WindowTitle, 80);
-
-			if (len > 0)
-			{
-				Windows *windows = (Windows*)inst;
-
-				Window window;
-
-				// define minimum information because some of these windows won't be processed
-				window.id = (WId)hWnd;
-				window.title = QString::fromWCharArray(WindowTitle);
-
-				windows->push_back(window);
-			}
-		}
-	}
-
-	return TRUE;
-}
-
-// Windows 2000 = GetModuleFileName()
-// Windows XP x32 = GetProcessImageFileName()
-// Windows XP x64 = GetProcessImageFileName()
-
-typedef BOOL (WINAPI *QueryFullProcessImageNamePtr)(HANDLE hProcess, DWORD dwFlags, LPWSTR lpExeName, PDWORD lpdwSize);
-typedef DWORD (WINAPI *GetProcessImageFileNamePtr)(HANDLE hProcess, LPWSTR lpImageFileName, DWORD nSize);
-
-static QueryFullProcessImageNamePtr pQueryFullProcessImageName = NULL;
-static GetProcessImageFileNamePtr pGetProcessImageFileName = NULL;
-
-void createWindowsList(Windows &windows)
-{
-	if (pQueryFullProcessImageName == NULL)
-	{
-		pQueryFullProcessImageName = (QueryFullProcessImageNamePtr) QLibrary::resolve("kernel32", "QueryFullProcessImageNameW");
-	}
-
-	if (pGetProcessImageFileName == NULL)
-	{
-		pGetProcessImageFileName = (GetProcessImageFileNamePtr) QLibrary::resolve("psapi", "GetProcessImageFileNameW");
-	}
-
-	HMODULE module = GetModuleHandle(NULL);
-
-	Windows currentWindows;
-
-	// list hWnd
-	THREADENTRY32 te32;
-
-	// Fill in the size of the structure before using it.
-	te32.dwSize = sizeof(THREADENTRY32);
-
-	// Take a snapshot of all running threads
-	HANDLE hThreadSnap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
-
-	// Retrieve information about the first thread,
-	if ((hThreadSnap != INVALID_HANDLE_VALUE) && Thread32First(hThreadSnap, &te32))
-	{
-		// Now walk the thread list of the system,
-		// and display information about each thread
-		// associated with the specified process
-		do
-		{
-			currentWindows.clear();
-
-			EnumThreadWindows(te32.th32ThreadID, EnumWindowsProc, (LPARAM)&currentWindows);
-
-			if (!currentWindows.empty() && te32.th32OwnerProcessID)
-			{
-				for(int i = 0; i < currentWindows.size(); ++i)
-				{
-					HWND hWnd = (HWND)currentWindows[i].id;
-
-					// get process handle
-					DWORD pidwin;
-					GetWindowThreadProcessId(hWnd, &pidwin);
-					HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pidwin);
-
-					// get process path
-					wchar_t szProcessPath[MAX_PATH];
-					DWORD bufSize = MAX_PATH;
-
-					if (pQueryFullProcessImageName != NULL)
-					{
-						if (pQueryFullProcessImageName(hProcess, 0, (LPWSTR)&szProcessPath, &bufSize) == 0)
-						{
-							DWORD error = GetLastError();
-
-							qDebug() << "Error" << error;
-						}
-					}
-					else if (pGetProcessImageFileName != NULL)
-					{
-						bufSize = pGetProcessImageFileName(hProcess, (LPWSTR)&szProcessPath, bufSize);
-					}
-
-					currentWindows[i].path = QString::fromWCharArray(szProcessPath, bufSize);
-
-					// icon
-					HICON hIcon = NULL;
-					UINT count = ExtractIconExW(szProcessPath, -1, NULL, NULL, 1);
-					if (count < 1) continue;
-
-					UINT res = ExtractIconExW(szProcessPath, 0, &hIcon, NULL, 1);
-					QPixmap pixmap = ::pixmap(hIcon);
-					DestroyIcon(hIcon);
-
-					currentWindows[i].icon = pixmap;
-
-					// rectangle
-					RECT r;
-					BOOL res2 = GetWindowRect(hWnd, &r);
-
-					if (res) currentWindows[i].rect = QRect(QPoint(r.left, r.top), QPoint(r.right, r.bottom));
-
-					windows << currentWindows[i];
-				}
-			}
-		}
-		while(Thread32Next(hThreadSnap, &te32));
-
-		CloseHandle(hThreadSnap);
-	}
-}
-
-void createWindowsList(QAbstractItemModel* model)
-{
-	QFileIconProvider icon;
-	QPixmap filePixmap = icon.icon(QFileIconProvider::File).pixmap(32, 32);
-	QPixmap desktopPixmap = icon.icon(QFileIconProvider::Desktop).pixmap(32, 32);
-
-	Windows currentWindows;
-
-	createWindowsList(currentWindows);
-
-	for (int i = 0; i < currentWindows.size(); ++i)
-	{
-		HWND hWnd = (HWND)currentWindows[i].id;
-
-		if (model->insertRow(0))
-		{
-			QModelIndex index = model->index(0, 0);
-
-			model->setData(index, currentWindows[i].title);
-			model->setData(index, currentWindows[i].icon.isNull() ? filePixmap: currentWindows[i].icon, Qt::DecorationRole);
-			model->setData(index, QVariant::fromValue(currentWindows[i]), Qt::UserRole);
-		}
-	}
-
-	model->sort(0);
-
-	if (model->insertRow(0))
-	{
-		QModelIndex index = model->index(0, 0);
-
-		model->setData(index, QObject::tr("Whole screen"));
-		model->setData(index, desktopPixmap, Qt::DecorationRole);
-		model->setData(index, QVariant::fromValue((void*)NULL), Qt::UserRole);
-	}
-}
-
-bool isWindowMinimized(WId id)
-{
-	if (!id) return false;
-
-	WINDOWPLACEMENT placement;
-	memset(&placement, 0, sizeof(placement));
-
-	if (GetWindowPlacement((HWND)id, &placement))
-	{
-		if (placement.showCmd == SW_SHOWMINIMIZED)
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
-
-bool RestoreMinimizedWindow(WId id)
-{
-	if (id)
-	{
-		if (isWindowMinimized(id))
-		{
-			ShowWindow((HWND)id, SW_RESTORE);
-
-			// time needed to restore window
-			Sleep(500);
-
-			return true;
-		}
-	}
-	else
-	{
-		QScreen* screen = QGuiApplication::primaryScreen();
-
-		if (!screen) return false;
-
-		// id = QApplication::desktop()->winId();
-		// time needed to hide capture dialog
-		Sleep(500);
-	}
-
-	return false;
-}
-
-void MinimizeWindow(WId id)
-{
-	ShowWindow((HWND)id, SW_MINIMIZE);
-}
-
-bool IsUsingComposition()
-{
-	typedef BOOL (*voidfuncPtr)(void);
-
-	HINSTANCE hInst = LoadLibraryA("UxTheme.dll");
-
-	bool ret = false;
-
-	if (hInst)
-	{
-		voidfuncPtr fctIsCompositionActive = (voidfuncPtr)GetProcAddress(hInst, "IsCompositionActive");
-
-		if (fctIsCompositionActive)
-		{
-			// only if compositing is not activated
-			if (fctIsCompositionActive())
-				ret = true;
-		}
-
-		FreeLibrary(hInst);
-	}
-
-	return ret;
-}
-
-void PutForegroundWindow(WId id)
-{
-	SetForegroundWindow((HWND)id);
-	Sleep(500);
-}
-
-typedef BOOL (WINAPI *LPFN_ISWOW64PROCESS) (HANDLE, PBOOL);
-
-bool IsOS64bits()
-{
-	bool res;
-
-#ifdef _WIN64
-	res = true;
-#else
-	res = false;
-
-	// IsWow64Process is not available on all supported versions of Windows.
-	// Use GetModuleHandle to get a handle to the DLL that contains the function
-	// and GetProcAddress to get a pointer to the function if available.
-	HMODULE module = GetModuleHandleA("kernel32");
-
-	if (module)
-	{
-		LPFN_ISWOW64PROCESS fnIsWow64Process = (LPFN_ISWOW64PROCESS)GetProcAddress(module, "IsWow64Process");
-
-		if (fnIsWow64Process)
-		{
-			BOOL bIsWow64 = FALSE;
-
-			if (fnIsWow64Process(GetCurrentProcess(), &bIsWow64))
-			{
-				res = bIsWow64 == TRUE;
-			}
-		}
-	}
-#endif
-	return res;
-}
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "utils.h"
+
+#ifdef Q_OS_WIN
+
+enum HBitmapFormat
+{
+	HBitmapNoAlpha,
+	HBitmapPremultipliedAlpha,
+	HBitmapAlpha
+};
+
+QPixmap qt_pixmapFromWinHBITMAP(HBITMAP bitmap, int hbitmapFormat = 0);
+
+//#include <QtWin>
+#include <windows.h>
+#include <tlhelp32.h>
+#include <tchar.h>
+#include <stdio.h>
+#include <ShellAPI.h>
+#include <sdkddkver.h>
+
+#ifdef DEBUG_NEW
+#define new DEBUG_NEW
+#endif
+
+int QKeySequenceToVK(const QKeySequence& seq)
+{
+	QString str = seq.toString();
+
+	if (str.isEmpty()) return 0;
+
+	static QMap<QString, qint16> s_keyArray;
+
+	if (s_keyArray.isEmpty())
+	{
+		// special characters
+		s_keyArray["Space"] = VK_SPACE;
+		s_keyArray["Ins"] = VK_INSERT;
+		s_keyArray["Del"] = VK_DELETE;
+		s_keyArray["Esc"] = VK_ESCAPE;
+		s_keyArray["Tab"] = VK_TAB;
+		// s_keyArray["Backtab"] = VK_BACK;
+		s_keyArray["Backspace"] = VK_BACK;
+		s_keyArray["Return"] = VK_RETURN;
+		// s_keyArray["Enter"] = VK_ENTER;
+		s_keyArray["Pause"] = VK_PAUSE;
+		s_keyArray["Print"] = VK_PRINT;
+		// s_keyArray["SysReq"] = VK_SYSREQ;
+		s_keyArray["Home"] = VK_HOME;
+		s_keyArray["End"] = VK_END;
+		s_keyArray["Left"] = VK_LEFT;
+		s_keyArray["Up"] = VK_UP;
+		s_keyArray["Right"] = VK_RIGHT;
+		s_keyArray["Down"] = VK_DOWN;
+		s_keyArray["PgUp"] = VK_PRIOR;
+		s_keyArray["PgDown"] = VK_NEXT;
+		s_keyArray["Help"] = VK_HELP;
+		s_keyArray["Menu"] = VK_MENU;
+		s_keyArray["NumLock"] = VK_CAPITAL;
+		s_keyArray["CapsLock"] = VK_NUMLOCK;
+		s_keyArray["ScrollLock"] = VK_SCROLL;
+		s_keyArray["+"] = VK_ADD;
+		s_keyArray["-"] = VK_SUBTRACT;
+		s_keyArray["*"] = VK_MULTIPLY;
+		s_keyArray["/"] = VK_DIVIDE;
+		s_keyArray["/"] = VK_SNAPSHOT;
+		s_keyArray["\xC2\xB2"] = VK_OEM_7;
+		
+		// modifiers
+		s_keyArray["Shift"] = VK_SHIFT;
+		s_keyArray["Control"] = VK_CONTROL;
+		s_keyArray["Alt"] = VK_MENU;
+
+		// numbers numpad
+		for (int i = '0'; i <= '9'; ++i) s_keyArray[QString((const char)i)] = VK_NUMPAD0 + i;
+
+		// letters
+		for (int i = 'A'; i <= 'Z'; ++i) s_keyArray[QString((const char)i)] = i;
+
+		// function keys
+		for (int i = 1; i <= 24; ++i) s_keyArray[QString("F%1").arg(i)] = VK_F1 + i - 1;
+	}
+
+	QMap<QString, qint16>::iterator it = s_keyArray.find(str);
+
+	if (it != s_keyArray.end()) return *it;
+
+	qDebug() << "unable to find" << str;
+
+	return -1;
+}
+
+KeyStroke keyStrokeFromName(const QString& name)
+{
+	KeyStroke key;
+
+	if (name.isEmpty()) return key;
+
+	if (name.length() == 1)
+	{
+		// only the key, without any modifier
+		SHORT res = VkKeyScanW(name[0].unicode());
+
+		if (res != -1) key.code = LOBYTE(res);
+
+		return key;
+	}
+
+	if (name == "Shift")
+	{
+		key.code = VK_SHIFT;
+	}
+	else if (name == "Control" || name == "Ctrl")
+	{
+		key.code = VK_CONTROL;
+	}
+	else if (name == "Alt")
+	{
+		key.code = VK_MENU;
+	}
+	else if (name == "AltGr")
+	{
+		key.code = VK_RMENU;
+	}
+	else if (name == "Meta")
+	{
+		key.code = VK_LWIN;
+	}
+	else
+	{
+		key.code = qMax(0, QKeySequenceToVK(QKeySequence(name)));
+	}
+
+	return key;
+}
+
+QVector<KeyStroke> keyStrokesFromText(const QString& text)
+{
+	QVector<KeyStroke> keys;
+
+	for (QChar c : text)
+	{
+		KeyStroke key;
+
+		if (c == '\n' || c == '\r')
+		{
+			key.code = VK_RETURN;
+		}
+		else
+		{
+			SHORT res = VkKeyScanW(c.unicode());
+
+			if (res != -1)
+			{
+				// 1 for Shift, 6 for Control + Alt (AltGr)
+				switch (HIBYTE(res))
+				{
+					case 0: key.code = LOBYTE(res); break;
+					case 1: key.code = LOBYTE(res); key.modifier = VK_SHIFT; break;
+					case 6: key.code = LOBYTE(res); key.modifier = VK_RMENU; break;
+					default: break;
+				}
+			}
+		}
+
+		keys << key;
+	}
+
+	return keys;
+}
+
+// events of a click or a move sample fit on the stack, so sending them never allocates
+typedef QVarLengthArray<INPUT, 16> Inputs;
+
+static void appendKeyInput(Inputs& inputs, quint32 code, bool press)
+{
+	INPUT input;
+	ZeroMemory(&input, sizeof(input));
+
+	input.type = INPUT_KEYBOARD;
+	input.ki.wVk = code;
+	input.ki.dwFlags = press ? 0 : KEYEVENTF_KEYUP;
+
+	inputs << input;
+}
+
+static void appendMouseInput(Inputs& inputs, DWORD flags, LONG x = 0, LONG y = 0, DWORD data = 0)
+{
+	INPUT input;
+	ZeroMemory(&input, sizeof(input));
+
+	input.type = INPUT_MOUSE;
+	input.mi.dx = x;
+	input.mi.dy = y;
+	input.mi.mouseData = data;
+	input.mi.dwFlags = flags;
+
+	inputs << input;
+}
+
+// flags and data for left, middle, right, back and forward buttons
+static const DWORD s_buttonDownFlags[] = { MOUSEEVENTF_LEFTDOWN, MOUSEEVENTF_MIDDLEDOWN, MOUSEEVENTF_RIGHTDOWN, MOUSEEVENTF_XDOWN, MOUSEEVENTF_XDOWN };
+static const DWORD s_buttonUpFlags[] = { MOUSEEVENTF_LEFTUP, MOUSEEVENTF_MIDDLEUP, MOUSEEVENTF_RIGHTUP, MOUSEEVENTF_XUP, MOUSEEVENTF_XUP };
+static const DWORD s_buttonData[] = { 0, 0, 0, XBUTTON1, XBUTTON2 };
+
+void sendInputEvents(const InputEvent* events, int count)
+{
+	Inputs inputs;
+	inputs.reserve(count * 2);
+
+	// absolute coordinates are normalized between 0 and 65535 on the whole virtual screen
+	QRect screen(GetSystemMetrics(SM_XVIRTUALSCREEN), GetSystemMetrics(SM_YVIRTUALSCREEN), GetSystemMetrics(SM_CXVIRTUALSCREEN), GetSystemMetrics(SM_CYVIRTUALSCREEN));
+
+	for (int i = 0; i < count; ++i)
+	{
+		const InputEvent& event = events[i];
+
+		switch (event.type)
+		{
+			case InputEvent::Type::Move:
+			appendMouseInput(inputs, MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE | MOUSEEVENTF_VIRTUALDESK,
+				(event.pos.x() - screen.left()) * 65535 / qMax(1, screen.width() - 1),
+				(event.pos.y() - screen.top()) * 65535 / qMax(1, screen.height() - 1));
+			break;
+
+			case InputEvent::Type::ButtonDown:
+			if (event.button >= 0 && event.button < 5) appendMouseInput(inputs, s_buttonDownFlags[event.button], 0, 0, s_buttonData[event.button]);
+			break;
+
+			case InputEvent::Type::ButtonUp:
+			if (event.button >= 0 && event.button < 5) appendMouseInput(inputs, s_buttonUpFlags[event.button], 0, 0, s_buttonData[event.button]);
+			break;
+
+			case InputEvent::Type::Wheel:
+			// positive values scroll up and to the right
+			if (event.pos.y()) appendMouseInput(inputs, MOUSEEVENTF_WHEEL, 0, 0, (DWORD)(-event.pos.y() * WHEEL_DELTA));
+			if (event.pos.x()) appendMouseInput(inputs, MOUSEEVENTF_HWHEEL, 0, 0, (DWORD)(event.pos.x() * WHEEL_DELTA));
+			break;
+
+			case InputEvent::Type::KeyDown:
+			if (event.key.isNull()) break;
+			if (event.key.modifier) appendKeyInput(inputs, event.key.modifier, true);
+			appendKeyInput(inputs, event.key.code, true);
+			break;
+
+			case InputEvent::Type::KeyUp:
+			if (event.key.isNull()) break;
+			appendKeyInput(inputs, event.key.code, false);
+			if (event.key.modifier) appendKeyInput(inputs, event.key.modifier, false);
+			break;
+		}
+	}
+
+	// inserted in input stream without being interleaved with other events
+	if (!inputs.isEmpty()) SendInput(inputs.size(), inputs.data(), sizeof(INPUT));
+}
+
+bool isKeyPressed(int key)
+{
+	SHORT res = GetAsyncKeyState(key);
+
+	if (res)
+	{
+		qDebug() << "key" << res;
+	}
+
+	// only take current keypresses (0x8000) and not previous ones (0x0001)
+	return res & 0x8000;
+}
+
+// set by mouse hook of waiting thread when user moves the mouse
+static thread_local bool s_cursorMoved = false;
+
+static LRESULT CALLBACK cursorHookProc(int code, WPARAM wParam, LPARAM lParam)
+{
+	// ignore moves sent by kClicker or other programs
+	if (code == HC_ACTION && wParam == WM_MOUSEMOVE && !(((const MSLLHOOKSTRUCT*)lParam)->flags & LLMHF_INJECTED)) s_cursorMoved = true;
+
+	return CallNextHookEx(NULL, code, wParam, lParam);
+}
+
+bool waitForCursorMove(const QPoint& pos, int timeout)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	// hook is only installed while waiting, because it's called by this thread and would delay moves while it's clicking
+	HHOOK hook = SetWindowsHookExW(WH_MOUSE_LL, cursorHookProc, GetModuleHandleW(NULL), 0);
+
+	if (!hook)
+	{
+		Sleep(timeout);
+
+		return QCursor::pos() != pos;
+	}
+
+	s_cursorMoved = false;
+
+	bool moved = false;
+
+	for(;;)
+	{
+		qint64 remaining = timeout - timer.elapsed();
+
+		if (remaining <= 0) break;
+
+		// woken up by hook calls or timeout
+		MsgWaitForMultipleObjects(0, NULL, FALSE, (DWORD)remaining, QS_ALLINPUT);
+
+		MSG msg;
+
+		// hook is called while messages are retrieved
+		while (PeekMessageW(&msg, NULL, 0, 0, PM_REMOVE))
+		{
+			TranslateMessage(&msg);
+			DispatchMessageW(&msg);
+		}
+
+		if (s_cursorMoved)
+		{
+			s_cursorMoved = false;
+
+			POINT cursor;
+
+			if (GetCursorPos(&cursor) && QPoint(cursor.x, cursor.y) != pos)
+			{
+				moved = true;
+				break;
+			}
+		}
+	}
+
+	UnhookWindowsHookEx(hook);
+
+	return moved;
+}
+
+void startCursorMonitoring()
+{
+	// hook is installed by waitForCursorMove
+}
+
+void stopCursorMonitoring()
+{
+}
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+	#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// one timer per thread, never closed
+static HANDLE getWaitableTimer()
+{
+	static thread_local HANDLE s_timer = []()
+	{
+		// high resolution timers are only supported since Windows 10 1803
+		HANDLE timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+		if (!timer) timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+
+		return timer;
+	}();
+
+	return s_timer;
+}
+
+void preciseSleep(qint64 duration)
+{
+	HANDLE timer = getWaitableTimer();
+
+	// negative values are relative, in 100 ns units
+	LARGE_INTEGER dueTime;
+	dueTime.QuadPart = -duration * 10;
+
+	if (!timer || !SetWaitableTimer(timer, &dueTime, 0, NULL, NULL, FALSE))
+	{
+		Sleep((DWORD)((duration + 999) / 1000));
+		return;
+	}
+
+	WaitForSingleObject(timer, INFINITE);
+}
+
+ProcessUsage getProcessUsage()
+{
+	ProcessUsage usage;
+
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+
+	if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+	{
+		ULARGE_INTEGER kernel, user;
+		kernel.LowPart = kernelTime.dwLowDateTime;
+		kernel.HighPart = kernelTime.dwHighDateTime;
+		user.LowPart = userTime.dwLowDateTime;
+		user.HighPart = userTime.dwHighDateTime;
+
+		// in 100 ns
+		usage.cpuTime = (qint64)((kernel.QuadPart + user.QuadPart) / 10);
+	}
+
+	// context switches are not available without undocumented functions
+
+	return usage;
+}
+
+// DIB section reused by all captures of a thread
+struct ScreenCapture
+{
+	ScreenCapture() :dc(NULL), bitmap(NULL), previousBitmap(NULL), bits(nullptr), width(0), height(0)
+	{
+	}
+
+	~ScreenCapture()
+	{
+		release();
+	}
+
+	void release()
+	{
+		if (dc)
+		{
+			SelectObject(dc, previousBitmap);
+			DeleteDC(dc);
+			dc = NULL;
+		}
+
+		if (bitmap)
+		{
+			DeleteObject(bitmap);
+			bitmap = NULL;
+		}
+
+		bits = nullptr;
+		width = 0;
+		height = 0;
+	}
+
+	bool reserve(int w, int h)
+	{
+		if (bitmap && w <= width && h <= height) return true;
+
+		release();
+
+		BITMAPINFO info;
+		memset(&info, 0, sizeof(info));
+
+		info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		info.bmiHeader.biWidth = w;
+		info.bmiHeader.biHeight = -h; // top-down
+		info.bmiHeader.biPlanes = 1;
+		info.bmiHeader.biBitCount = 32;
+		info.bmiHeader.biCompression = BI_RGB;
+
+		void* data = nullptr;
+
+		bitmap = CreateDIBSection(NULL, &info, DIB_RGB_COLORS, &data, NULL, 0);
+
+		if (!bitmap) return false;
+
+		dc = CreateCompatibleDC(NULL);
+		previousBitmap = SelectObject(dc, bitmap);
+
+		bits = (uchar*)data;
+		width = w;
+		height = h;
+
+		return true;
+	}
+
+	HDC dc;
+	HBITMAP bitmap;
+	HGDIOBJ previousBitmap;
+	uchar* bits;
+	int width;
+	int height;
+};
+
+bool captureWindowRegion(WId window, const QRect& rect, ScreenImage& image)
+{
+	static thread_local ScreenCapture s_capture;
+
+	RECT windowRect;
+
+	if (window)
+	{
+		if (!GetWindowRect((HWND)window, &windowRect)) return false;
+	}
+	else
+	{
+		windowRect.left = GetSystemMetrics(SM_XVIRTUALSCREEN);
+		windowRect.top = GetSystemMetrics(SM_YVIRTUALSCREEN);
+		windowRect.right = windowRect.left + GetSystemMetrics(SM_CXVIRTUALSCREEN);
+		windowRect.bottom = windowRect.top + GetSystemMetrics(SM_CYVIRTUALSCREEN);
+	}
+
+	QRect windowArea(windowRect.left, windowRect.top, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top);
+
+	// absolute coordinates, virtual screen can start at negative coordinates
+	QRect area = rect.isNull() ? windowArea : rect.translated(window ? windowArea.topLeft() : QPoint(0, 0)).intersected(windowArea);
+
+	if (area.isEmpty() || !s_capture.reserve(area.width(), area.height())) return false;
+
+	// what is visible on screen
+	HDC screen = GetDC(NULL);
+
+	BOOL res = BitBlt(s_capture.dc, 0, 0, area.width(), area.height(), screen, area.x(), area.y(), SRCCOPY);
+
+	ReleaseDC(NULL, screen);
+
+	if (!res) return false;
+
+	GdiFlush();
+
+	image.bits = s_capture.bits;
+	image.width = area.width();
+	image.height = area.height();
+	image.bytesPerLine = s_capture.width * 4;
+	image.pos = area.topLeft();
+
+	return true;
+}
+
+bool isSameWindowAtPos(Window window, const QPoint& pos)
+{
+	POINT p;
+	p.x = pos.x();
+	p.y = pos.y();
+
+	HWND underCursorWindowId = WindowFromPoint(p);
+
+#ifdef _DEBUG
+	QString underCursorWindowTitle;
+
+	if (underCursorWindowId)
+	{
+		wchar_t buffer[1025];
+
+		int len = GetWindowTextW(underCursorWindowId, buffer, 1024);
+
+		if (len > 0) underCursorWindowTitle = QString::fromWCharArray(buffer);
+	}
+#endif
+
+	if (((HWND)window.id == underCursorWindowId) || IsChild((HWND)window.id, underCursorWindowId))
+	{
+#ifdef _DEBUG
+		qDebug() << "same window" << underCursorWindowTitle;
+#endif
+
+		return true;
+	}
+
+#ifdef _DEBUG
+	qDebug() << "different window" << underCursorWindowTitle;
+#endif
+
+	return false;
+}
+
+static QPixmap fancyPants( ICONINFO const &icon_info )
+{
+	int result;
+
+	HBITMAP h_bitmap = icon_info.hbmColor;
+
+	/// adapted from qpixmap_win.cpp so we can have a _non_ premultiplied alpha
+	/// conversion and also apply the icon mask to bitmaps with no alpha channel
+	/// remaining comments are Trolltech originals
+
+
+	////// get dimensions
+	BITMAP bitmap;
+	memset( &bitmap, 0, sizeof(BITMAP) );
+
+	result = GetObjectW( h_bitmap, sizeof(BITMAP), &bitmap );
+
+	if (!result) return QPixmap();
+
+	int const w = bitmap.bmWidth;
+	int const h = bitmap.bmHeight;
+
+	//////
+	BITMAPINFO info;
+	memset( &info, 0, sizeof(info) );
+
+	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	info.bmiHeader.biWidth = w;
+
+	info.bmiHeader.biHeight = -h;
+	info.bmiHeader.biPlanes = 1;
+
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+
+	info.bmiHeader.biSizeImage = w * h * 4;
+
+	// Get bitmap bits
+	uchar *data = new uchar[info.bmiHeader.biSizeImage];
+
+	result = GetDIBits(GetDC(0), h_bitmap, 0, h, data, &info, DIB_RGB_COLORS );
+
+	QPixmap p;
+	if (result)
+	{
+		// test for a completely invisible image
+		// we need to do this because there is apparently no way to determine
+
+		// if an icon's bitmaps have alpha channels or not. If they don't the
+		// alpha bits are set to 0 by default and the icon becomes invisible
+		// so we do this long check. I've investigated everything, the bitmaps
+		// don't seem to carry the BITMAPV4HEADER as they should, that would tell
+		// us what we want to know if it was there, but apparently MS are SHIT SHIT
+		const int N = info.bmiHeader.biSizeImage;
+
+		int x;
+		for (x = 3; x < N; x += 4)
+
+			if (data[x] != 0)
+				break;
+
+		if (x < N)
+		{
+			p = QPixmap::fromImage( QImage( data, w, h, QImage::Format_ARGB32 ) );
+		}
+		else
+		{
+			QImage image( data, w, h, QImage::Format_RGB32 );
+
+			QImage mask = image.createHeuristicMask();
+			mask.invertPixels(); //prolly efficient as is a 1bpp bitmap really
+
+			image.setAlphaChannel( mask );
+			p = QPixmap::fromImage( image );
+		}
+
+		// force the pixmap to make a deep copy of the image data
+		// otherwise `delete data` will corrupt the pixmap
+		QPixmap copy = p;
+		copy.detach();
+
+		p = copy;
+	}
+
+	delete [] data;
+
+	return p;
+}
+
+static QPixmap pixmap( const HICON &icon, bool alpha = true )
+{
+	try
+	{
+		ICONINFO info;
+		::GetIconInfo(icon, &info);
+
+		QPixmap pixmap = alpha ? fancyPants( info )
+#ifdef USE_QT5
+				: qt_pixmapFromWinHBITMAP(info.hbmColor, HBitmapNoAlpha);
+#else
+				: QPixmap::fromWinHBITMAP( info.hbmColor, QPixmap::NoAlpha );
+#endif
+
+		// gah Win32 is annoying!
+		::DeleteObject( info.hbmColor );
+		::DeleteObject( info.hbmMask );
+
+		::DestroyIcon( icon );
+
+		return pixmap;
+	}
+	catch (...)
+	{
+		return QPixmap();
+	}
+}
+
+QPixmap associatedIcon( const QString &path )
+{
+	// performance tuned using:
+	// http://www.codeguru.com/Cpp/COM-Tech/shell/article.php/c4511/
+
+	SHFILEINFOW file_info;
+	memset(&file_info, 0, sizeof(file_info));
+	::SHGetFileInfoW((wchar_t*)path.utf16(), FILE_ATTRIBUTE_NORMAL, &file_info, sizeof(SHFILEINFOW), SHGFI_USEFILEATTRIBUTES | SHGFI_ICON | SHGFI_LARGEICON );
+
+	return pixmap( file_info.hIcon );
+}
+
+static BOOL CALLBACK EnumWindowsProc(HWND hWnd, LPARAM inst)
+{
+	if (IsWindowVisible(hWnd) && IsWindowEnabled(hWnd))
+	{
+		LONG style = GetWindowLong(hWnd, GWL_STYLE);
+
+		if (style & (WS_THICKFRAME|WS_DLGFRAME|WS_POPUP))
+		{
+			wchar_t WindowTitle[80];
+
+			int len = GetWindowTextW(hWnd, WindowTitle, 80);
+
+			if (len > 0)
+			{
+				Windows *windows = (Windows*)inst;
+
+				Window window;
+
+				// define minimum information because some of these windows won't be processed
+				window.id = (WId)hWnd;
+				window.title = QString::fromWCharArray(WindowTitle);
+
+				windows->push_back(window);
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+// Windows 2000 = GetModuleFileName()
+// Windows XP x32 = GetProcessImageFileName()
+// Windows XP x64 = GetProcessImageFileName()
+
+typedef BOOL (WINAPI *QueryFullProcessImageNamePtr)(HANDLE hProcess, DWORD dwFlags, LPWSTR lpExeName, PDWORD lpdwSize);
+typedef DWORD (WINAPI *GetProcessImageFileNamePtr)(HANDLE hProcess, LPWSTR lpImageFileName, DWORD nSize);
+
+static QueryFullProcessImageNamePtr pQueryFullProcessImageName = NULL;
+static GetProcessImageFileNamePtr pGetProcessImageFileName = NULL;
+
+void createWindowsList(Windows &windows)
+{
+	if (pQueryFullProcessImageName == NULL)
+	{
+		pQueryFullProcessImageName = (QueryFullProcessImageNamePtr) QLibrary::resolve("kernel32", "QueryFullProcessImageNameW");
+	}
+
+	if (pGetProcessImageFileName == NULL)
+	{
+		pGetProcessImageFileName = (GetProcessImageFileNamePtr) QLibrary::resolve("psapi", "GetProcessImageFileNameW");
+	}
+
+	HMODULE module = GetModuleHandle(NULL);
+
+	Windows currentWindows;
+
+	// list hWnd
+	THREADENTRY32 te32;
+
+	// Fill in the size of the structure before using it.
+	te32.dwSize = sizeof(THREADENTRY32);
+
+	// Take a snapshot of all running threads
+	HANDLE hThreadSnap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+
+	// Retrieve information about the first thread,
+	if ((hThreadSnap != INVALID_HANDLE_VALUE) && Thread32First(hThreadSnap, &te32))
+	{
+		// Now walk the thread list of the system,
+		// and display information about each thread
+		// associated with the specified process
+		do
+		{
+			currentWindows.clear();
+
+			EnumThreadWindows(te32.th32ThreadID, EnumWindowsProc, (LPARAM)&currentWindows);
+
+			if (!currentWindows.empty() && te32.th32OwnerProcessID)
+			{
+				for(int i = 0; i < currentWindows.size(); ++i)
+				{
+					HWND hWnd = (HWND)currentWindows[i].id;
+
+					// get process handle
+					DWORD pidwin;
+					GetWindowThreadProcessId(hWnd, &pidwin);
+					HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pidwin);
+
+					// get process path
+					wchar_t szProcessPath[MAX_PATH];
+					DWORD bufSize = MAX_PATH;
+
+					if (pQueryFullProcessImageName != NULL)
+					{
+						if (pQueryFullProcessImageName(hProcess, 0, (LPWSTR)&szProcessPath, &bufSize) == 0)
+						{
+							DWORD error = GetLastError();
+
+							qDebug() << "Error" << error;
+						}
+					}
+					else if (pGetProcessImageFileName != NULL)
+					{
+						bufSize = pGetProcessImageFileName(hProcess, (LPWSTR)&szProcessPath, bufSize);
+					}
+
+					currentWindows[i].path = QString::fromWCharArray(szProcessPath, bufSize);
+
+					// icon
+					HICON hIcon = NULL;
+					UINT count = ExtractIconExW(szProcessPath, -1, NULL, NULL, 1);
+					if (count < 1) continue;
+
+					UINT res = ExtractIconExW(szProcessPath, 0, &hIcon, NULL, 1);
+					QPixmap pixmap = ::pixmap(hIcon);
+					DestroyIcon(hIcon);
+
+					currentWindows[i].icon = pixmap;
+
+					// rectangle
+					RECT r;
+					BOOL res2 = GetWindowRect(hWnd, &r);
+
+					if (res) currentWindows[i].rect = QRect(QPoint(r.left, r.top), QPoint(r.right, r.bottom));
+
+					windows << currentWindows[i];
+				}
+			}
+		}
+		while(Thread32Next(hThreadSnap, &te32));
+
+		CloseHandle(hThreadSnap);
+	}
+}
+
+void createWindowsList(QAbstractItemModel* model)
+{
+	QFileIconProvider icon;
+	QPixmap filePixmap = icon.icon(QFileIconProvider::File).pixmap(32, 32);
+	QPixmap desktopPixmap = icon.icon(QFileIconProvider::Desktop).pixmap(32, 32);
+
+	Windows currentWindows;
+
+	createWindowsList(currentWindows);
+
+	for (int i = 0; i < currentWindows.size(); ++i)
+	{
+		HWND hWnd = (HWND)currentWindows[i].id;
+
+		if (model->insertRow(0))
+		{
+			QModelIndex index = model->index(0, 0);
+
+			model->setData(index, currentWindows[i].title);
+			model->setData(index, currentWindows[i].icon.isNull() ? filePixmap: currentWindows[i].icon, Qt::DecorationRole);
+			model->setData(index, QVariant::fromValue(currentWindows[i]), Qt::UserRole);
+		}
+	}
+
+	model->sort(0);
+
+	if (model->insertRow(0))
+	{
+		QModelIndex index = model->index(0, 0);
+
+		model->setData(index, QObject::tr("Whole screen"));
+		model->setData(index, desktopPixmap, Qt::DecorationRole);
+		model->setData(index, QVariant::fromValue((void*)NULL), Qt::UserRole);
+	}
+}
+
+bool isWindowMinimized(WId id)
+{
+	if (!id) return false;
+
+	WINDOWPLACEMENT placement;
+	memset(&placement, 0, sizeof(placement));
+
+	if (GetWindowPlacement((HWND)id, &placement))
+	{
+		if (placement.showCmd == SW_SHOWMINIMIZED)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool RestoreMinimizedWindow(WId id)
+{
+	if (id)
+	{
+		if (isWindowMinimized(id))
+		{
+			ShowWindow((HWND)id, SW_RESTORE);
+
+			// time needed to restore window
+			Sleep(500);
+
+			return true;
+		}
+	}
+	else
+	{
+		QScreen* screen = QGuiApplication::primaryScreen();
+
+		if (!screen) return false;
+
+		// id = QApplication::desktop()->winId();
+		// time needed to hide capture dialog
+		Sleep(500);
+	}
+
+	return false;
+}
+
+void MinimizeWindow(WId id)
+{
+	ShowWindow((HWND)id, SW_MINIMIZE);
+}
+
+bool IsUsingComposition()
+{
+	typedef BOOL (*voidfuncPtr)(void);
+
+	HINSTANCE hInst = LoadLibraryA("UxTheme.dll");
+
+	bool ret = false;
+
+	if (hInst)
+	{
+		voidfuncPtr fctIsCompositionActive = (voidfuncPtr)GetProcAddress(hInst, "IsCompositionActive");
+
+		if (fctIsCompositionActive)
+		{
+			// only if compositing is not activated
+			if (fctIsCompositionActive())
+				ret = true;
+		}
+
+		FreeLibrary(hInst);
+	}
+
+	return ret;
+}
+
+void PutForegroundWindow(WId id)
+{
+	SetForegroundWindow((HWND)id);
+	Sleep(500);
+}
+
+typedef BOOL (WINAPI *LPFN_ISWOW64PROCESS) (HANDLE, PBOOL);
+
+bool IsOS64bits()
+{
+	bool res;
+
+#ifdef _WIN64
+	res = true;
+#else
+	res = false;
+
+	// IsWow64Process is not available on all supported versions of Windows.
+	// Use GetModuleHandle to get a handle to the DLL that contains the function
+	// and GetProcAddress to get a pointer to the function if available.
+	HMODULE module = GetModuleHandleA("kernel32");
+
+	if (module)
+	{
+		LPFN_ISWOW64PROCESS fnIsWow64Process = (LPFN_ISWOW64PROCESS)GetProcAddress(module, "IsWow64Process");
+
+		if (fnIsWow64Process)
+		{
+			BOOL bIsWow64 = FALSE;
+
+			if (fnIsWow64Process(GetCurrentProcess(), &bIsWow64))
+			{
+				res = bIsWow64 == TRUE;
+			}
+		}
+	}
+#endif
+	return res;
+}
+
+#endif
@@ -1,184 +1,807 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#include "common.h"
-#include "utils.h"
-
-#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <ctype.h>
-#include <X11/Xos.h>
-#include <X11/Xlib.h>
-#include <X11/Xatom.h>
-#include <X11/Xutil.h>
-#include <X11/Xmu/WinUtil.h>
-
-#ifdef index
-	#undef index
-#endif
-
-#ifdef DEBUG_NEW
-	#define new DEBUG_NEW
-#endif
-
-void mouseLeftClickUp(const QPoint& pos)
-{
-}
-
-void mouseLeftClickDown(const QPoint& pos)
-{
-}
-
-int QKeySequenceToVK(const QKeySequence& seq)
-{
-	return 0;
-}
-
-bool isKeyPressed(int key)
-{
-	return false;
-}
-
-static void print_client_properties(Display *dpy, Window w, QAbstractItemModel *model)
-{
-	// retrieve window name
-	char *name = NULL;
-//	Status status = XFetchName(dpy, w, &name);
-
-	if (name && *name != '\0' && model->insertRow(0))
-	{
-		QPixmap pixmap;
-
-		QModelIndex index = model->index(0, 0);
-
-		model->setData(index, QString(name));
-		model->setData(index, pixmap, Qt::DecorationRole);
-		model->setData(index, qVariantFromValue((WId)w), Qt::UserRole);
-	}
-
-	XFree(name);
-}
-
-static void lookat(Display *dpy, Window root, QAbstractItemModel *model)
-{
-	Window dummy, *children = NULL, client;
-	unsigned int nchildren = 0;
-
-	// clients are not allowed to stomp on the root and ICCCM doesn't yet
-	// say anything about window managers putting stuff there; but, try
-	// anyway.
-	print_client_properties (dpy, root, model);
-
-	// then, get the list of windows
-	if (!XQueryTree (dpy, root, &dummy, &dummy, &children, &nchildren)) return;
-
-	for (unsigned int i = 0; i < nchildren; ++i)
-	{
-		client = XmuClientWindow (dpy, children[i]);
-		if (client != None)
-			print_client_properties (dpy, client, model);
-	}
-
-	QFileIconProvider icon;
-
-	if (model->insertRow(0))
-	{
-		QModelIndex index = model->index(0, 0);
-
-		model->setData(index, QObject::tr("Whole screen"));
-		model->setData(index, icon.icon(QFileIconProvider::Desktop).pixmap(32, 32), Qt::DecorationRole);
-		model->setData(index, qVariantFromValue((WId)root), Qt::UserRole);
-	}
-}
-
-void CreateWindowsList(QAbstractItemModel *model)
-{
-	char *displayname = NULL;
-	bool all_screens = false;
-
-	Display *dpy = XOpenDisplay (displayname);
-
-	if (!dpy) return;
-
-	if (all_screens)
-	{
-		for (int i = 0; i < ScreenCount(dpy); ++i)
-			lookat (dpy, RootWindow(dpy,i), model);
-	}
-	else
-	{
-		lookat (dpy, DefaultRootWindow(dpy), model);
-	}
-
-	XCloseDisplay (dpy);
-
-	model->sort(0);
-}
-
-bool RestoreMinimizedWindow(WId &id)
-{
-	return false;
-}
-
-void MinimizeWindow(WId id)
-{
-}
-
-bool IsUsingComposition()
-{
-	return true;
-}
-
-void PutForegroundWindow(WId id)
-{
-}
-
-bool IsOS64bits()
-{
-	return true;
-}
-
-bool InitSystemProgress()
-{
-	return false;
-}
-
-bool UninitSystemProgress()
-{
-	return false;
-}
-
-bool BeginSystemProgress()
-{
-	return false;
-}
-
-bool UpdateSystemProgress(qint64 value, qint64 total)
-{
-	return false;
-}
-
-bool EndSystemProgress()
-{
-	return false;
-}
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "utils.h"
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <X11/Xos.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+#include <X11/Xmu/WinUtil.h>
+#include <X11/extensions/XTest.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/record.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/resource.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+
+#ifdef index
+	#undef index
+#endif
+
+#ifdef DEBUG_NEW
+	#define new DEBUG_NEW
+#endif
+
+// only used by clicker thread
+static Display* getInputDisplay()
+{
+	static Display* s_display = XOpenDisplay(NULL);
+
+	return s_display;
+}
+
+// X11 buttons for left, middle, right, back and forward
+static const unsigned int s_buttons[] = { Button1, Button2, Button3, 8, 9 };
+
+// each wheel step is a click on a button
+static void fakeWheel(Display* dpy, unsigned int button, int steps)
+{
+	for (int i = 0; i < steps; ++i)
+	{
+		XTestFakeButtonEvent(dpy, button, True, CurrentTime);
+		XTestFakeButtonEvent(dpy, button, False, CurrentTime);
+	}
+}
+
+void sendInputEvents(const InputEvent* events, int count)
+{
+	Display* dpy = getInputDisplay();
+
+	if (!dpy) return;
+
+	// requests are buffered by Xlib until flush
+	for (int i = 0; i < count; ++i)
+	{
+		const InputEvent& event = events[i];
+
+		switch (event.type)
+		{
+			case InputEvent::Type::Move:
+			// -1 for current screen
+			XTestFakeMotionEvent(dpy, -1, event.pos.x(), event.pos.y(), CurrentTime);
+			break;
+
+			case InputEvent::Type::ButtonDown:
+			case InputEvent::Type::ButtonUp:
+			if (event.button >= 0 && event.button < 5) XTestFakeButtonEvent(dpy, s_buttons[event.button], event.type == InputEvent::Type::ButtonDown, CurrentTime);
+			break;
+
+			case InputEvent::Type::Wheel:
+			// buttons 4 and 5 scroll up and down, 6 and 7 scroll left and right
+			fakeWheel(dpy, event.pos.y() < 0 ? Button4 : Button5, qAbs(event.pos.y()));
+			fakeWheel(dpy, event.pos.x() < 0 ? 6 : 7, qAbs(event.pos.x()));
+			break;
+
+			case InputEvent::Type::KeyDown:
+			if (event.key.isNull()) break;
+			if (event.key.modifier) XTestFakeKeyEvent(dpy, event.key.modifier, True, CurrentTime);
+			XTestFakeKeyEvent(dpy, event.key.code, True, CurrentTime);
+			break;
+
+			case InputEvent::Type::KeyUp:
+			if (event.key.isNull()) break;
+			XTestFakeKeyEvent(dpy, event.key.code, False, CurrentTime);
+			if (event.key.modifier) XTestFakeKeyEvent(dpy, event.key.modifier, False, CurrentTime);
+			break;
+		}
+	}
+
+	XFlush(dpy);
+}
+
+// keysym of a character, Latin-1 keysyms have the same values as Unicode
+static KeySym charToKeySym(uint c)
+{
+	if (c == '\n' || c == '\r') return XK_Return;
+	if (c == '\t') return XK_Tab;
+	if ((c >= 0x20 && c <= 0x7e) || (c >= 0xa0 && c <= 0xff)) return c;
+
+	return 0x01000000 | c;
+}
+
+static KeyStroke keySymToKeyStroke(Display* dpy, KeySym keysym)
+{
+	KeyStroke key;
+
+	KeyCode code = XKeysymToKeycode(dpy, keysym);
+
+	if (!code) return key;
+
+	// keysyms of a key on first group: without modifier, with Shift and with AltGr
+	static const KeySym s_modifiers[] = { NoSymbol, XK_Shift_L, XK_ISO_Level3_Shift };
+
+	for (int level = 0; level < 3; ++level)
+	{
+		if (XkbKeycodeToKeysym(dpy, code, 0, level) != keysym) continue;
+
+		if (s_modifiers[level] != NoSymbol)
+		{
+			key.modifier = XKeysymToKeycode(dpy, s_modifiers[level]);
+
+			// keyboard has no AltGr key
+			if (!key.modifier) return key;
+		}
+
+		key.code = code;
+		break;
+	}
+
+	return key;
+}
+
+KeyStroke keyStrokeFromName(const QString& name)
+{
+	Display* dpy = getInputDisplay();
+
+	KeyStroke key;
+
+	if (!dpy || name.isEmpty()) return key;
+
+	// QKeySequence names which are different from keysyms names
+	static QMap<QString, QString> s_keySymNames;
+
+	if (s_keySymNames.isEmpty())
+	{
+		s_keySymNames["Esc"] = "Escape";
+		s_keySymNames["Del"] = "Delete";
+		s_keySymNames["Ins"] = "Insert";
+		s_keySymNames["Backspace"] = "BackSpace";
+		s_keySymNames["PgUp"] = "Prior";
+		s_keySymNames["PgDown"] = "Next";
+		s_keySymNames["Enter"] = "KP_Enter";
+		s_keySymNames["CapsLock"] = "Caps_Lock";
+		s_keySymNames["NumLock"] = "Num_Lock";
+		s_keySymNames["ScrollLock"] = "Scroll_Lock";
+
+		// modifiers
+		s_keySymNames["Shift"] = "Shift_L";
+		s_keySymNames["Control"] = "Control_L";
+		s_keySymNames["Ctrl"] = "Control_L";
+		s_keySymNames["Alt"] = "Alt_L";
+		s_keySymNames["AltGr"] = "ISO_Level3_Shift";
+		s_keySymNames["Meta"] = "Super_L";
+	}
+
+	KeySym keysym = NoSymbol;
+
+	if (name.length() == 1)
+	{
+		keysym = charToKeySym(name[0].unicode());
+	}
+	else
+	{
+		keysym = XStringToKeysym(s_keySymNames.value(name, name).toLatin1().constData());
+	}
+
+	if (keysym == NoSymbol) return key;
+
+	// only the key, without any modifier
+	key.code = XKeysymToKeycode(dpy, keysym);
+
+	return key;
+}
+
+QVector<KeyStroke> keyStrokesFromText(const QString& text)
+{
+	Display* dpy = getInputDisplay();
+
+	QVector<KeyStroke> keys;
+
+	if (!dpy) return keys;
+
+	for (uint c : text.toUcs4())
+	{
+		keys << keySymToKeyStroke(dpy, charToKeySym(c));
+	}
+
+	return keys;
+}
+
+// code of the last error received by the thread while an XErrorTrap was active
+static thread_local int s_lastXError = 0;
+
+static int trapXError(Display* /* display */, XErrorEvent* event)
+{
+	s_lastXError = event->error_code;
+
+	return 0;
+}
+
+// catch X errors instead of letting default handler terminate the process
+class XErrorTrap
+{
+public:
+	XErrorTrap(Display* display) :m_display(display)
+	{
+		s_lastXError = 0;
+
+		m_previousHandler = XSetErrorHandler(trapXError);
+	}
+
+	~XErrorTrap()
+	{
+		XSetErrorHandler(m_previousHandler);
+	}
+
+	// errors of requests without reply are only received after a round trip
+	bool hasError()
+	{
+		XSync(m_display, False);
+
+		return s_lastXError != 0;
+	}
+
+private:
+	Display* m_display;
+	XErrorHandler m_previousHandler;
+};
+
+// shared memory segment reused by all captures of a thread, server writes directly into it
+struct ScreenCapture
+{
+	ScreenCapture() :display(NULL), useShm(false), image(NULL), shmSize(0), ximage(NULL)
+	{
+		memset(&shm, 0, sizeof(shm));
+
+		display = XOpenDisplay(NULL);
+
+		useShm = display && XShmQueryExtension(display);
+	}
+
+	~ScreenCapture()
+	{
+		releaseImage();
+		releaseSegment();
+
+		if (display) XCloseDisplay(display);
+	}
+
+	void releaseImage()
+	{
+		if (image)
+		{
+			// pixels belong to shared memory segment
+			image->data = NULL;
+			XDestroyImage(image);
+			image = NULL;
+		}
+
+		if (ximage)
+		{
+			XDestroyImage(ximage);
+			ximage = NULL;
+		}
+	}
+
+	void releaseSegment()
+	{
+		if (!shm.shmaddr) return;
+
+		XShmDetach(display, &shm);
+		XSync(display, False);
+
+		shmdt(shm.shmaddr);
+
+		memset(&shm, 0, sizeof(shm));
+		shmSize = 0;
+	}
+
+	// return an image with the requested size, only allocate a new segment if too small
+	XImage* reserve(int width, int height)
+	{
+		if (image && image->width == width && image->height == height) return image;
+
+		releaseImage();
+
+		int screen = DefaultScreen(display);
+
+		// only create a header, pixels are in shared memory
+		image = XShmCreateImage(display, DefaultVisual(display, screen), DefaultDepth(display, screen), ZPixmap, NULL, &shm, width, height);
+
+		if (!image) return NULL;
+
+		size_t size = image->bytes_per_line * image->height;
+
+		if (size > shmSize)
+		{
+			releaseSegment();
+
+			shm.shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+
+			if (shm.shmid == -1)
+			{
+				releaseImage();
+				return NULL;
+			}
+
+			shm.shmaddr = (char*)shmat(shm.shmid, NULL, 0);
+			shm.readOnly = False;
+
+			// segment will be deleted when detached by both processes
+			shmctl(shm.shmid, IPC_RMID, NULL);
+
+			bool attached = false;
+
+			if (shm.shmaddr != (char*)-1)
+			{
+				// MIT-SHM can be advertised but unusable, for example on remote displays, error is received asynchronously
+				XErrorTrap trap(display);
+
+				attached = XShmAttach(display, &shm) && !trap.hasError();
+			}
+
+			if (!attached)
+			{
+				if (shm.shmaddr != (char*)-1) shmdt(shm.shmaddr);
+
+				memset(&shm, 0, sizeof(shm));
+
+				releaseImage();
+
+				// use XGetImage for next captures
+				useShm = false;
+
+				return NULL;
+			}
+
+			shmSize = size;
+		}
+
+		image->data = shm.shmaddr;
+
+		return image;
+	}
+
+	Display* display;
+	bool useShm;
+	XShmSegmentInfo shm;
+	XImage* image;
+	size_t shmSize;
+
+	// only used without MIT-SHM extension
+	XImage* ximage;
+};
+
+bool captureWindowRegion(WId window, const QRect& rect, ScreenImage& image)
+{
+	static thread_local ScreenCapture s_capture;
+
+	Display* dpy = s_capture.display;
+
+	if (!dpy) return false;
+
+	// window can be destroyed or area can be outside of screen, requests with a reply return an error
+	XErrorTrap trap(dpy);
+
+	XID root = DefaultRootWindow(dpy);
+
+	XWindowAttributes rootAttributes;
+
+	if (!XGetWindowAttributes(dpy, root, &rootAttributes)) return false;
+
+	QRect windowArea(0, 0, rootAttributes.width, rootAttributes.height);
+
+	if (window && (XID)window != root)
+	{
+		XWindowAttributes attributes;
+
+		if (!XGetWindowAttributes(dpy, (XID)window, &attributes)) return false;
+
+		int x = 0, y = 0;
+		XID child;
+
+		XTranslateCoordinates(dpy, (XID)window, root, 0, 0, &x, &y, &child);
+
+		windowArea = QRect(x, y, attributes.width, attributes.height);
+	}
+
+	// always capture root window to get what is visible on screen, whatever the window depth
+	QRect area = (rect.isNull() ? windowArea : rect.translated(windowArea.topLeft()).intersected(windowArea)).intersected(QRect(0, 0, rootAttributes.width, rootAttributes.height));
+
+	if (area.isEmpty()) return false;
+
+	XImage* ximage = NULL;
+
+	if (s_capture.useShm)
+	{
+		ximage = s_capture.reserve(area.width(), area.height());
+
+		if (ximage && !XShmGetImage(dpy, root, ximage, area.x(), area.y(), AllPlanes)) ximage = NULL;
+	}
+
+	// shared memory could also have been disabled by reserve
+	if (!s_capture.useShm)
+	{
+		s_capture.releaseImage();
+
+		// slower, pixels are copied by Xlib
+		ximage = s_capture.ximage = XGetImage(dpy, root, area.x(), area.y(), area.width(), area.height(), AllPlanes, ZPixmap);
+	}
+
+	// errors of requests with a reply have already been received
+	if (s_lastXError) return false;
+
+	// only 32 bits little endian BGRA is supported
+	if (!ximage || ximage->bits_per_pixel != 32 || ximage->byte_order != LSBFirst) return false;
+
+	image.bits = (const uchar*)ximage->data;
+	image.width = area.width();
+	image.height = area.height();
+	image.bytesPerLine = ximage->bytes_per_line;
+	image.pos = area.topLeft();
+
+	return true;
+}
+
+int QKeySequenceToVK(const QKeySequence& seq)
+{
+	return 0;
+}
+
+bool isKeyPressed(int key)
+{
+	return false;
+}
+
+struct MotionListener
+{
+	MotionListener() :controlDisplay(nullptr), dataDisplay(nullptr), context(0), enabled(false), moved(false)
+	{
+	}
+
+	// recorded data are received on their own display
+	Display* controlDisplay;
+	Display* dataDisplay;
+
+	XRecordContext context;
+
+	// true until server confirmed context is disabled
+	bool enabled;
+
+	bool moved;
+};
+
+// maximum time to wait for the end of recorded data after disabling context, in ms
+static const int s_endOfDataTimeout = 1000;
+
+static void motionCallback(XPointer closure, XRecordInterceptData* data)
+{
+	MotionListener* listener = (MotionListener*)closure;
+
+	// only motions are recorded
+	if (data->category == XRecordFromServer)
+	{
+		listener->moved = true;
+	}
+	else if (data->category == XRecordEndOfData)
+	{
+		listener->enabled = false;
+	}
+
+	XRecordFreeData(data);
+}
+
+static void closeMotionListener(MotionListener* listener)
+{
+	if (listener->context) XRecordFreeContext(listener->controlDisplay, listener->context);
+	if (listener->dataDisplay) XCloseDisplay(listener->dataDisplay);
+	if (listener->controlDisplay) XCloseDisplay(listener->controlDisplay);
+
+	delete listener;
+}
+
+static MotionListener* createMotionListener()
+{
+	MotionListener* listener = new MotionListener();
+
+	listener->controlDisplay = XOpenDisplay(nullptr);
+	listener->dataDisplay = XOpenDisplay(nullptr);
+
+	int major = 0, minor = 0;
+
+	if (!listener->controlDisplay || !listener->dataDisplay || !XRecordQueryVersion(listener->controlDisplay, &major, &minor))
+	{
+		closeMotionListener(listener);
+		return nullptr;
+	}
+
+	XRecordRange* range = XRecordAllocRange();
+	range->device_events.first = MotionNotify;
+	range->device_events.last = MotionNotify;
+
+	XRecordClientSpec clients = XRecordAllClients;
+
+	listener->context = XRecordCreateContext(listener->controlDisplay, 0, &clients, 1, &range, 1);
+
+	XFree(range);
+
+	if (!listener->context)
+	{
+		closeMotionListener(listener);
+		return nullptr;
+	}
+
+	// context must be known by server before enabling it on the other display
+	XSync(listener->controlDisplay, False);
+
+	return listener;
+}
+
+// only used by clicker thread, null if RECORD extension is not available
+static MotionListener* getMotionListener()
+{
+	static MotionListener* s_listener = createMotionListener();
+
+	return s_listener;
+}
+
+void startCursorMonitoring()
+{
+	MotionListener* listener = getMotionListener();
+
+	if (!listener || listener->enabled) return;
+
+	listener->moved = false;
+
+	// data are processed by XRecordProcessReplies, so the display is not blocked
+	listener->enabled = XRecordEnableContextAsync(listener->dataDisplay, listener->context, motionCallback, (XPointer)listener);
+}
+
+void stopCursorMonitoring()
+{
+	MotionListener* listener = getMotionListener();
+
+	if (!listener || !listener->enabled) return;
+
+	// server stops sending motions and confirms it on data display
+	XRecordDisableContext(listener->controlDisplay, listener->context);
+	XSync(listener->controlDisplay, False);
+
+	pollfd fd;
+	fd.fd = ConnectionNumber(listener->dataDisplay);
+	fd.events = POLLIN;
+
+	// motions recorded before are discarded, so context can be enabled again
+	for(;;)
+	{
+		XRecordProcessReplies(listener->dataDisplay);
+
+		if (!listener->enabled) return;
+
+		fd.revents = 0;
+
+		if (poll(&fd, 1, s_endOfDataTimeout) <= 0) return;
+	}
+}
+
+bool waitForCursorMove(const QPoint& pos, int timeout)
+{
+	MotionListener* listener = getMotionListener();
+
+	if (!listener || !listener->enabled)
+	{
+		QThread::msleep(timeout);
+
+		return QCursor::pos() != pos;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// motions received before were caused by previous actions
+	XRecordProcessReplies(listener->dataDisplay);
+	listener->moved = false;
+
+	pollfd fd;
+	fd.fd = ConnectionNumber(listener->dataDisplay);
+	fd.events = POLLIN;
+
+	for(;;)
+	{
+		int remaining = timeout - (int)timer.elapsed();
+
+		if (remaining <= 0) return false;
+
+		// woken up by recorded motions or timeout
+		fd.revents = 0;
+
+		if (poll(&fd, 1, remaining) > 0) XRecordProcessReplies(listener->dataDisplay);
+
+		if (listener->moved)
+		{
+			listener->moved = false;
+
+			// moves sent by kClicker are also recorded
+			if (QCursor::pos() != pos) return true;
+		}
+	}
+}
+
+void preciseSleep(qint64 duration)
+{
+	timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+	deadline.tv_sec += duration / 1000000;
+	deadline.tv_nsec += (duration % 1000000) * 1000;
+
+	if (deadline.tv_nsec >= 1000000000)
+	{
+		++deadline.tv_sec;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	// absolute deadline, so an interruption doesn't make it longer
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+	{
+	}
+}
+
+ProcessUsage getProcessUsage()
+{
+	ProcessUsage usage;
+
+	struct rusage resources;
+
+	if (getrusage(RUSAGE_SELF, &resources) == 0)
+	{
+		usage.cpuTime = (resources.ru_utime.tv_sec + resources.ru_stime.tv_sec) * 1000000LL + resources.ru_utime.tv_usec + resources.ru_stime.tv_usec;
+		usage.wakeups = resources.ru_nvcsw;
+	}
+
+	return usage;
+}
+
+static void print_client_properties(Display *dpy, Window w, QAbstractItemModel *model)
+{
+	// retrieve window name
+	char *name = NULL;
+//	Status status = XFetchName(dpy, w, &name);
+
+	if (name && *name != '\0' && model->insertRow(0))
+	{
+		QPixmap pixmap;
+
+		QModelIndex index = model->index(0, 0);
+
+		model->setData(index, QString(name));
+		model->setData(index, pixmap, Qt::DecorationRole);
+		model->setData(index, qVariantFromValue((WId)w), Qt::UserRole);
+	}
+
+	XFree(name);
+}
+
+static void lookat(Display *dpy, Window root, QAbstractItemModel *model)
+{
+	Window dummy, *children = NULL, client;
+	unsigned int nchildren = 0;
+
+	// clients are not allowed to stomp on the root and ICCCM doesn't yet
+	// say anything about window managers putting stuff there; but, try
+	// anyway.
+	print_client_properties (dpy, root, model);
+
+	// then, get the list of windows
+	if (!XQueryTree (dpy, root, &dummy, &dummy, &children, &nchildren)) return;
+
+	for (unsigned int i = 0; i < nchildren; ++i)
+	{
+		client = XmuClientWindow (dpy, children[i]);
+		if (client != None)
+			print_client_properties (dpy, client, model);
+	}
+
+	QFileIconProvider icon;
+
+	if (model->insertRow(0))
+	{
+		QModelIndex index = model->index(0, 0);
+
+		model->setData(index, QObject::tr("Whole screen"));
+		model->setData(index, icon.icon(QFileIconProvider::Desktop).pixmap(32, 32), Qt::DecorationRole);
+		model->setData(index, qVariantFromValue((WId)root), Qt::UserRole);
+	}
+}
+
+void CreateWindowsList(QAbstractItemModel *model)
+{
+	char *displayname = NULL;
+	bool all_screens = false;
+
+	Display *dpy = XOpenDisplay (displayname);
+
+	if (!dpy) return;
+
+	if (all_screens)
+	{
+		for (int i = 0; i < ScreenCount(dpy); ++i)
+			lookat (dpy, RootWindow(dpy,i), model);
+	}
+	else
+	{
+		lookat (dpy, DefaultRootWindow(dpy), model);
+	}
+
+	XCloseDisplay (dpy);
+
+	model->sort(0);
+}
+
+bool RestoreMinimizedWindow(WId &id)
+{
+	return false;
+}
+
+void MinimizeWindow(WId id)
+{
+}
+
+bool IsUsingComposition()
+{
+	return true;
+}
+
+void PutForegroundWindow(WId id)
+{
+}
+
+bool IsOS64bits()
+{
+	return true;
+}
+
+bool InitSystemProgress()
+{
+	return false;
+}
+
+bool UninitSystemProgress()
+{
+	return false;
+}
+
+bool BeginSystemProgress()
+{
+	return false;
+}
+
+bool UpdateSystemProgress(qint64 value, qint64 total)
+{
+	return false;
+}
+
+bool EndSystemProgress()
+{
+	return false;
+}
+
+#endif
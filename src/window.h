@@ -1,41 +1,41 @@
-/*
- *  kClicker is a tool to click automatically
- *  Copyright (C) 2017-2022  Cedric OCHS
- *
- *  This program is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
- *
- */
-
-#ifndef WINDOW_H
-#define WINDOW_H
-
-#include <QtCore/QtCore>
-
-class Window
-{
-public:
-    WId id;
-    QString title;
-    QString path;
-    QPixmap icon;
-    QRect rect;
-
-    Window():id(0)
-    {
-    }
-};
-
-Q_DECLARE_METATYPE(Window);
-
-#endif
+/*
+ *  kClicker is a tool to click automatically
+ *  Copyright (C) 2017-2022  Cedric OCHS
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include <QtCore/QtCore>
+
+class Window
+{
+public:
+    WId id;
+    QString title;
+    QString path;
+    QPixmap icon;
+    QRect rect;
+
+    Window():id(0)
+    {
+    }
+};
+
+Q_DECLARE_METATYPE(Window);
+
+#endif